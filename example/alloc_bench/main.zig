@@ -0,0 +1,84 @@
+// Compares the throughput of std.heap.heap_allocator with libc malloc on a
+// mix of small allocations, reallocs and the occasional large buffer.
+
+const std = @import("std");
+const mem = std.mem;
+const heap = std.heap;
+const c = @cImport({
+    @cInclude("stdio.h");
+    @cInclude("stdlib.h");
+    @cInclude("time.h");
+});
+
+const slot_count = 1024;
+const iteration_count = 10 * 1000 * 1000;
+
+export fn main(argc: c_int, argv: &&u8) -> c_int {
+    const heap_ns = runBench(&heap.heap_allocator) %% return 1;
+    const libc_ns = runBench(&c_allocator) %% return 1;
+    _ = c.printf(c"std.heap: %llu ms\n", c_ulonglong(heap_ns / 1000000));
+    _ = c.printf(c"malloc:   %llu ms\n", c_ulonglong(libc_ns / 1000000));
+    return 0;
+}
+
+fn runBench(allocator: &mem.Allocator) -> %u64 {
+    var slots: [slot_count][]u8 = undefined;
+    for (slots) |*slot| {
+        *slot = []u8{};
+    }
+
+    var seed: u32 = 0x12345678;
+    const start = nanoTime();
+    var i: usize = 0;
+    while (i < iteration_count; i += 1) {
+        seed = seed *% 1103515245 +% 12345;
+        const r = seed >> 8;
+        const slot = &slots[r % slot_count];
+        const size = if (r & 0xff == 0) 4096 + r % (60 * 1024) else 8 + r % 504;
+        if (r & 0x100 == 0) {
+            *slot = %return allocator.realloc(u8, *slot, size);
+        } else {
+            allocator.free(*slot);
+            *slot = %return allocator.alloc(u8, size);
+        }
+        (*slot)[0] = u8(r);
+        (*slot)[size - 1] = u8(r);
+    }
+    for (slots) |slot| {
+        allocator.free(slot);
+    }
+    return nanoTime() - start;
+}
+
+fn nanoTime() -> u64 {
+    var ts: c.struct_timespec = undefined;
+    _ = c.clock_gettime(c.CLOCK_MONOTONIC, &ts);
+    return u64(ts.tv_sec) * 1000000000 + u64(ts.tv_nsec);
+}
+
+var c_allocator = mem.Allocator {
+    .allocFn = cAlloc,
+    .reallocFn = cRealloc,
+    .freeFn = cFree,
+    .context = null,
+};
+
+fn cAlloc(self: &mem.Allocator, n: usize) -> %[]u8 {
+    if (n == 0)
+        return []u8{};
+    const ptr = (&u8)(c.malloc(n) ?? return error.NoMem);
+    return ptr[0...n];
+}
+
+fn cRealloc(self: &mem.Allocator, old_mem: []u8, new_size: usize) -> %[]u8 {
+    if (old_mem.len == 0)
+        return cAlloc(self, new_size);
+    const ptr = (&u8)(c.realloc(old_mem.ptr, new_size) ?? return error.NoMem);
+    return ptr[0...new_size];
+}
+
+fn cFree(self: &mem.Allocator, old_mem: []u8) {
+    if (old_mem.len == 0)
+        return;
+    c.free(old_mem.ptr);
+}
@@ -0,0 +1,199 @@
+// A loopback TCP echo server and its clients on one std.event.Loop. Measures
+// how many connections per second are set up and torn down, and how many
+// request/response round trips per second concurrent clients complete.
+// Linux only, no dependency on libc.
+
+const std = @import("std");
+const io = std.io;
+const mem = std.mem;
+const net = std.net;
+const heap = std.heap;
+const linux = std.linux;
+const event = std.event;
+
+const connection_count = 20000;
+const client_count = 64;
+const requests_per_client = 5000;
+const message_size = 64;
+const accept_batch = 64;
+
+var loop: event.Loop = undefined;
+
+const Server = struct {
+    listener: net.Listener,
+    watcher: event.Watcher,
+    accepted: usize,
+};
+
+const ServerConn = struct {
+    conn: net.Connection,
+    watcher: event.Watcher,
+    buf: [4096]u8,
+};
+
+const Client = struct {
+    conn: net.Connection,
+    watcher: event.Watcher,
+    buf: [message_size]u8,
+    started: bool,
+    received: usize,
+    requests_left: usize,
+};
+
+var server: Server = undefined;
+var clients: [client_count]Client = undefined;
+var clients_done: usize = 0;
+
+pub fn main(args: [][]u8) -> %void {
+    %return loop.init();
+    defer loop.deinit();
+
+    const localhost = net.ip4Address([]u8 { 127, 0, 0, 1 });
+    server.listener = %return net.listenAddr(&localhost, 0, 1024);
+    server.accepted = 0;
+    server.watcher = event.Watcher {
+        .fd = server.listener.socket_fd,
+        .handler = onAcceptReady,
+        .context = null,
+    };
+    %return loop.add(&server.watcher, linux.EPOLLIN);
+    const port = %return server.listener.getPort();
+
+    // Connections: connect and close right away, in groups that fit the backlog.
+    var start = nanoTime();
+    {var i: usize = 0; while (i < connection_count; i += 1) {
+        var addr = localhost;
+        const conn = %return net.connectAddr(&addr, port);
+        %return conn.close();
+        if (i % 256 == 255) {
+            // accept and reap what is waiting before the backlog fills up
+            while (true) {
+                const handled = %return loop.poll(0);
+                if (handled == 0) break;
+            }
+        }
+    }}
+    while (server.accepted < connection_count) {
+        _ = %return loop.poll(-1);
+    }
+    var ns = nanoTime() - start;
+    %return io.stdout.printf("connections/sec: {}\n", u64(connection_count) * 1000000000 / ns);
+
+    // Requests: every client keeps one message in flight and waits for the echo.
+    for (clients) |*client| {
+        var addr = localhost;
+        client.conn = %return net.connectAddrNonBlock(&addr, port);
+        client.watcher = event.Watcher {
+            .fd = client.conn.socket_fd,
+            .handler = onClientReady,
+            .context = (&mem.Context)(client),
+        };
+        client.started = false;
+        client.received = 0;
+        client.requests_left = requests_per_client;
+        mem.set(u8, client.buf[0...], 'x');
+        %return loop.add(&client.watcher, linux.EPOLLIN | linux.EPOLLOUT);
+    }
+    start = nanoTime();
+    %return loop.run();
+    ns = nanoTime() - start;
+    %return io.stdout.printf("requests/sec: {}   ({} clients, {} byte messages)\n",
+        u64(client_count) * requests_per_client * 1000000000 / ns, usize(client_count), usize(message_size));
+
+    for (clients) |*client| {
+        %return client.conn.close();
+    }
+    %return server.listener.close();
+}
+
+fn onAcceptReady(watcher: &event.Watcher, events: u32) {
+    var batch: [accept_batch]net.Connection = undefined;
+    while (true) {
+        const conns = server.listener.acceptBatch(batch[0...]) %% |err| {
+            fail("accept", err);
+        };
+        for (conns) |conn| {
+            server.accepted += 1;
+            const slot = heap.heap_allocator.alloc(ServerConn, 1) %% |err| {
+                fail("alloc", err);
+            };
+            const sc = &slot[0];
+            sc.conn = conn;
+            sc.watcher = event.Watcher {
+                .fd = conn.socket_fd,
+                .handler = onServerConnReady,
+                .context = (&mem.Context)(sc),
+            };
+            loop.add(&sc.watcher, linux.EPOLLIN | linux.EPOLLRDHUP) %% |err| {
+                fail("watch", err);
+            };
+            // data or a hang up may already be waiting, which gives no edge
+            onServerConnReady(&sc.watcher, linux.EPOLLIN);
+        }
+        if (conns.len < batch.len) return;
+    }
+}
+
+fn onServerConnReady(watcher: &event.Watcher, events: u32) {
+    const sc = (&ServerConn)(watcher.context ?? @unreachable());
+    while (true) {
+        const data = sc.conn.recv(sc.buf[0...]) %% |err| {
+            if (err == error.WouldBlock) return;
+            return closeServerConn(sc);
+        };
+        if (data.len == 0) return closeServerConn(sc);
+        // replies are small, so the socket buffer always has room for them
+        _ = sc.conn.send(data) %% return closeServerConn(sc);
+    }
+}
+
+fn closeServerConn(sc: &ServerConn) {
+    loop.remove(&sc.watcher) %% {};
+    sc.conn.close() %% {};
+    heap.heap_allocator.free(sc[0...1]);
+}
+
+fn onClientReady(watcher: &event.Watcher, events: u32) {
+    const client = (&Client)(watcher.context ?? @unreachable());
+    if (!client.started) {
+        if (events & linux.EPOLLOUT == 0) return;
+        client.started = true;
+        sendRequest(client);
+    }
+    while (true) {
+        const data = client.conn.recv(client.buf[client.received...]) %% |err| {
+            if (err == error.WouldBlock) return;
+            fail("client recv", err);
+        };
+        if (data.len == 0) fail("client recv", error.ConnectionReset);
+        client.received += data.len;
+        if (client.received < message_size) continue;
+
+        client.received = 0;
+        client.requests_left -= 1;
+        if (client.requests_left == 0) {
+            clients_done += 1;
+            if (clients_done == client_count) loop.stop();
+            return;
+        }
+        sendRequest(client);
+    }
+}
+
+fn sendRequest(client: &Client) {
+    const amt = client.conn.send(client.buf[0...]) %% |err| {
+        fail("client send", err);
+    };
+    if (amt != message_size) fail("client send", error.Io);
+}
+
+fn fail(what: []const u8, err: error) -> unreachable {
+    %%io.stderr.printf("{} failed: {}\n", what, @errorName(err));
+    std.os.abort();
+}
+
+fn nanoTime() -> u64 {
+    var ts: linux.timespec = undefined;
+    _ = linux.clock_gettime(linux.CLOCK_MONOTONIC, &ts);
+    return u64(ts.tv_sec) * 1000000000 + u64(ts.tv_nsec);
+}
@@ -0,0 +1,162 @@
+// Measures float printing and parsing in ns/value: io.bufPrintFloat, which
+// prints the shortest decimal which parses back to the same float, and
+// io.parseFloat, next to a simple parser which multiplies by powers of ten
+// in floating point, and counts how often that one rounds wrong.
+// With the argument "exhaustive" it instead prints and parses back every
+// f32 and reports those which do not come back the same. Linux only, no
+// dependency on libc.
+
+const std = @import("std");
+const io = std.io;
+const mem = std.mem;
+const linux = std.linux;
+
+const value_count = 1000000;
+
+var values: [value_count]f64 = undefined;
+var values32: [value_count]f32 = undefined;
+// every printed value, back to back, with its end offset in ends
+var text: [value_count * 32]u8 = undefined;
+var ends: [value_count]usize = undefined;
+
+error Mismatch;
+
+pub fn main(args: [][]u8) -> %void {
+    if (args.len > 1 && mem.eql(u8, args[1], "exhaustive")) {
+        return checkAllF32();
+    }
+
+    var state: u64 = 0x853c49e6748fea9b;
+    for (values) |*value, i| {
+        state = state *% 6364136223846793005 +% 1442695040888963407;
+        var bits = state >> 1;
+        if (bits >> 52 == 0x7ff) bits >>= 1;
+        *value = *(&const f64)(&bits);
+        var bits32 = u32(state >> 33);
+        if (bits32 >> 23 == 0xff) bits32 >>= 1;
+        values32[i] = *(&const f32)(&bits32);
+    }
+    %return io.stdout.printf("                    print ns   parse ns   simple parse ns   simple wrong\n");
+    %return bench("f64 random bits", f64, values[0...]);
+    %return bench("f32 random bits", f32, values32[0...]);
+
+    // what a metrics exporter writes: a few digits on either side of the point
+    for (values) |*value| {
+        state = state *% 6364136223846793005 +% 1442695040888963407;
+        *value = f64(state >> 40) / 1000.0;
+    }
+    %return bench("f64 3 decimals", f64, values[0...]);
+}
+
+fn bench(name: []const u8, comptime T: type, items: []const T) -> %void {
+    var start = nanoTime();
+    var end: usize = 0;
+    for (items) |value, i| {
+        end += io.bufPrintFloat(text[end...], value);
+        ends[i] = end;
+    }
+    const print_ns = nanoTime() - start;
+
+    start = nanoTime();
+    var begin: usize = 0;
+    for (items) |value, i| {
+        const parsed = %return io.parseFloat(T, text[begin...ends[i]]);
+        if (parsed != value) return error.Mismatch;
+        begin = ends[i];
+    }
+    const parse_ns = nanoTime() - start;
+
+    start = nanoTime();
+    begin = 0;
+    var wrong: usize = 0;
+    for (items) |value, i| {
+        if (T(simpleParse(text[begin...ends[i]])) != value) wrong += 1;
+        begin = ends[i];
+    }
+    const simple_ns = nanoTime() - start;
+
+    %return io.stdout.printf("{}:   {}.{}   {}.{}   {}.{}   {}\n", name,
+        tenths(print_ns, items.len) / 10, tenths(print_ns, items.len) % 10,
+        tenths(parse_ns, items.len) / 10, tenths(parse_ns, items.len) % 10,
+        tenths(simple_ns, items.len) / 10, tenths(simple_ns, items.len) % 10,
+        wrong);
+}
+
+// Accumulates the digits in a u64 and scales by 10 one multiply or divide at
+// a time, each of which can round.
+fn simpleParse(buf: []const u8) -> f64 {
+    var i: usize = 0;
+    const negative = buf[0] == '-';
+    if (negative) i = 1;
+    var mantissa: u64 = 0;
+    var exp10: i32 = 0;
+    var saw_point = false;
+    while (i < buf.len; i += 1) {
+        const c = buf[i];
+        if (c == '.') {
+            saw_point = true;
+        } else if (c >= '0' && c <= '9') {
+            if (mantissa < 1000000000000000000) {
+                mantissa = mantissa * 10 + (c - '0');
+                if (saw_point) exp10 -= 1;
+            } else if (!saw_point) {
+                exp10 += 1;
+            }
+        } else {
+            break;
+        }
+    }
+    if (i < buf.len) {
+        i += 1;
+        const exp_negative = buf[i] == '-';
+        if (exp_negative) i += 1;
+        var e: i32 = 0;
+        for (buf[i...]) |c| {
+            e = e * 10 + i32(c - '0');
+        }
+        exp10 += if (exp_negative) -e else e;
+    }
+    var x = f64(mantissa);
+    while (exp10 > 0; exp10 -= 1) {
+        x *= 10.0;
+    }
+    while (exp10 < 0; exp10 += 1) {
+        x /= 10.0;
+    }
+    return if (negative) -x else x;
+}
+
+fn checkAllF32() -> %void {
+    var buf: [32]u8 = undefined;
+    var failures: u64 = 0;
+    const start = nanoTime();
+    var bits: u32 = 0;
+    while (true) {
+        if ((bits >> 23) & 0xff != 0xff) {
+            const x = *(&const f32)(&bits);
+            const len = io.bufPrintFloat(buf[0...], x);
+            const y = %return io.parseFloat(f32, buf[0...len]);
+            if (*(&const u32)(&y) != bits) {
+                failures += 1;
+                if (failures <= 10) {
+                    %return io.stdout.printf("bits {} printed as {}\n", bits, buf[0...len]);
+                }
+            }
+        }
+        if (bits == @maxValue(u32)) break;
+        bits += 1;
+    }
+    const ns = nanoTime() - start;
+    %return io.stdout.printf("every f32: {} did not round trip, {} ns/value\n",
+        failures, ns >> 32);
+}
+
+fn tenths(ns: u64, count: usize) -> u64 {
+    return ns * 10 / count;
+}
+
+fn nanoTime() -> u64 {
+    var ts: linux.timespec = undefined;
+    _ = linux.clock_gettime(linux.CLOCK_MONOTONIC, &ts);
+    return u64(ts.tv_sec) * 1000000000 + u64(ts.tv_nsec);
+}
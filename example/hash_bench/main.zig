@@ -0,0 +1,107 @@
+// Measures the throughput of std.hash.hash64 and how evenly the std.hash
+// functions spread typical keys over the buckets of a hash table.
+
+const std = @import("std");
+const hash = std.hash;
+const mem = std.mem;
+const heap = std.heap;
+const c = @cImport({
+    @cInclude("stdio.h");
+    @cInclude("time.h");
+});
+
+/// Every throughput measurement hashes about this many bytes in total.
+const bytes_per_run = 256 * 1024 * 1024;
+const lengths = []usize { 4, 8, 16, 32, 64, 1024, 64 * 1024 };
+
+const bucket_bits = 16;
+const bucket_count = 1 << bucket_bits;
+
+export fn main(argc: c_int, argv: &&u8) -> c_int {
+    const input = heap.heap_allocator.alloc(u8, 64 * 1024) %% return 1;
+    for (input) |*b, i| {
+        *b = @truncate(u8, i *% 31);
+    }
+
+    _ = c.printf(c"%8s %10s\n", c"bytes", c"MB/s");
+    for (lengths) |len| {
+        const iterations = bytes_per_run / len;
+        var sum: u64 = 0;
+        const start = nanoTime();
+        {var i: usize = 0; while (i < iterations; i += 1) {
+            sum +%= hash.hash64(i, input[0...len]);
+        }}
+        const ns = nanoTime() - start;
+        _ = c.printf(c"%8zu %10llu   (%llx)\n", len, c_ulonglong(u64(bytes_per_run) * 1000 / ns),
+            c_ulonglong(sum));
+    }
+
+    const buckets = heap.heap_allocator.alloc(u32, bucket_count) %% return 1;
+    _ = c.printf(c"\n%-24s %8s %8s   (for %d keys in as many buckets; random is about 36.8%% empty)\n",
+        c"keys", c"empty %", c"max", c_int(bucket_count));
+
+    // Sequential integers.
+    mem.set(u32, buckets, 0);
+    {var i: u64 = 0; while (i < bucket_count; i += 1) {
+        buckets[hash.hashRaw(u64)(i) % bucket_count] += 1;
+    }}
+    report(c"sequential integers", buckets);
+
+    // Integers with only high bits set.
+    mem.set(u32, buckets, 0);
+    {var i: u64 = 0; while (i < bucket_count; i += 1) {
+        buckets[hash.hashRaw(u64)(i << 40) % bucket_count] += 1;
+    }}
+    report(c"integers << 40", buckets);
+
+    // Short decimal strings, and the same behind a long common prefix.
+    var key_buf: [64]u8 = undefined;
+    const prefix = "/var/log/service/requests/";
+    mem.copy(u8, key_buf[0...], prefix);
+    mem.set(u32, buckets, 0);
+    {var i: usize = 0; while (i < bucket_count; i += 1) {
+        const digits = formatDecimal(key_buf[prefix.len...], i);
+        buckets[hash.hashSlice(u8)(digits) % bucket_count] += 1;
+    }}
+    report(c"decimal strings", buckets);
+
+    mem.set(u32, buckets, 0);
+    {var i: usize = 0; while (i < bucket_count; i += 1) {
+        const digits = formatDecimal(key_buf[prefix.len...], i);
+        const key = key_buf[0...prefix.len + digits.len];
+        buckets[hash.hashSlice(u8)(key) % bucket_count] += 1;
+    }}
+    report(c"prefixed decimal strings", buckets);
+
+    return 0;
+}
+
+fn report(name: &const u8, buckets: []u32) {
+    var empty: usize = 0;
+    var max: u32 = 0;
+    for (buckets) |count| {
+        if (count == 0) empty += 1;
+        if (count > max) max = count;
+    }
+    _ = c.printf(c"%-24s %8.1f %8u\n", name, f64(empty) * 100.0 / f64(buckets.len), max);
+}
+
+fn formatDecimal(buf: []u8, value: usize) -> []u8 {
+    var digits: [20]u8 = undefined;
+    var n = value;
+    var len: usize = 0;
+    while (true) {
+        digits[digits.len - 1 - len] = u8('0' + n % 10);
+        len += 1;
+        n /= 10;
+        if (n == 0) break;
+    }
+    mem.copy(u8, buf, digits[digits.len - len...]);
+    return buf[0...len];
+}
+
+fn nanoTime() -> u64 {
+    var ts: c.struct_timespec = undefined;
+    _ = c.clock_gettime(c.CLOCK_MONOTONIC, &ts);
+    return u64(ts.tv_sec) * 1000000000 + u64(ts.tv_nsec);
+}
@@ -0,0 +1,96 @@
+// Compares std.hash_map.HashMap with the Robin Hood map it replaced on
+// inserts, lookups of present and missing keys, and iteration.
+
+const std = @import("std");
+const hash = std.hash;
+const heap = std.heap;
+const HashMap = std.hash_map.HashMap;
+const RobinHoodMap = @import("robin_hood_map.zig").HashMap;
+const c = @cImport({
+    @cInclude("stdio.h");
+    @cInclude("time.h");
+});
+
+const sizes = []u64 { 1000, 100000, 1000000 };
+
+const NewMap = HashMap(u64, u64, hash.hashRaw(u64), hash.eqlRaw(u64));
+const OldMap = RobinHoodMap(u64, u64, hash.hashRaw(u64), hash.eqlRaw(u64));
+
+export fn main(argc: c_int, argv: &&u8) -> c_int {
+    _ = c.printf(c"%-12s %8s %10s %10s %10s %10s %10s   (ns per key)\n",
+        c"map", c"keys", c"insert", c"presized", c"hit", c"miss", c"iterate");
+    for (sizes) |size| {
+        bench(OldMap, c"robin hood", size, false) %% return 1;
+        bench(NewMap, c"std", size, true) %% return 1;
+    }
+    return 0;
+}
+
+fn bench(comptime Map: type, name: &const u8, size: u64, can_presize: bool) -> %void {
+    var map: Map = undefined;
+    map.init(&heap.heap_allocator);
+    defer map.deinit();
+
+    // Keys are spread out so that they don't hash to neighbouring slots by luck.
+    var start = nanoTime();
+    {var i: u64 = 0; while (i < size; i += 1) {
+        %return map.put(key(i), i);
+    }}
+    const insert_ns = nanoTime() - start;
+
+    var presized_ns: u64 = 0;
+    if (can_presize) {
+        var presized: Map = undefined;
+        presized.init(&heap.heap_allocator);
+        defer presized.deinit();
+        start = nanoTime();
+        %return presized.ensureCapacity(size);
+        {var i: u64 = 0; while (i < size; i += 1) {
+            %return presized.put(key(i), i);
+        }}
+        presized_ns = nanoTime() - start;
+    }
+
+    var sum: u64 = 0;
+    start = nanoTime();
+    {var i: u64 = 0; while (i < size; i += 1) {
+        if (const entry ?= map.get(key(i))) {
+            sum +%= entry.value;
+        }
+    }}
+    const hit_ns = nanoTime() - start;
+
+    start = nanoTime();
+    {var i: u64 = size; while (i < size * 2; i += 1) {
+        if (const entry ?= map.get(key(i))) {
+            sum +%= entry.value;
+        }
+    }}
+    const miss_ns = nanoTime() - start;
+
+    start = nanoTime();
+    var it = map.entryIterator();
+    while (true) {
+        const entry = it.next() ?? break;
+        sum +%= entry.key;
+    }
+    const iterate_ns = nanoTime() - start;
+
+    _ = c.printf(c"%-12s %8llu %10.1f %10.1f %10.1f %10.1f %10.1f   (%llx)\n", name, c_ulonglong(size),
+        perKey(insert_ns, size), perKey(presized_ns, size), perKey(hit_ns, size),
+        perKey(miss_ns, size), perKey(iterate_ns, size), c_ulonglong(sum));
+}
+
+fn key(i: u64) -> u64 {
+    return i *% 0x9e3779b97f4a7c15;
+}
+
+fn perKey(ns: u64, size: u64) -> f64 {
+    return f64(ns) / f64(size);
+}
+
+fn nanoTime() -> u64 {
+    var ts: c.struct_timespec = undefined;
+    _ = c.clock_gettime(c.CLOCK_MONOTONIC, &ts);
+    return u64(ts.tv_sec) * 1000000000 + u64(ts.tv_nsec);
+}
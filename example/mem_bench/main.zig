@@ -0,0 +1,71 @@
+// Measures the throughput of std.mem.copy, set, eql and cmp on byte slices
+// from 1 byte to 1 MiB.
+
+const std = @import("std");
+const mem = std.mem;
+const heap = std.heap;
+const c = @cImport({
+    @cInclude("stdio.h");
+    @cInclude("time.h");
+});
+
+const max_len = 1024 * 1024;
+/// Every measurement processes about this many bytes in total.
+const bytes_per_run = 256 * 1024 * 1024;
+
+const lengths = []usize { 1, 7, 16, 64, 256, 4 * 1024, 64 * 1024, max_len };
+
+export fn main(argc: c_int, argv: &&u8) -> c_int {
+    const a = heap.heap_allocator.alloc(u8, max_len) %% return 1;
+    const b = heap.heap_allocator.alloc(u8, max_len) %% return 1;
+    mem.set(u8, a, 'x');
+    mem.set(u8, b, 'x');
+
+    _ = c.printf(c"%8s %10s %10s %10s %10s   (MB/s)\n", c"bytes", c"copy", c"set", c"eql", c"cmp");
+    for (lengths) |len| {
+        const iterations = bytes_per_run / len;
+        const x = a[0...len];
+        const y = b[0...len];
+        var result: usize = 0;
+
+        var start = nanoTime();
+        {var i: usize = 0; while (i < iterations; i += 1) {
+            mem.copy(u8, x, y);
+        }}
+        const copy_ns = nanoTime() - start;
+
+        start = nanoTime();
+        {var i: usize = 0; while (i < iterations; i += 1) {
+            mem.set(u8, x, 'x');
+        }}
+        const set_ns = nanoTime() - start;
+
+        start = nanoTime();
+        {var i: usize = 0; while (i < iterations; i += 1) {
+            if (mem.eql(u8, x, y)) result += 1;
+        }}
+        const eql_ns = nanoTime() - start;
+
+        start = nanoTime();
+        {var i: usize = 0; while (i < iterations; i += 1) {
+            if (mem.cmp(u8, x, y) == mem.Cmp.Equal) result += 1;
+        }}
+        const cmp_ns = nanoTime() - start;
+
+        _ = c.printf(c"%8zu %10llu %10llu %10llu %10llu\n", len, mbPerSec(copy_ns),
+            mbPerSec(set_ns), mbPerSec(eql_ns), mbPerSec(cmp_ns));
+        if (result != 2 * iterations) return 1;
+    }
+    return 0;
+}
+
+fn mbPerSec(ns: u64) -> c_ulonglong {
+    if (ns == 0) return 0;
+    return c_ulonglong(u64(bytes_per_run) * 1000 / ns);
+}
+
+fn nanoTime() -> u64 {
+    var ts: c.struct_timespec = undefined;
+    _ = c.clock_gettime(c.CLOCK_MONOTONIC, &ts);
+    return u64(ts.tv_sec) * 1000000000 + u64(ts.tv_nsec);
+}
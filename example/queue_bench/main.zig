@@ -0,0 +1,163 @@
+// Measures the std lock free queues across threads: the throughput of
+// SpscQueue and MpmcQueue, one item and a batch at a time, and the latency
+// of handing an item to another thread, from the round trip time of a ping
+// pong over two SpscQueues. Linux only, no dependency on libc.
+
+const std = @import("std");
+const io = std.io;
+const heap = std.heap;
+const mem = std.mem;
+const linux = std.linux;
+const Thread = std.thread.Thread;
+const SpscQueue = std.queue.SpscQueue;
+const MpmcQueue = std.queue.MpmcQueue;
+
+const item_count = 20 * 1000 * 1000;
+const batch_size = 64;
+const queue_capacity = 1024;
+const mpmc_threads = 2;
+const round_trips = 1000 * 1000;
+
+error Corrupt;
+
+var spsc: SpscQueue(u64) = undefined;
+var spsc_back: SpscQueue(u64) = undefined;
+var mpmc: MpmcQueue(u64) = undefined;
+var batched = false;
+
+pub fn main(args: [][]u8) -> %void {
+    %return spsc.init(&heap.heap_allocator, queue_capacity);
+    defer spsc.deinit();
+    %return spsc_back.init(&heap.heap_allocator, queue_capacity);
+    defer spsc_back.deinit();
+    %return mpmc.init(&heap.heap_allocator, queue_capacity);
+    defer mpmc.deinit();
+
+    batched = false;
+    var ns = %return runSpsc();
+    %return io.stdout.printf("spsc, single:       {} M items/sec\n", u64(item_count) * 1000 / ns);
+    batched = true;
+    ns = %return runSpsc();
+    %return io.stdout.printf("spsc, batch of {}:  {} M items/sec\n", usize(batch_size), u64(item_count) * 1000 / ns);
+
+    batched = false;
+    ns = %return runMpmc();
+    %return io.stdout.printf("mpmc {}x{}, single:   {} M items/sec\n",
+        usize(mpmc_threads), usize(mpmc_threads), u64(item_count) * 1000 / ns);
+    batched = true;
+    ns = %return runMpmc();
+    %return io.stdout.printf("mpmc {}x{}, batch of {}: {} M items/sec\n",
+        usize(mpmc_threads), usize(mpmc_threads), usize(batch_size), u64(item_count) * 1000 / ns);
+
+    // ping pong: every item is sent back before the next one goes out
+    const echo = %return Thread.spawn(echoItems, null);
+    const start = nanoTime();
+    {var i: u64 = 0; while (i < round_trips; i += 1) {
+        while (!spsc.push(i)) {}
+        while (true) {
+            const back = spsc_back.pop() ?? continue;
+            if (back != i) return error.Corrupt;
+            break;
+        }
+    }}
+    ns = nanoTime() - start;
+    echo.join();
+    %return io.stdout.printf("spsc handoff:       {} ns   (half a round trip)\n", ns / (round_trips * 2));
+}
+
+fn runSpsc() -> %u64 {
+    const consumer = %return Thread.spawn(consumeSpsc, null);
+    const start = nanoTime();
+    produce(pushSpsc, item_count);
+    consumer.join();
+    return nanoTime() - start;
+}
+
+fn runMpmc() -> %u64 {
+    var threads: [mpmc_threads * 2]&Thread = undefined;
+    const start = nanoTime();
+    for (threads) |*thread, i| {
+        const func = if (i < mpmc_threads) produceMpmc else consumeMpmc;
+        *thread = %return Thread.spawn(func, null);
+    }
+    for (threads) |thread| {
+        thread.join();
+    }
+    return nanoTime() - start;
+}
+
+fn produce(push: fn(items: []const u64) -> usize, count: usize) {
+    var items: [batch_size]u64 = undefined;
+    for (items) |*item, i| {
+        *item = i;
+    }
+    const step = if (batched) usize(batch_size) else 1;
+    var left = count;
+    while (left > 0) {
+        const n = if (left < step) left else step;
+        left -= push(items[0...n]);
+    }
+}
+
+fn consume(pop: fn(out: []u64) -> usize, count: usize) {
+    var out: [batch_size]u64 = undefined;
+    const step = if (batched) usize(batch_size) else 1;
+    var left = count;
+    while (left > 0) {
+        const n = if (left < step) left else step;
+        left -= pop(out[0...n]);
+    }
+}
+
+fn pushSpsc(items: []const u64) -> usize {
+    if (items.len == 1) return if (spsc.push(items[0])) usize(1) else 0;
+    return spsc.pushBatch(items);
+}
+
+fn popSpsc(out: []u64) -> usize {
+    if (out.len == 1) {
+        out[0] = spsc.pop() ?? return 0;
+        return 1;
+    }
+    return spsc.popBatch(out);
+}
+
+fn pushMpmc(items: []const u64) -> usize {
+    if (items.len == 1) return if (mpmc.push(items[0])) usize(1) else 0;
+    return mpmc.pushBatch(items);
+}
+
+fn popMpmc(out: []u64) -> usize {
+    if (out.len == 1) {
+        out[0] = mpmc.pop() ?? return 0;
+        return 1;
+    }
+    return mpmc.popBatch(out);
+}
+
+fn consumeSpsc(context: ?&mem.Context) {
+    consume(popSpsc, item_count);
+}
+
+fn produceMpmc(context: ?&mem.Context) {
+    produce(pushMpmc, item_count / mpmc_threads);
+}
+
+fn consumeMpmc(context: ?&mem.Context) {
+    consume(popMpmc, item_count / mpmc_threads);
+}
+
+fn echoItems(context: ?&mem.Context) {
+    var left: usize = round_trips;
+    while (left > 0) {
+        const item = spsc.pop() ?? continue;
+        while (!spsc_back.push(item)) {}
+        left -= 1;
+    }
+}
+
+fn nanoTime() -> u64 {
+    var ts: linux.timespec = undefined;
+    _ = linux.clock_gettime(linux.CLOCK_MONOTONIC, &ts);
+    return u64(ts.tv_sec) * 1000000000 + u64(ts.tv_nsec);
+}
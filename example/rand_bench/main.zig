@@ -0,0 +1,68 @@
+// Measures each std.rand engine through the Rand interface: raw 64 bit
+// values, bulk bytes, bounded integers and floats.
+
+const std = @import("std");
+const rand = std.rand;
+const c = @cImport({
+    @cInclude("stdio.h");
+    @cInclude("time.h");
+});
+
+const iterations = 50 * 1000 * 1000;
+
+var buf: [64 * 1024]u8 = undefined;
+
+export fn main(argc: c_int, argv: &&u8) -> c_int {
+    _ = c.printf(c"%-14s %10s %10s %10s %10s   (ns per value, MB/s for bytes)\n",
+        c"engine", c"u64", c"bytes", c"range", c"f64");
+    bench(rand.MT19937_64, c"mt19937_64");
+    bench(rand.Xoshiro256, c"xoshiro256**");
+    bench(rand.Pcg32, c"pcg32");
+    return 0;
+}
+
+fn bench(comptime Engine: type, name: &const u8) {
+    var r: rand.RandomGenerator(Engine) = undefined;
+    r.init(1234);
+    var sum: u64 = 0;
+
+    var start = nanoTime();
+    {var i: usize = 0; while (i < iterations; i += 1) {
+        sum +%= r.scalar(u64);
+    }}
+    const scalar_ns = nanoTime() - start;
+
+    const rounds = 4 * 1024;
+    start = nanoTime();
+    {var i: usize = 0; while (i < rounds; i += 1) {
+        r.fillBytes(buf[0...]);
+        sum +%= buf[i];
+    }}
+    const bytes_ns = nanoTime() - start;
+
+    start = nanoTime();
+    {var i: usize = 0; while (i < iterations; i += 1) {
+        sum +%= r.rangeUnsigned(u32, 0, 1000);
+    }}
+    const range_ns = nanoTime() - start;
+
+    var total: f64 = 0.0;
+    start = nanoTime();
+    {var i: usize = 0; while (i < iterations; i += 1) {
+        total += r.float(f64);
+    }}
+    const float_ns = nanoTime() - start;
+
+    _ = c.printf(c"%-14s %10.2f %10llu %10.2f %10.2f   (%llx %f)\n", name,
+        f64(scalar_ns) / f64(iterations),
+        c_ulonglong(u64(rounds) * buf.len * 1000 / bytes_ns),
+        f64(range_ns) / f64(iterations),
+        f64(float_ns) / f64(iterations),
+        c_ulonglong(sum), total);
+}
+
+fn nanoTime() -> u64 {
+    var ts: c.struct_timespec = undefined;
+    _ = c.clock_gettime(c.CLOCK_MONOTONIC, &ts);
+    return u64(ts.tv_sec) * 1000000000 + u64(ts.tv_nsec);
+}
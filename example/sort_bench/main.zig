@@ -0,0 +1,53 @@
+// Measures std.sort.sort and std.sort.sortStable on random, sorted, reversed
+// and few unique inputs.
+
+const std = @import("std");
+const sort = std.sort;
+const heap = std.heap;
+const c = @cImport({
+    @cInclude("stdio.h");
+    @cInclude("time.h");
+});
+
+const item_count = 1000 * 1000;
+var items: [item_count]i32 = undefined;
+
+const pattern_names = []&const u8 { c"random", c"sorted", c"reversed", c"few unique" };
+
+export fn main(argc: c_int, argv: &&u8) -> c_int {
+    var pattern: usize = 0;
+    while (pattern < pattern_names.len; pattern += 1) {
+        fillPattern(items[0...], pattern);
+        var start = nanoTime();
+        sort.sort(i32, items[0...], sort.i32asc);
+        const unstable_ns = nanoTime() - start;
+
+        fillPattern(items[0...], pattern);
+        start = nanoTime();
+        sort.sortStable(i32, items[0...], &heap.heap_allocator, sort.i32asc) %% return 1;
+        const stable_ns = nanoTime() - start;
+
+        _ = c.printf(c"%-12s sort: %6llu us  sortStable: %6llu us\n", pattern_names[pattern],
+            c_ulonglong(unstable_ns / 1000), c_ulonglong(stable_ns / 1000));
+    }
+    return 0;
+}
+
+fn fillPattern(array: []i32, pattern: usize) {
+    var seed: u32 = 0x12345678;
+    for (array) |*item, i| {
+        seed = seed *% 1103515245 +% 12345;
+        *item = switch (pattern) {
+            0 => i32(seed >> 1),
+            1 => i32(i),
+            2 => -i32(i),
+            else => i32((seed >> 16) % 4),
+        };
+    }
+}
+
+fn nanoTime() -> u64 {
+    var ts: c.struct_timespec = undefined;
+    _ = c.clock_gettime(c.CLOCK_MONOTONIC, &ts);
+    return u64(ts.tv_sec) * 1000000000 + u64(ts.tv_nsec);
+}
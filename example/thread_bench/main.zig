@@ -0,0 +1,66 @@
+// Measures how std.thread.ThreadPool scales from 1 thread up to one per CPU:
+// the time of a compute bound parallelFor over a large array, and how many
+// small parallelFor calls per second complete, which is the cost of handing
+// out and waiting for work. Linux only, no dependency on libc.
+
+const std = @import("std");
+const io = std.io;
+const heap = std.heap;
+const linux = std.linux;
+const thread = std.thread;
+
+const item_count = 1 << 22;
+const mix_rounds = 64;
+const small_item_count = 256;
+const small_call_count = 20000;
+
+var items: [item_count]u64 = undefined;
+
+pub fn main(args: [][]u8) -> %void {
+    const cpu_count = %return thread.cpuCount();
+    %return io.stdout.printf("threads   big ms   speedup   small calls/sec\n");
+
+    var single_ns: u64 = 0;
+    var thread_count: usize = 1;
+    while (thread_count <= cpu_count; thread_count += 1) {
+        var pool: thread.ThreadPool = undefined;
+        %return pool.init(&heap.heap_allocator, thread_count);
+        defer pool.deinit();
+
+        for (items) |*item, i| {
+            *item = u64(i);
+        }
+        var start = nanoTime();
+        pool.parallelFor(u64, items[0...], mix);
+        const big_ns = nanoTime() - start;
+        if (thread_count == 1) single_ns = big_ns;
+
+        start = nanoTime();
+        {var i: usize = 0; while (i < small_call_count; i += 1) {
+            pool.parallelFor(u64, items[0...small_item_count], mix);
+        }}
+        const small_ns = nanoTime() - start;
+
+        %return io.stdout.printf("{}   {}   {}.{}   {}   (check {})\n", thread_count,
+            big_ns / 1000000, single_ns / big_ns, single_ns * 10 / big_ns % 10,
+            u64(small_call_count) * 1000000000 / small_ns, items[item_count / 2]);
+    }
+}
+
+fn mix(part: []u64) {
+    for (part) |*item| {
+        var x = *item;
+        {var round: usize = 0; while (round < mix_rounds; round += 1) {
+            x ^= x >> 31;
+            x *%= 0x7fb5d329728ea185;
+            x ^= x >> 27;
+        }}
+        *item = x;
+    }
+}
+
+fn nanoTime() -> u64 {
+    var ts: linux.timespec = undefined;
+    _ = linux.clock_gettime(linux.CLOCK_MONOTONIC, &ts);
+    return u64(ts.tv_sec) * 1000000000 + u64(ts.tv_nsec);
+}
@@ -0,0 +1,150 @@
+// Compares std.io_uring with one blocking system call per operation:
+// random 4 KiB reads from a file, and bulk transfer over a loopback TCP
+// connection. Linux 5.6 or later, no dependency on libc.
+//
+// Usage: uring_bench [file]   (defaults to the benchmark executable)
+
+const std = @import("std");
+const io = std.io;
+const mem = std.mem;
+const net = std.net;
+const linux = std.linux;
+const IoUring = std.io_uring.IoUring;
+const Rand = std.rand.Rand;
+
+const block_size = 4096;
+const read_count = 200000;
+const queue_depth = 64;
+const transfer_bytes = 1024 * 1024 * 1024;
+const chunk_size = 16 * 1024;
+
+var blocks: [queue_depth][block_size]u8 = undefined;
+var send_buf: [chunk_size]u8 = undefined;
+var recv_bufs: [queue_depth][chunk_size]u8 = undefined;
+
+pub fn main(args: [][]u8) -> %void {
+    var file: io.InStream = undefined;
+    if (args.len > 1) {
+        %return file.open(args[1]);
+    } else {
+        %return io.openSelfExe(&file);
+    }
+    defer file.close() %% {};
+    const block_count = (%return file.getEndPos()) / block_size;
+    if (block_count == 0) {
+        %return io.stderr.printf("file is smaller than one block\n");
+        return;
+    }
+
+    var ring: IoUring = undefined;
+    %return ring.init(queue_depth * 2, 0);
+    defer ring.deinit();
+
+    var rand: Rand = undefined;
+    rand.init(1);
+
+    // Random reads, one pread at a time.
+    var start = nanoTime();
+    {var i: usize = 0; while (i < read_count; i += 1) {
+        const offset = rand.rangeUnsigned(usize, 0, block_count) * block_size;
+        const ret = linux.pread(file.fd, &blocks[0][0], block_size, offset);
+        if (linux.getErrno(ret) > 0) return error.Io;
+    }}
+    var ns = nanoTime() - start;
+    %return io.stdout.printf("random read, pread:      {} IOPS\n", u64(read_count) * 1000000000 / ns);
+
+    // Random reads with queue_depth of them in flight.
+    start = nanoTime();
+    var submitted: usize = 0;
+    var completed: usize = 0;
+    {var i: usize = 0; while (i < queue_depth; i += 1) {
+        %return queueRandomRead(&ring, &rand, file.fd, i, block_count);
+        submitted += 1;
+    }}
+    var cqes: [queue_depth]linux.io_uring_cqe = undefined;
+    while (completed < read_count) {
+        _ = %return ring.submitAndWait(1);
+        const count = %return ring.copyCqes(cqes[0...], 0);
+        for (cqes[0...count]) |cqe| {
+            if (cqe.res < 0) return error.Io;
+            completed += 1;
+            if (submitted < read_count) {
+                %return queueRandomRead(&ring, &rand, file.fd, usize(cqe.user_data), block_count);
+                submitted += 1;
+            }
+        }
+    }
+    ns = nanoTime() - start;
+    %return io.stdout.printf("random read, io_uring:   {} IOPS   (queue depth {})\n",
+        u64(read_count) * 1000000000 / ns, usize(queue_depth));
+
+    // Loopback transfer: the client sends chunks which the server receives.
+    var localhost = net.ip4Address([]u8 { 127, 0, 0, 1 });
+    const listener = %return net.listenAddr(&localhost, 0, 1);
+    defer listener.close() %% {};
+    const port = %return listener.getPort();
+    const client = %return net.connectAddr(&localhost, port);
+    defer client.close() %% {};
+    var accepted: [1]net.Connection = undefined;
+    const server = (%return listener.acceptBatch(accepted[0...]))[0];
+    defer server.close() %% {};
+    mem.set(u8, send_buf[0...], 'z');
+
+    // Blocking: one send and the recvs it takes to drain it. The accepted
+    // socket is non-blocking, but the data has always arrived by then.
+    start = nanoTime();
+    var received: usize = 0;
+    while (received < transfer_bytes) {
+        const sent = %return client.send(send_buf[0...]);
+        var left = sent;
+        while (left > 0) {
+            const data = server.recv(recv_bufs[0][0...left]) %% |err| {
+                if (err == error.WouldBlock) continue;
+                return err;
+            };
+            left -= data.len;
+        }
+        received += sent;
+    }
+    ns = nanoTime() - start;
+    %return io.stdout.printf("loopback, send/recv:     {} MB/s\n", u64(transfer_bytes) * 1000 / ns);
+
+    // io_uring: queue_depth sends and as many recvs per system call.
+    start = nanoTime();
+    received = 0;
+    while (received < transfer_bytes) {
+        {var i: usize = 0; while (i < queue_depth; i += 1) {
+            _ = %return ring.send(0, client.socket_fd, send_buf[0...], 0);
+            _ = %return ring.recv(1, server.socket_fd, recv_bufs[i][0...], 0);
+        }}
+        var pending: u32 = queue_depth * 2;
+        _ = %return ring.submitAndWait(pending);
+        while (pending > 0) {
+            const count = %return ring.copyCqes(cqes[0...], 1);
+            for (cqes[0...count]) |cqe| {
+                if (cqe.user_data == 1) {
+                    // a recv finding nothing yet fails with EAGAIN on the
+                    // non-blocking socket, and the next round picks it up
+                    if (cqe.res > 0) received += usize(cqe.res);
+                } else if (cqe.res < 0) {
+                    return error.Io;
+                }
+            }
+            pending -= count;
+        }
+    }
+    ns = nanoTime() - start;
+    %return io.stdout.printf("loopback, io_uring:      {} MB/s   (queue depth {})\n",
+        u64(received) * 1000 / ns, usize(queue_depth));
+}
+
+fn queueRandomRead(ring: &IoUring, rand: &Rand, fd: i32, slot: usize, block_count: usize) -> %void {
+    const offset = rand.rangeUnsigned(usize, 0, block_count) * block_size;
+    _ = %return ring.read(u64(slot), fd, blocks[slot][0...], u64(offset));
+}
+
+fn nanoTime() -> u64 {
+    var ts: linux.timespec = undefined;
+    _ = linux.clock_gettime(linux.CLOCK_MONOTONIC, &ts);
+    return u64(ts.tv_sec) * 1000000000 + u64(ts.tv_nsec);
+}
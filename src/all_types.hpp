@@ -103,6 +103,10 @@ struct ConstArrayValue {
     ConstParent parent;
 };
 
+struct ConstVectorValue {
+    ConstExprValue *elements;
+};
+
 enum ConstPtrSpecial {
     // Enforce explicitly setting this ID by making the zero value invalid.
     ConstPtrSpecialInvalid,
@@ -211,6 +215,7 @@ struct ConstExprValue {
         ConstEnumValue x_enum;
         ConstStructValue x_struct;
         ConstArrayValue x_array;
+        ConstVectorValue x_vector;
         ConstPtrValue x_ptr;
         ImportTableEntry *x_import;
         Scope *x_block;
@@ -502,6 +507,8 @@ enum CastOp {
     CastOpBoolToInt,
     CastOpResizeSlice,
     CastOpBytesToSlice,
+    CastOpArrayToVector,
+    CastOpVectorToArray,
 };
 
 struct AstNodeFnCallExpr {
@@ -873,6 +880,12 @@ struct TypeTableEntryArray {
     uint64_t len;
 };
 
+struct TypeTableEntryVector {
+    // an integer, float or bool type
+    TypeTableEntry *elem_type;
+    uint32_t len;
+};
+
 struct TypeStructField {
     Buf *name;
     TypeTableEntry *type_entry;
@@ -1016,6 +1029,7 @@ enum TypeTableEntryId {
     TypeTableEntryIdBlock,
     TypeTableEntryIdBoundFn,
     TypeTableEntryIdArgTuple,
+    TypeTableEntryIdVector,
 };
 
 struct TypeTableEntry {
@@ -1032,6 +1046,7 @@ struct TypeTableEntry {
         TypeTableEntryInt integral;
         TypeTableEntryFloat floating;
         TypeTableEntryArray array;
+        TypeTableEntryVector vector;
         TypeTableEntryStruct structure;
         TypeTableEntryMaybe maybe;
         TypeTableEntryError error;
@@ -1148,6 +1163,16 @@ enum BuiltinFnId {
     BuiltinFnIdGeneratedCode,
     BuiltinFnIdCtz,
     BuiltinFnIdClz,
+    BuiltinFnIdBswap,
+    BuiltinFnIdPopCount,
+    BuiltinFnIdBitReverse,
+    BuiltinFnIdRotl,
+    BuiltinFnIdRotr,
+    BuiltinFnIdVectorType,
+    BuiltinFnIdSplat,
+    BuiltinFnIdShuffle,
+    BuiltinFnIdSelect,
+    BuiltinFnIdReduce,
     BuiltinFnIdImport,
     BuiltinFnIdCImport,
     BuiltinFnIdErrName,
@@ -1164,6 +1189,7 @@ enum BuiltinFnId {
     BuiltinFnIdSetFnTest,
     BuiltinFnIdSetFnVisible,
     BuiltinFnIdSetDebugSafety,
+    BuiltinFnIdSetFastMath,
     BuiltinFnIdAlloca,
     BuiltinFnIdTypeName,
     BuiltinFnIdIsInteger,
@@ -1215,6 +1241,10 @@ struct TypeId {
             TypeTableEntry *child_type;
             uint64_t size;
         } array;
+        struct {
+            TypeTableEntry *elem_type;
+            uint32_t len;
+        } vector;
         struct {
             bool is_signed;
             uint8_t bit_count;
@@ -1228,6 +1258,9 @@ bool type_id_eql(TypeId a, TypeId b);
 enum ZigLLVMFnId {
     ZigLLVMFnIdCtz,
     ZigLLVMFnIdClz,
+    ZigLLVMFnIdBswap,
+    ZigLLVMFnIdPopCount,
+    ZigLLVMFnIdBitReverse,
     ZigLLVMFnIdOverflowArithmetic,
 };
 
@@ -1247,6 +1280,15 @@ struct ZigLLVMFnKey {
         struct {
             uint32_t bit_count;
         } clz;
+        struct {
+            uint32_t bit_count;
+        } bswap;
+        struct {
+            uint32_t bit_count;
+        } pop_count;
+        struct {
+            uint32_t bit_count;
+        } bit_reverse;
         struct {
             AddSubMul add_sub_mul;
             uint32_t bit_count;
@@ -1324,6 +1366,7 @@ struct CodeGen {
         TypeTableEntry *entry_environ_enum;
         TypeTableEntry *entry_oformat_enum;
         TypeTableEntry *entry_atomic_order_enum;
+        TypeTableEntry *entry_reduce_op_enum;
         TypeTableEntry *entry_arg_tuple;
     } builtin_types;
 
@@ -1366,6 +1409,11 @@ struct CodeGen {
     Buf *mios_version_min;
     bool linker_rdynamic;
     const char *linker_script;
+    Buf *opt_remarks_path;
+    bool emit_asm;
+    bool emit_llvm_ir;
+    bool emit_llvm_bc;
+    bool verify_llvm;
 
     // The function definitions this module includes. There must be a corresponding
     // fn_protos entry.
@@ -1495,6 +1543,8 @@ struct ScopeDecls {
     HashMap<Buf *, Tld *, buf_hash, buf_eql_buf> decl_table;
     bool safety_off;
     AstNode *safety_set_node;
+    bool fast_math_on;
+    AstNode *fast_math_set_node;
     ImportTableEntry *import;
     // If this is a scope from a container, this is the type entry, otherwise null
     TypeTableEntry *container_type;
@@ -1508,6 +1558,8 @@ struct ScopeBlock {
     HashMap<Buf *, LabelTableEntry *, buf_hash, buf_eql_buf> label_table; 
     bool safety_off;
     AstNode *safety_set_node;
+    bool fast_math_on;
+    AstNode *fast_math_set_node;
 };
 
 // This scope is created from every defer expression.
@@ -1575,6 +1627,16 @@ enum AtomicOrder {
     AtomicOrderSeqCst,
 };
 
+enum ReduceOp {
+    ReduceOpAdd,
+    ReduceOpMul,
+    ReduceOpAnd,
+    ReduceOpOr,
+    ReduceOpXor,
+    ReduceOpMin,
+    ReduceOpMax,
+};
+
 // A basic block contains no branching. Branches send control flow
 // to another basic block.
 // Phi instructions must be first in a basic block.
@@ -1630,6 +1692,7 @@ enum IrInstructionId {
     IrInstructionIdSetFnTest,
     IrInstructionIdSetFnVisible,
     IrInstructionIdSetDebugSafety,
+    IrInstructionIdSetFastMath,
     IrInstructionIdArrayType,
     IrInstructionIdSliceType,
     IrInstructionIdAsm,
@@ -1641,6 +1704,15 @@ enum IrInstructionId {
     IrInstructionIdEnumTag,
     IrInstructionIdClz,
     IrInstructionIdCtz,
+    IrInstructionIdBswap,
+    IrInstructionIdPopCount,
+    IrInstructionIdBitReverse,
+    IrInstructionIdRotate,
+    IrInstructionIdVectorType,
+    IrInstructionIdSplat,
+    IrInstructionIdShuffle,
+    IrInstructionIdSelect,
+    IrInstructionIdReduce,
     IrInstructionIdGeneratedCode,
     IrInstructionIdImport,
     IrInstructionIdCImport,
@@ -1990,6 +2062,13 @@ struct IrInstructionSetDebugSafety {
     IrInstruction *debug_safety_on;
 };
 
+struct IrInstructionSetFastMath {
+    IrInstruction base;
+
+    IrInstruction *scope_value;
+    IrInstruction *fast_math_on;
+};
+
 struct IrInstructionArrayType {
     IrInstruction base;
 
@@ -2054,6 +2133,73 @@ struct IrInstructionClz {
     IrInstruction *value;
 };
 
+struct IrInstructionBswap {
+    IrInstruction base;
+
+    IrInstruction *value;
+};
+
+struct IrInstructionPopCount {
+    IrInstruction base;
+
+    IrInstruction *value;
+};
+
+struct IrInstructionBitReverse {
+    IrInstruction base;
+
+    IrInstruction *value;
+};
+
+struct IrInstructionRotate {
+    IrInstruction base;
+
+    IrInstruction *value;
+    IrInstruction *amount;
+    bool is_left;
+};
+
+struct IrInstructionVectorType {
+    IrInstruction base;
+
+    IrInstruction *len;
+    IrInstruction *elem_type;
+};
+
+struct IrInstructionSplat {
+    IrInstruction base;
+
+    IrInstruction *vector_type;
+    IrInstruction *value;
+};
+
+struct IrInstructionShuffle {
+    IrInstruction base;
+
+    IrInstruction *a;
+    IrInstruction *b;
+    // always comptime known, an array of indexes into a followed by b
+    IrInstruction *mask;
+};
+
+struct IrInstructionSelect {
+    IrInstruction base;
+
+    IrInstruction *mask;
+    IrInstruction *a;
+    IrInstruction *b;
+};
+
+struct IrInstructionReduce {
+    IrInstruction base;
+
+    IrInstruction *op_value;
+    IrInstruction *value;
+
+    // if this instruction gets to runtime then we know this value:
+    ReduceOp op;
+};
+
 struct IrInstructionEnumTag {
     IrInstruction base;
 
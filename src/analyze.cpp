@@ -195,6 +195,7 @@ bool type_is_complete(TypeTableEntry *type_entry) {
         case TypeTableEntryIdFloat:
         case TypeTableEntryIdPointer:
         case TypeTableEntryIdArray:
+        case TypeTableEntryIdVector:
         case TypeTableEntryIdNumLitFloat:
         case TypeTableEntryIdNumLitInt:
         case TypeTableEntryIdUndefLit:
@@ -233,6 +234,7 @@ bool type_has_zero_bits_known(TypeTableEntry *type_entry) {
         case TypeTableEntryIdFloat:
         case TypeTableEntryIdPointer:
         case TypeTableEntryIdArray:
+        case TypeTableEntryIdVector:
         case TypeTableEntryIdNumLitFloat:
         case TypeTableEntryIdNumLitInt:
         case TypeTableEntryIdUndefLit:
@@ -575,6 +577,59 @@ TypeTableEntry *get_array_type(CodeGen *g, TypeTableEntry *child_type, uint64_t
     return entry;
 }
 
+TypeTableEntry *get_vector_type(CodeGen *g, uint32_t len, TypeTableEntry *elem_type) {
+    assert(is_valid_vector_elem_type(elem_type));
+    assert(len != 0);
+    TypeId type_id = {};
+    type_id.id = TypeTableEntryIdVector;
+    type_id.data.vector.elem_type = elem_type;
+    type_id.data.vector.len = len;
+    auto existing_entry = g->type_table.maybe_get(type_id);
+    if (existing_entry) {
+        TypeTableEntry *entry = existing_entry->value;
+        return entry;
+    }
+
+    TypeTableEntry *entry = new_type_table_entry(TypeTableEntryIdVector);
+    entry->zero_bits = false;
+
+    buf_resize(&entry->name, 0);
+    buf_appendf(&entry->name, "@Vector(%" PRIu32 ", %s)", len, buf_ptr(&elem_type->name));
+
+    entry->type_ref = LLVMVectorType(elem_type->type_ref, len);
+
+    // debug info describes the vector as the array of the same elements
+    uint64_t debug_size_in_bits = 8*LLVMStoreSizeOfType(g->target_data_ref, entry->type_ref);
+    uint64_t debug_align_in_bits = 8*LLVMABIAlignmentOfType(g->target_data_ref, entry->type_ref);
+    entry->di_type = ZigLLVMCreateDebugArrayType(g->dbuilder, debug_size_in_bits,
+            debug_align_in_bits, elem_type->di_type, len);
+
+    entry->data.vector.elem_type = elem_type;
+    entry->data.vector.len = len;
+
+    g->type_table.put(type_id, entry);
+    return entry;
+}
+
+bool is_valid_vector_elem_type(TypeTableEntry *elem_type) {
+    return elem_type->id == TypeTableEntryIdInt ||
+        elem_type->id == TypeTableEntryIdFloat ||
+        elem_type->id == TypeTableEntryIdBool;
+}
+
+// Whether the elements of the vector are in memory the same way as the
+// elements of an array. bool and odd sized integer vectors are bit packed.
+bool vector_has_array_layout(TypeTableEntry *vector_type) {
+    TypeTableEntry *elem_type = vector_type->data.vector.elem_type;
+    if (elem_type->id == TypeTableEntryIdFloat)
+        return true;
+    if (elem_type->id == TypeTableEntryIdInt) {
+        uint32_t bit_count = elem_type->data.integral.bit_count;
+        return bit_count >= 8 && (bit_count & (bit_count - 1)) == 0;
+    }
+    return false;
+}
+
 static void slice_type_common_init(CodeGen *g, TypeTableEntry *child_type,
         bool is_const, TypeTableEntry *entry)
 {
@@ -1067,6 +1122,7 @@ static TypeTableEntry *analyze_fn_type(CodeGen *g, AstNode *proto_node, Scope *c
             case TypeTableEntryIdFloat:
             case TypeTableEntryIdPointer:
             case TypeTableEntryIdArray:
+            case TypeTableEntryIdVector:
             case TypeTableEntryIdStruct:
             case TypeTableEntryIdMaybe:
             case TypeTableEntryIdErrorUnion:
@@ -1117,6 +1173,7 @@ static TypeTableEntry *analyze_fn_type(CodeGen *g, AstNode *proto_node, Scope *c
         case TypeTableEntryIdFloat:
         case TypeTableEntryIdPointer:
         case TypeTableEntryIdArray:
+        case TypeTableEntryIdVector:
         case TypeTableEntryIdStruct:
         case TypeTableEntryIdMaybe:
         case TypeTableEntryIdErrorUnion:
@@ -1366,6 +1423,7 @@ static bool type_allowed_in_packed_struct(TypeTableEntry *type_entry) {
         case TypeTableEntryIdBlock:
         case TypeTableEntryIdBoundFn:
         case TypeTableEntryIdArgTuple:
+        case TypeTableEntryIdVector:
             return false;
         case TypeTableEntryIdVoid:
         case TypeTableEntryIdBool:
@@ -2063,6 +2121,7 @@ TypeTableEntry *validate_var_type(CodeGen *g, AstNode *source_node, TypeTableEnt
         case TypeTableEntryIdFloat:
         case TypeTableEntryIdPointer:
         case TypeTableEntryIdArray:
+        case TypeTableEntryIdVector:
         case TypeTableEntryIdStruct:
         case TypeTableEntryIdMaybe:
         case TypeTableEntryIdErrorUnion:
@@ -2479,6 +2538,7 @@ static bool is_container(TypeTableEntry *type_entry) {
         case TypeTableEntryIdInt:
         case TypeTableEntryIdFloat:
         case TypeTableEntryIdArray:
+        case TypeTableEntryIdVector:
         case TypeTableEntryIdNumLitFloat:
         case TypeTableEntryIdNumLitInt:
         case TypeTableEntryIdUndefLit:
@@ -2528,6 +2588,7 @@ void resolve_container_type(CodeGen *g, TypeTableEntry *type_entry) {
         case TypeTableEntryIdInt:
         case TypeTableEntryIdFloat:
         case TypeTableEntryIdArray:
+        case TypeTableEntryIdVector:
         case TypeTableEntryIdNumLitFloat:
         case TypeTableEntryIdNumLitInt:
         case TypeTableEntryIdUndefLit:
@@ -2631,6 +2692,9 @@ void analyze_fn_ir(CodeGen *g, FnTableEntry *fn_table_entry, AstNode *return_typ
         return;
     }
 
+    ir_elide_bounds_checks(&fn_table_entry->analyzed_executable);
+    ir_verify(&fn_table_entry->analyzed_executable);
+
     if (g->verbose) {
         fprintf(stderr, "{ // (analyzed)\n");
         ir_print(stderr, &fn_table_entry->analyzed_executable, 4);
@@ -2947,6 +3011,7 @@ bool handle_is_ptr(TypeTableEntry *type_entry) {
         case TypeTableEntryIdPureError:
         case TypeTableEntryIdFn:
         case TypeTableEntryIdEnumTag:
+        case TypeTableEntryIdVector:
              return false;
         case TypeTableEntryIdArray:
         case TypeTableEntryIdStruct:
@@ -3104,6 +3169,14 @@ static uint32_t hash_const_val(ConstExprValue *const_val) {
         case TypeTableEntryIdArray:
             // TODO better hashing algorithm
             return 1166190605;
+        case TypeTableEntryIdVector:
+            {
+                uint32_t hash_val = 2337346741;
+                for (uint32_t i = 0; i < const_val->type->data.vector.len; i += 1) {
+                    hash_val = hash_val * 31 + hash_const_val(&const_val->data.x_vector.elements[i]);
+                }
+                return hash_val;
+            }
         case TypeTableEntryIdStruct:
             // TODO better hashing algorithm
             return 1532530855;
@@ -3249,6 +3322,7 @@ bool type_requires_comptime(TypeTableEntry *type_entry) {
         case TypeTableEntryIdArgTuple:
             return true;
         case TypeTableEntryIdArray:
+        case TypeTableEntryIdVector:
         case TypeTableEntryIdStruct:
         case TypeTableEntryIdUnion:
         case TypeTableEntryIdMaybe:
@@ -3617,6 +3691,12 @@ bool const_values_equal(ConstExprValue *a, ConstExprValue *b) {
             zig_unreachable();
         case TypeTableEntryIdArray:
             zig_panic("TODO");
+        case TypeTableEntryIdVector:
+            for (uint32_t i = 0; i < a->type->data.vector.len; i += 1) {
+                if (!const_values_equal(&a->data.x_vector.elements[i], &b->data.x_vector.elements[i]))
+                    return false;
+            }
+            return true;
         case TypeTableEntryIdStruct:
             for (size_t i = 0; i < a->type->data.structure.src_field_count; i += 1) {
                 ConstExprValue *field_a = &a->data.x_struct.fields[i];
@@ -3850,6 +3930,17 @@ void render_const_value(Buf *buf, ConstExprValue *const_val) {
                 buf_appendf(buf, "}");
                 return;
             }
+        case TypeTableEntryIdVector:
+            {
+                buf_appendf(buf, "%s{", buf_ptr(&canon_type->name));
+                for (uint32_t i = 0; i < canon_type->data.vector.len; i += 1) {
+                    if (i != 0)
+                        buf_appendf(buf, ",");
+                    render_const_value(buf, &const_val->data.x_vector.elements[i]);
+                }
+                buf_appendf(buf, "}");
+                return;
+            }
         case TypeTableEntryIdNullLit:
             {
                 buf_appendf(buf, "null");
@@ -3994,6 +4085,9 @@ uint32_t type_id_hash(TypeId x) {
         case TypeTableEntryIdArray:
             return hash_ptr(x.data.array.child_type) +
                 (x.data.array.size * 2122979968);
+        case TypeTableEntryIdVector:
+            return hash_ptr(x.data.vector.elem_type) +
+                (x.data.vector.len * 3396081247);
         case TypeTableEntryIdInt:
             return (x.data.integer.is_signed ? 2652528194 : 163929201) +
                     (((uint32_t)x.data.integer.bit_count) * 2998081557);
@@ -4039,6 +4133,9 @@ bool type_id_eql(TypeId a, TypeId b) {
         case TypeTableEntryIdArray:
             return a.data.array.child_type == b.data.array.child_type &&
                 a.data.array.size == b.data.array.size;
+        case TypeTableEntryIdVector:
+            return a.data.vector.elem_type == b.data.vector.elem_type &&
+                a.data.vector.len == b.data.vector.len;
         case TypeTableEntryIdInt:
             return a.data.integer.is_signed == b.data.integer.is_signed &&
                 a.data.integer.bit_count == b.data.integer.bit_count;
@@ -4052,6 +4149,12 @@ uint32_t zig_llvm_fn_key_hash(ZigLLVMFnKey x) {
             return x.data.ctz.bit_count * 810453934;
         case ZigLLVMFnIdClz:
             return x.data.clz.bit_count * 2428952817;
+        case ZigLLVMFnIdBswap:
+            return x.data.bswap.bit_count * 3661994335;
+        case ZigLLVMFnIdPopCount:
+            return x.data.pop_count.bit_count * 101195049;
+        case ZigLLVMFnIdBitReverse:
+            return x.data.bit_reverse.bit_count * 2621398431;
         case ZigLLVMFnIdOverflowArithmetic:
             return (x.data.overflow_arithmetic.bit_count * 87135777) +
                 (x.data.overflow_arithmetic.add_sub_mul * 31640542) +
@@ -4068,6 +4171,12 @@ bool zig_llvm_fn_key_eql(ZigLLVMFnKey a, ZigLLVMFnKey b) {
             return a.data.ctz.bit_count == b.data.ctz.bit_count;
         case ZigLLVMFnIdClz:
             return a.data.clz.bit_count == b.data.clz.bit_count;
+        case ZigLLVMFnIdBswap:
+            return a.data.bswap.bit_count == b.data.bswap.bit_count;
+        case ZigLLVMFnIdPopCount:
+            return a.data.pop_count.bit_count == b.data.pop_count.bit_count;
+        case ZigLLVMFnIdBitReverse:
+            return a.data.bit_reverse.bit_count == b.data.bit_reverse.bit_count;
         case ZigLLVMFnIdOverflowArithmetic:
             return (a.data.overflow_arithmetic.bit_count == b.data.overflow_arithmetic.bit_count) &&
                 (a.data.overflow_arithmetic.add_sub_mul == b.data.overflow_arithmetic.add_sub_mul) &&
@@ -402,3 +402,68 @@ uint32_t bignum_clz(BigNum *bignum, uint32_t bit_count) {
     }
     return result;
 }
+
+// Sets dest to the integer of bit_count bits whose twos complement
+// representation is the low bit_count bits of bits.
+static void bignum_init_bits(BigNum *dest, uint64_t bits, uint32_t bit_count, bool is_signed) {
+    if (bit_count < 64)
+        bits &= (((uint64_t)1) << bit_count) - 1;
+    if (is_signed) {
+        if (bit_count != 0 && bit_count < 64 && ((bits >> (bit_count - 1)) & 0x1) != 0)
+            bits |= UINT64_MAX << bit_count;
+        bignum_init_signed(dest, (int64_t)bits);
+    } else {
+        bignum_init_unsigned(dest, bits);
+    }
+}
+
+void bignum_bswap(BigNum *dest, BigNum *op, uint32_t bit_count, bool is_signed) {
+    assert(op->kind == BigNumKindInt);
+    assert(bit_count % 8 == 0 && bit_count <= 64);
+
+    uint64_t x = bignum_to_twos_complement(op);
+    uint64_t result = 0;
+    for (uint32_t i = 0; i < bit_count; i += 8) {
+        result = (result << 8) | ((x >> i) & 0xff);
+    }
+    bignum_init_bits(dest, result, bit_count, is_signed);
+}
+
+uint32_t bignum_pop_count(BigNum *bignum, uint32_t bit_count) {
+    assert(bignum->kind == BigNumKindInt);
+    assert(bit_count <= 64);
+
+    uint64_t x = bignum_to_twos_complement(bignum);
+    if (bit_count < 64)
+        x &= (((uint64_t)1) << bit_count) - 1;
+    uint32_t result = 0;
+    while (x != 0) {
+        x &= x - 1;
+        result += 1;
+    }
+    return result;
+}
+
+void bignum_bit_reverse(BigNum *dest, BigNum *op, uint32_t bit_count, bool is_signed) {
+    assert(op->kind == BigNumKindInt);
+    assert(bit_count <= 64);
+
+    uint64_t x = bignum_to_twos_complement(op);
+    uint64_t result = 0;
+    for (uint32_t i = 0; i < bit_count; i += 1) {
+        result = (result << 1) | ((x >> i) & 0x1);
+    }
+    bignum_init_bits(dest, result, bit_count, is_signed);
+}
+
+void bignum_rotl(BigNum *dest, BigNum *op, uint64_t amount, uint32_t bit_count, bool is_signed) {
+    assert(op->kind == BigNumKindInt);
+    assert(bit_count != 0 && bit_count <= 64);
+
+    uint64_t x = bignum_to_twos_complement(op);
+    if (bit_count < 64)
+        x &= (((uint64_t)1) << bit_count) - 1;
+    uint32_t shift = amount % bit_count;
+    uint64_t result = (shift == 0) ? x : ((x << shift) | (x >> (bit_count - shift)));
+    bignum_init_bits(dest, result, bit_count, is_signed);
+}
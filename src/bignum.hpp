@@ -69,5 +69,10 @@ Buf *bignum_to_buf(BigNum *bn);
 
 uint32_t bignum_ctz(BigNum *bignum, uint32_t bit_count);
 uint32_t bignum_clz(BigNum *bignum, uint32_t bit_count);
+void bignum_bswap(BigNum *dest, BigNum *op, uint32_t bit_count, bool is_signed);
+uint32_t bignum_pop_count(BigNum *bignum, uint32_t bit_count);
+void bignum_bit_reverse(BigNum *dest, BigNum *op, uint32_t bit_count, bool is_signed);
+// rotates the low bit_count bits of op left by amount modulo bit_count
+void bignum_rotl(BigNum *dest, BigNum *op, uint64_t amount, uint32_t bit_count, bool is_signed);
 
 #endif
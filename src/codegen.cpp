@@ -67,6 +67,11 @@ CodeGen *codegen_create(Buf *root_source_dir, const ZigTarget *target) {
     g->is_release_build = false;
     g->is_test_build = false;
     g->want_h_file = true;
+#ifdef NDEBUG
+    g->verify_llvm = false;
+#else
+    g->verify_llvm = true;
+#endif
 
     // reserve index 0 to indicate no error
     g->error_decls.append(nullptr);
@@ -231,6 +236,20 @@ void codegen_set_linker_script(CodeGen *g, const char *linker_script) {
     g->linker_script = linker_script;
 }
 
+void codegen_set_opt_remarks_path(CodeGen *g, Buf *opt_remarks_path) {
+    g->opt_remarks_path = opt_remarks_path;
+}
+
+void codegen_set_emit(CodeGen *g, bool emit_asm, bool emit_llvm_ir, bool emit_llvm_bc) {
+    g->emit_asm = emit_asm;
+    g->emit_llvm_ir = emit_llvm_ir;
+    g->emit_llvm_bc = emit_llvm_bc;
+}
+
+void codegen_set_verify_llvm(CodeGen *g, bool verify_llvm) {
+    g->verify_llvm = verify_llvm;
+}
+
 
 static void render_const_val(CodeGen *g, ConstExprValue *const_val);
 static void render_const_val_global(CodeGen *g, ConstExprValue *const_val, const char *name);
@@ -442,6 +461,24 @@ static bool ir_want_debug_safety(CodeGen *g, IrInstruction *instruction) {
     return true;
 }
 
+static bool ir_want_fast_math(CodeGen *g, IrInstruction *instruction) {
+    // TODO memoize
+    Scope *scope = instruction->scope;
+    while (scope) {
+        if (scope->id == ScopeIdBlock) {
+            ScopeBlock *block_scope = (ScopeBlock *)scope;
+            if (block_scope->fast_math_set_node)
+                return block_scope->fast_math_on;
+        } else if (scope->id == ScopeIdDecls) {
+            ScopeDecls *decls_scope = (ScopeDecls *)scope;
+            if (decls_scope->fast_math_set_node)
+                return decls_scope->fast_math_on;
+        }
+        scope = scope->parent;
+    }
+    return false;
+}
+
 static Buf *panic_msg_buf(PanicMsgId msg_id) {
     switch (msg_id) {
         case PanicMsgIdCount:
@@ -915,6 +952,16 @@ static LLVMValueRef ir_render_bin_op(CodeGen *g, IrExecutable *executable,
     bool want_debug_safety = bin_op_instruction->safety_check_on &&
         ir_want_debug_safety(g, &bin_op_instruction->base);
 
+    // vectors use the same instructions as their elements. The safety checks
+    // branch on a single bit, so vector operations go without them.
+    if (canon_type->id == TypeTableEntryIdVector) {
+        canon_type = get_underlying_type(canon_type->data.vector.elem_type);
+        want_debug_safety = false;
+    }
+
+    if (canon_type->id == TypeTableEntryIdFloat)
+        ZigLLVMSetFastMath(g->builder, ir_want_fast_math(g, &bin_op_instruction->base));
+
     LLVMValueRef op1_value = ir_llvm_value(g, op1);
     LLVMValueRef op2_value = ir_llvm_value(g, op2);
     switch (op_id) {
@@ -1180,6 +1227,56 @@ static LLVMValueRef ir_render_cast(CodeGen *g, IrExecutable *executable,
             assert(wanted_type->id == TypeTableEntryIdInt);
             assert(actual_type->id == TypeTableEntryIdBool);
             return LLVMBuildZExt(g->builder, expr_val, wanted_type->type_ref, "");
+        case CastOpArrayToVector:
+            {
+                assert(actual_type->id == TypeTableEntryIdArray);
+                assert(wanted_type->id == TypeTableEntryIdVector);
+                if (!vector_has_array_layout(wanted_type)) {
+                    LLVMValueRef result = LLVMGetUndef(wanted_type->type_ref);
+                    for (uint32_t i = 0; i < wanted_type->data.vector.len; i += 1) {
+                        LLVMValueRef indices[] = {
+                            LLVMConstNull(g->builtin_types.entry_usize->type_ref),
+                            LLVMConstInt(g->builtin_types.entry_usize->type_ref, i, false),
+                        };
+                        LLVMValueRef elem_ptr = LLVMBuildInBoundsGEP(g->builder, expr_val, indices, 2, "");
+                        LLVMValueRef elem = LLVMBuildLoad(g->builder, elem_ptr, "");
+                        result = LLVMBuildInsertElement(g->builder, result, elem,
+                                LLVMConstInt(g->builtin_types.entry_u32->type_ref, i, false), "");
+                    }
+                    return result;
+                }
+                // the array is only known to be aligned for its elements
+                LLVMValueRef vector_ptr = LLVMBuildBitCast(g->builder, expr_val,
+                        LLVMPointerType(wanted_type->type_ref, 0), "");
+                LLVMValueRef result = LLVMBuildLoad(g->builder, vector_ptr, "");
+                LLVMSetAlignment(result, get_type_alignment(g, actual_type->data.array.child_type));
+                return result;
+            }
+        case CastOpVectorToArray:
+            {
+                assert(cast_instruction->tmp_ptr);
+                assert(actual_type->id == TypeTableEntryIdVector);
+                assert(wanted_type->id == TypeTableEntryIdArray);
+                if (!vector_has_array_layout(actual_type)) {
+                    for (uint32_t i = 0; i < actual_type->data.vector.len; i += 1) {
+                        LLVMValueRef indices[] = {
+                            LLVMConstNull(g->builtin_types.entry_usize->type_ref),
+                            LLVMConstInt(g->builtin_types.entry_usize->type_ref, i, false),
+                        };
+                        LLVMValueRef elem_ptr = LLVMBuildInBoundsGEP(g->builder, cast_instruction->tmp_ptr,
+                                indices, 2, "");
+                        LLVMValueRef elem = LLVMBuildExtractElement(g->builder, expr_val,
+                                LLVMConstInt(g->builtin_types.entry_u32->type_ref, i, false), "");
+                        LLVMBuildStore(g->builder, elem, elem_ptr);
+                    }
+                    return cast_instruction->tmp_ptr;
+                }
+                LLVMValueRef vector_ptr = LLVMBuildBitCast(g->builder, cast_instruction->tmp_ptr,
+                        LLVMPointerType(actual_type->type_ref, 0), "");
+                LLVMValueRef store_instr = LLVMBuildStore(g->builder, expr_val, vector_ptr);
+                LLVMSetAlignment(store_instr, get_type_alignment(g, wanted_type->data.array.child_type));
+                return cast_instruction->tmp_ptr;
+            }
     }
     zig_unreachable();
 }
@@ -1282,6 +1379,7 @@ static LLVMValueRef ir_render_un_op(CodeGen *g, IrExecutable *executable, IrInst
         case IrUnOpNegationWrap:
             {
                 if (expr_type->id == TypeTableEntryIdFloat) {
+                    ZigLLVMSetFastMath(g->builder, ir_want_fast_math(g, &un_op_instruction->base));
                     return LLVMBuildFNeg(g->builder, expr, "");
                 } else if (expr_type->id == TypeTableEntryIdInt) {
                     if (op_id == IrUnOpNegationWrap) {
@@ -1787,14 +1885,33 @@ static LLVMValueRef ir_render_unwrap_maybe(CodeGen *g, IrExecutable *executable,
 static LLVMValueRef get_int_builtin_fn(CodeGen *g, TypeTableEntry *int_type, BuiltinFnId fn_id) {
     ZigLLVMFnKey key = {};
     const char *fn_name;
+    // cttz and ctlz take an i1 saying whether zero is undefined, the others
+    // take only the value
+    size_t param_count = 2;
     if (fn_id == BuiltinFnIdCtz) {
         fn_name = "cttz";
         key.id = ZigLLVMFnIdCtz;
         key.data.ctz.bit_count = int_type->data.integral.bit_count;
-    } else {
+    } else if (fn_id == BuiltinFnIdClz) {
         fn_name = "ctlz";
         key.id = ZigLLVMFnIdClz;
         key.data.clz.bit_count = int_type->data.integral.bit_count;
+    } else if (fn_id == BuiltinFnIdBswap) {
+        fn_name = "bswap";
+        param_count = 1;
+        key.id = ZigLLVMFnIdBswap;
+        key.data.bswap.bit_count = int_type->data.integral.bit_count;
+    } else if (fn_id == BuiltinFnIdPopCount) {
+        fn_name = "ctpop";
+        param_count = 1;
+        key.id = ZigLLVMFnIdPopCount;
+        key.data.pop_count.bit_count = int_type->data.integral.bit_count;
+    } else {
+        assert(fn_id == BuiltinFnIdBitReverse);
+        fn_name = "bitreverse";
+        param_count = 1;
+        key.id = ZigLLVMFnIdBitReverse;
+        key.data.bit_reverse.bit_count = int_type->data.integral.bit_count;
     }
 
     auto existing_entry = g->llvm_fn_table.maybe_get(key);
@@ -1807,7 +1924,7 @@ static LLVMValueRef get_int_builtin_fn(CodeGen *g, TypeTableEntry *int_type, Bui
         int_type->type_ref,
         LLVMInt1Type(),
     };
-    LLVMTypeRef fn_type = LLVMFunctionType(int_type->type_ref, param_types, 2, false);
+    LLVMTypeRef fn_type = LLVMFunctionType(int_type->type_ref, param_types, param_count, false);
     LLVMValueRef fn_val = LLVMAddFunction(g->module, llvm_name, fn_type);
 
     g->llvm_fn_table.put(key, fn_val);
@@ -1837,6 +1954,160 @@ static LLVMValueRef ir_render_ctz(CodeGen *g, IrExecutable *executable, IrInstru
     return LLVMBuildCall(g->builder, fn_val, params, 2, "");
 }
 
+static LLVMValueRef ir_render_bswap(CodeGen *g, IrExecutable *executable, IrInstructionBswap *instruction) {
+    TypeTableEntry *int_type = instruction->base.value.type;
+    LLVMValueRef operand = ir_llvm_value(g, instruction->value);
+    // llvm.bswap needs a whole number of byte pairs
+    if (int_type->data.integral.bit_count == 8)
+        return operand;
+    LLVMValueRef fn_val = get_int_builtin_fn(g, int_type, BuiltinFnIdBswap);
+    return LLVMBuildCall(g->builder, fn_val, &operand, 1, "");
+}
+
+static LLVMValueRef ir_render_pop_count(CodeGen *g, IrExecutable *executable, IrInstructionPopCount *instruction) {
+    TypeTableEntry *int_type = instruction->value->value.type;
+    LLVMValueRef fn_val = get_int_builtin_fn(g, int_type, BuiltinFnIdPopCount);
+    LLVMValueRef operand = ir_llvm_value(g, instruction->value);
+    return LLVMBuildCall(g->builder, fn_val, &operand, 1, "");
+}
+
+static LLVMValueRef ir_render_bit_reverse(CodeGen *g, IrExecutable *executable, IrInstructionBitReverse *instruction) {
+    TypeTableEntry *int_type = instruction->base.value.type;
+    LLVMValueRef fn_val = get_int_builtin_fn(g, int_type, BuiltinFnIdBitReverse);
+    LLVMValueRef operand = ir_llvm_value(g, instruction->value);
+    return LLVMBuildCall(g->builder, fn_val, &operand, 1, "");
+}
+
+// Emits the two shifts and the or which LLVM matches to a single rotate
+// instruction. Both shift amounts are reduced modulo the bit count, so that
+// rotating by zero does not shift by the whole width.
+static LLVMValueRef ir_render_rotate(CodeGen *g, IrExecutable *executable, IrInstructionRotate *instruction) {
+    TypeTableEntry *int_type = instruction->base.value.type;
+    uint32_t bit_count = int_type->data.integral.bit_count;
+    LLVMValueRef value = ir_llvm_value(g, instruction->value);
+    LLVMValueRef amount = ir_llvm_value(g, instruction->amount);
+
+    LLVMValueRef amount_mod;
+    LLVMValueRef other_amount;
+    if ((bit_count & (bit_count - 1)) == 0) {
+        LLVMValueRef mask = LLVMConstInt(int_type->type_ref, bit_count - 1, false);
+        amount_mod = LLVMBuildAnd(g->builder, amount, mask, "");
+        other_amount = LLVMBuildAnd(g->builder, LLVMBuildNeg(g->builder, amount, ""), mask, "");
+    } else {
+        LLVMValueRef bit_count_val = LLVMConstInt(int_type->type_ref, bit_count, false);
+        amount_mod = LLVMBuildURem(g->builder, amount, bit_count_val, "");
+        other_amount = LLVMBuildURem(g->builder,
+                LLVMBuildSub(g->builder, bit_count_val, amount_mod, ""), bit_count_val, "");
+    }
+
+    LLVMValueRef shl_amount = instruction->is_left ? amount_mod : other_amount;
+    LLVMValueRef shr_amount = instruction->is_left ? other_amount : amount_mod;
+    LLVMValueRef shl = LLVMBuildShl(g->builder, value, shl_amount, "");
+    LLVMValueRef shr = LLVMBuildLShr(g->builder, value, shr_amount, "");
+    return LLVMBuildOr(g->builder, shl, shr, "");
+}
+
+static LLVMValueRef ir_render_splat(CodeGen *g, IrExecutable *executable, IrInstructionSplat *instruction) {
+    TypeTableEntry *vector_type = instruction->base.value.type;
+    LLVMValueRef value = ir_llvm_value(g, instruction->value);
+    LLVMTypeRef u32_type_ref = g->builtin_types.entry_u32->type_ref;
+
+    // put the value in element 0, then copy element 0 everywhere
+    LLVMValueRef undef_vector = LLVMGetUndef(vector_type->type_ref);
+    LLVMValueRef first = LLVMBuildInsertElement(g->builder, undef_vector, value,
+            LLVMConstNull(u32_type_ref), "");
+    LLVMValueRef zero_mask = LLVMConstNull(LLVMVectorType(u32_type_ref, vector_type->data.vector.len));
+    return LLVMBuildShuffleVector(g->builder, first, undef_vector, zero_mask, "");
+}
+
+static LLVMValueRef ir_render_shuffle(CodeGen *g, IrExecutable *executable, IrInstructionShuffle *instruction) {
+    LLVMValueRef a = ir_llvm_value(g, instruction->a);
+    LLVMValueRef b = ir_llvm_value(g, instruction->b);
+    // the mask is a constant vector of u32, as shufflevector requires
+    LLVMValueRef mask = ir_llvm_value(g, instruction->mask);
+    return LLVMBuildShuffleVector(g->builder, a, b, mask, "");
+}
+
+static LLVMValueRef ir_render_select(CodeGen *g, IrExecutable *executable, IrInstructionSelect *instruction) {
+    LLVMValueRef mask = ir_llvm_value(g, instruction->mask);
+    LLVMValueRef a = ir_llvm_value(g, instruction->a);
+    LLVMValueRef b = ir_llvm_value(g, instruction->b);
+    return LLVMBuildSelect(g->builder, mask, a, b, "");
+}
+
+// Combines a and b, which are both elements or both vectors, with one step of
+// a reduction.
+static LLVMValueRef gen_reduce_op(CodeGen *g, ReduceOp op, TypeTableEntry *elem_type,
+        LLVMValueRef a, LLVMValueRef b)
+{
+    bool is_float = (elem_type->id == TypeTableEntryIdFloat);
+    switch (op) {
+        case ReduceOpAdd:
+            return is_float ? LLVMBuildFAdd(g->builder, a, b, "") : LLVMBuildAdd(g->builder, a, b, "");
+        case ReduceOpMul:
+            return is_float ? LLVMBuildFMul(g->builder, a, b, "") : LLVMBuildMul(g->builder, a, b, "");
+        case ReduceOpAnd:
+            return LLVMBuildAnd(g->builder, a, b, "");
+        case ReduceOpOr:
+            return LLVMBuildOr(g->builder, a, b, "");
+        case ReduceOpXor:
+            return LLVMBuildXor(g->builder, a, b, "");
+        case ReduceOpMin:
+        case ReduceOpMax:
+            {
+                IrBinOp cmp_op = (op == ReduceOpMin) ? IrBinOpCmpLessThan : IrBinOpCmpGreaterThan;
+                LLVMValueRef a_wins;
+                if (is_float) {
+                    a_wins = LLVMBuildFCmp(g->builder, cmp_op_to_real_predicate(cmp_op), a, b, "");
+                } else {
+                    assert(elem_type->id == TypeTableEntryIdInt);
+                    a_wins = LLVMBuildICmp(g->builder,
+                            cmp_op_to_int_predicate(cmp_op, elem_type->data.integral.is_signed), a, b, "");
+                }
+                return LLVMBuildSelect(g->builder, a_wins, a, b, "");
+            }
+    }
+    zig_unreachable();
+}
+
+static LLVMValueRef ir_render_reduce(CodeGen *g, IrExecutable *executable, IrInstructionReduce *instruction) {
+    TypeTableEntry *vector_type = instruction->value->value.type;
+    TypeTableEntry *elem_type = get_underlying_type(vector_type->data.vector.elem_type);
+    LLVMTypeRef u32_type_ref = g->builtin_types.entry_u32->type_ref;
+    LLVMValueRef value = ir_llvm_value(g, instruction->value);
+
+    if (elem_type->id == TypeTableEntryIdFloat)
+        ZigLLVMSetFastMath(g->builder, ir_want_fast_math(g, &instruction->base));
+
+    // While the length is even, combine the upper half with the lower half.
+    // Comptime evaluation in ir.cpp combines the elements in the same order.
+    uint32_t len = vector_type->data.vector.len;
+    while (len % 2 == 0) {
+        uint32_t half = len / 2;
+        LLVMValueRef *low_indexes = allocate<LLVMValueRef>(half);
+        LLVMValueRef *high_indexes = allocate<LLVMValueRef>(half);
+        for (uint32_t i = 0; i < half; i += 1) {
+            low_indexes[i] = LLVMConstInt(u32_type_ref, i, false);
+            high_indexes[i] = LLVMConstInt(u32_type_ref, half + i, false);
+        }
+        LLVMValueRef undef_vector = LLVMGetUndef(LLVMTypeOf(value));
+        LLVMValueRef low = LLVMBuildShuffleVector(g->builder, value, undef_vector,
+                LLVMConstVector(low_indexes, half), "");
+        LLVMValueRef high = LLVMBuildShuffleVector(g->builder, value, undef_vector,
+                LLVMConstVector(high_indexes, half), "");
+        value = gen_reduce_op(g, instruction->op, elem_type, low, high);
+        len = half;
+    }
+
+    // then the elements which are left, one at a time
+    LLVMValueRef result = LLVMBuildExtractElement(g->builder, value, LLVMConstNull(u32_type_ref), "");
+    for (uint32_t i = 1; i < len; i += 1) {
+        LLVMValueRef elem = LLVMBuildExtractElement(g->builder, value, LLVMConstInt(u32_type_ref, i, false), "");
+        result = gen_reduce_op(g, instruction->op, elem_type, result, elem);
+    }
+    return result;
+}
+
 static LLVMValueRef ir_render_switch_br(CodeGen *g, IrExecutable *executable, IrInstructionSwitchBr *instruction) {
     LLVMValueRef target_value = ir_llvm_value(g, instruction->target_value);
     LLVMBasicBlockRef else_block = instruction->else_block->llvm_block;
@@ -2466,6 +2737,7 @@ static LLVMValueRef ir_render_instruction(CodeGen *g, IrExecutable *executable,
         case IrInstructionIdSetFnTest:
         case IrInstructionIdSetFnVisible:
         case IrInstructionIdSetDebugSafety:
+        case IrInstructionIdSetFastMath:
         case IrInstructionIdArrayType:
         case IrInstructionIdSliceType:
         case IrInstructionIdCompileVar:
@@ -2484,6 +2756,7 @@ static LLVMValueRef ir_render_instruction(CodeGen *g, IrExecutable *executable,
         case IrInstructionIdCUndef:
         case IrInstructionIdEmbedFile:
         case IrInstructionIdIntType:
+        case IrInstructionIdVectorType:
         case IrInstructionIdMemberCount:
         case IrInstructionIdAlignOf:
         case IrInstructionIdFnProto:
@@ -2536,6 +2809,22 @@ static LLVMValueRef ir_render_instruction(CodeGen *g, IrExecutable *executable,
             return ir_render_clz(g, executable, (IrInstructionClz *)instruction);
         case IrInstructionIdCtz:
             return ir_render_ctz(g, executable, (IrInstructionCtz *)instruction);
+        case IrInstructionIdBswap:
+            return ir_render_bswap(g, executable, (IrInstructionBswap *)instruction);
+        case IrInstructionIdPopCount:
+            return ir_render_pop_count(g, executable, (IrInstructionPopCount *)instruction);
+        case IrInstructionIdBitReverse:
+            return ir_render_bit_reverse(g, executable, (IrInstructionBitReverse *)instruction);
+        case IrInstructionIdRotate:
+            return ir_render_rotate(g, executable, (IrInstructionRotate *)instruction);
+        case IrInstructionIdSplat:
+            return ir_render_splat(g, executable, (IrInstructionSplat *)instruction);
+        case IrInstructionIdShuffle:
+            return ir_render_shuffle(g, executable, (IrInstructionShuffle *)instruction);
+        case IrInstructionIdSelect:
+            return ir_render_select(g, executable, (IrInstructionSelect *)instruction);
+        case IrInstructionIdReduce:
+            return ir_render_reduce(g, executable, (IrInstructionReduce *)instruction);
         case IrInstructionIdSwitchBr:
             return ir_render_switch_br(g, executable, (IrInstructionSwitchBr *)instruction);
         case IrInstructionIdPhi:
@@ -2699,6 +2988,7 @@ static LLVMValueRef pack_const_int(CodeGen *g, LLVMTypeRef big_int_type_ref, Con
         case TypeTableEntryIdBoundFn:
         case TypeTableEntryIdArgTuple:
         case TypeTableEntryIdVoid:
+        case TypeTableEntryIdVector:
             zig_unreachable();
         case TypeTableEntryIdBool:
             return LLVMConstInt(big_int_type_ref, const_val->data.x_bool ? 1 : 0, false);
@@ -2883,6 +3173,15 @@ static LLVMValueRef gen_const_val(CodeGen *g, ConstExprValue *const_val) {
                 }
                 return LLVMConstArray(LLVMTypeOf(values[0]), values, len);
             }
+        case TypeTableEntryIdVector:
+            {
+                uint32_t len = canon_type->data.vector.len;
+                LLVMValueRef *values = allocate<LLVMValueRef>(len);
+                for (uint32_t i = 0; i < len; i += 1) {
+                    values[i] = gen_const_val(g, &const_val->data.x_vector.elements[i]);
+                }
+                return LLVMConstVector(values, len);
+            }
         case TypeTableEntryIdEnum:
             {
                 LLVMTypeRef tag_type_ref = canon_type->data.enumeration.tag_type->type_ref;
@@ -3504,12 +3803,13 @@ static void do_code_gen(CodeGen *g) {
         LLVMDumpModule(g->module);
     }
 
-    // in release mode, we're sooooo confident that we've generated correct ir,
-    // that we skip the verify module step in order to get better performance.
-#ifndef NDEBUG
-    char *error = nullptr;
-    LLVMVerifyModule(g->module, LLVMAbortProcessAction, &error);
-#endif
+    // The LLVM verifier is a visible slice of compile time on big modules, so
+    // by default we only run it in debug builds of the compiler. ir_verify
+    // already checked the structure of our own IR during analysis.
+    if (g->verify_llvm) {
+        char *error = nullptr;
+        LLVMVerifyModule(g->module, LLVMAbortProcessAction, &error);
+    }
 }
 
 static const size_t int_sizes_in_bits[] = {
@@ -3922,6 +4222,45 @@ static void define_builtin_types(CodeGen *g) {
         g->builtin_types.entry_atomic_order_enum = entry;
         g->primitive_type_table.put(&entry->name, entry);
     }
+
+    {
+        TypeTableEntry *entry = new_type_table_entry(TypeTableEntryIdEnum);
+        entry->zero_bits = true; // only allowed at compile time
+        buf_init_from_str(&entry->name, "ReduceOp");
+        uint32_t field_count = 7;
+        entry->data.enumeration.src_field_count = field_count;
+        entry->data.enumeration.fields = allocate<TypeEnumField>(field_count);
+        entry->data.enumeration.fields[0].name = buf_create_from_str("Add");
+        entry->data.enumeration.fields[0].value = ReduceOpAdd;
+        entry->data.enumeration.fields[0].type_entry = g->builtin_types.entry_void;
+        entry->data.enumeration.fields[1].name = buf_create_from_str("Mul");
+        entry->data.enumeration.fields[1].value = ReduceOpMul;
+        entry->data.enumeration.fields[1].type_entry = g->builtin_types.entry_void;
+        entry->data.enumeration.fields[2].name = buf_create_from_str("And");
+        entry->data.enumeration.fields[2].value = ReduceOpAnd;
+        entry->data.enumeration.fields[2].type_entry = g->builtin_types.entry_void;
+        entry->data.enumeration.fields[3].name = buf_create_from_str("Or");
+        entry->data.enumeration.fields[3].value = ReduceOpOr;
+        entry->data.enumeration.fields[3].type_entry = g->builtin_types.entry_void;
+        entry->data.enumeration.fields[4].name = buf_create_from_str("Xor");
+        entry->data.enumeration.fields[4].value = ReduceOpXor;
+        entry->data.enumeration.fields[4].type_entry = g->builtin_types.entry_void;
+        entry->data.enumeration.fields[5].name = buf_create_from_str("Min");
+        entry->data.enumeration.fields[5].value = ReduceOpMin;
+        entry->data.enumeration.fields[5].type_entry = g->builtin_types.entry_void;
+        entry->data.enumeration.fields[6].name = buf_create_from_str("Max");
+        entry->data.enumeration.fields[6].value = ReduceOpMax;
+        entry->data.enumeration.fields[6].type_entry = g->builtin_types.entry_void;
+
+        entry->data.enumeration.complete = true;
+        entry->data.enumeration.zero_bits_known = true;
+
+        TypeTableEntry *tag_type_entry = get_smallest_unsigned_int_type(g, field_count);
+        entry->data.enumeration.tag_type = tag_type_entry;
+
+        g->builtin_types.entry_reduce_op_enum = entry;
+        g->primitive_type_table.put(&entry->name, entry);
+    }
 }
 
 
@@ -4021,6 +4360,16 @@ static void define_builtin_fns(CodeGen *g) {
     create_builtin_fn(g, BuiltinFnIdCompileVar, "compileVar", 1);
     create_builtin_fn(g, BuiltinFnIdGeneratedCode, "generatedCode", 1);
     create_builtin_fn(g, BuiltinFnIdCtz, "ctz", 1);
+    create_builtin_fn(g, BuiltinFnIdBswap, "bswap", 1);
+    create_builtin_fn(g, BuiltinFnIdPopCount, "popCount", 1);
+    create_builtin_fn(g, BuiltinFnIdBitReverse, "bitReverse", 1);
+    create_builtin_fn(g, BuiltinFnIdRotl, "rotl", 2);
+    create_builtin_fn(g, BuiltinFnIdRotr, "rotr", 2);
+    create_builtin_fn(g, BuiltinFnIdVectorType, "Vector", 2);
+    create_builtin_fn(g, BuiltinFnIdSplat, "splat", 2);
+    create_builtin_fn(g, BuiltinFnIdShuffle, "shuffle", 3);
+    create_builtin_fn(g, BuiltinFnIdSelect, "select", 3);
+    create_builtin_fn(g, BuiltinFnIdReduce, "reduce", 2);
     create_builtin_fn(g, BuiltinFnIdClz, "clz", 1);
     create_builtin_fn(g, BuiltinFnIdImport, "import", 1);
     create_builtin_fn(g, BuiltinFnIdCImport, "cImport", 1);
@@ -4041,6 +4390,7 @@ static void define_builtin_fns(CodeGen *g) {
     create_builtin_fn(g, BuiltinFnIdSetFnTest, "setFnTest", 1);
     create_builtin_fn(g, BuiltinFnIdSetFnVisible, "setFnVisible", 2);
     create_builtin_fn(g, BuiltinFnIdSetDebugSafety, "setDebugSafety", 2);
+    create_builtin_fn(g, BuiltinFnIdSetFastMath, "setFastMath", 2);
     create_builtin_fn(g, BuiltinFnIdAlloca, "alloca", 2);
     create_builtin_fn(g, BuiltinFnIdSetGlobalAlign, "setGlobalAlign", 2);
     create_builtin_fn(g, BuiltinFnIdSetGlobalSection, "setGlobalSection", 2);
@@ -4091,8 +4441,6 @@ static void init(CodeGen *g, Buf *source_path) {
     g->builder = LLVMCreateBuilder();
     g->dbuilder = ZigLLVMCreateDIBuilder(g->module, true);
 
-    ZigLLVMSetFastMath(g->builder, true);
-
 
     Buf *producer = buf_sprintf("zig %s", ZIG_VERSION_STRING);
     bool is_optimized = g->is_release_build;
@@ -4328,6 +4676,7 @@ static void get_c_type(CodeGen *g, TypeTableEntry *type_entry, Buf *out_buf) {
                 }
             }
         case TypeTableEntryIdArray:
+        case TypeTableEntryIdVector:
         case TypeTableEntryIdStruct:
         case TypeTableEntryIdErrorUnion:
         case TypeTableEntryIdPureError:
@@ -44,6 +44,9 @@ void codegen_set_rdynamic(CodeGen *g, bool rdynamic);
 void codegen_set_mmacosx_version_min(CodeGen *g, Buf *mmacosx_version_min);
 void codegen_set_mios_version_min(CodeGen *g, Buf *mios_version_min);
 void codegen_set_linker_script(CodeGen *g, const char *linker_script);
+void codegen_set_opt_remarks_path(CodeGen *g, Buf *opt_remarks_path);
+void codegen_set_emit(CodeGen *g, bool emit_asm, bool emit_llvm_ir, bool emit_llvm_bc);
+void codegen_set_verify_llvm(CodeGen *g, bool verify_llvm);
 
 void codegen_add_root_code(CodeGen *g, Buf *source_dir, Buf *source_basename, Buf *source_code);
 
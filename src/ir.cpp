@@ -294,6 +294,10 @@ static constexpr IrInstructionId ir_instruction_id(IrInstructionSetDebugSafety *
     return IrInstructionIdSetDebugSafety;
 }
 
+static constexpr IrInstructionId ir_instruction_id(IrInstructionSetFastMath *) {
+    return IrInstructionIdSetFastMath;
+}
+
 static constexpr IrInstructionId ir_instruction_id(IrInstructionArrayType *) {
     return IrInstructionIdArrayType;
 }
@@ -330,6 +334,42 @@ static constexpr IrInstructionId ir_instruction_id(IrInstructionCtz *) {
     return IrInstructionIdCtz;
 }
 
+static constexpr IrInstructionId ir_instruction_id(IrInstructionBswap *) {
+    return IrInstructionIdBswap;
+}
+
+static constexpr IrInstructionId ir_instruction_id(IrInstructionPopCount *) {
+    return IrInstructionIdPopCount;
+}
+
+static constexpr IrInstructionId ir_instruction_id(IrInstructionBitReverse *) {
+    return IrInstructionIdBitReverse;
+}
+
+static constexpr IrInstructionId ir_instruction_id(IrInstructionRotate *) {
+    return IrInstructionIdRotate;
+}
+
+static constexpr IrInstructionId ir_instruction_id(IrInstructionVectorType *) {
+    return IrInstructionIdVectorType;
+}
+
+static constexpr IrInstructionId ir_instruction_id(IrInstructionSplat *) {
+    return IrInstructionIdSplat;
+}
+
+static constexpr IrInstructionId ir_instruction_id(IrInstructionShuffle *) {
+    return IrInstructionIdShuffle;
+}
+
+static constexpr IrInstructionId ir_instruction_id(IrInstructionSelect *) {
+    return IrInstructionIdSelect;
+}
+
+static constexpr IrInstructionId ir_instruction_id(IrInstructionReduce *) {
+    return IrInstructionIdReduce;
+}
+
 static constexpr IrInstructionId ir_instruction_id(IrInstructionEnumTag *) {
     return IrInstructionIdEnumTag;
 }
@@ -1194,6 +1234,19 @@ static IrInstruction *ir_build_set_debug_safety(IrBuilder *irb, Scope *scope, As
     return &instruction->base;
 }
 
+static IrInstruction *ir_build_set_fast_math(IrBuilder *irb, Scope *scope, AstNode *source_node,
+        IrInstruction *scope_value, IrInstruction *fast_math_on)
+{
+    IrInstructionSetFastMath *instruction = ir_build_instruction<IrInstructionSetFastMath>(irb, scope, source_node);
+    instruction->scope_value = scope_value;
+    instruction->fast_math_on = fast_math_on;
+
+    ir_ref_instruction(scope_value, irb->current_basic_block);
+    ir_ref_instruction(fast_math_on, irb->current_basic_block);
+
+    return &instruction->base;
+}
+
 static IrInstruction *ir_build_array_type(IrBuilder *irb, Scope *scope, AstNode *source_node, IrInstruction *size,
         IrInstruction *child_type)
 {
@@ -1366,6 +1419,180 @@ static IrInstruction *ir_build_ctz_from(IrBuilder *irb, IrInstruction *old_instr
     return new_instruction;
 }
 
+static IrInstruction *ir_build_bswap(IrBuilder *irb, Scope *scope, AstNode *source_node, IrInstruction *value) {
+    IrInstructionBswap *instruction = ir_build_instruction<IrInstructionBswap>(irb, scope, source_node);
+    instruction->value = value;
+
+    ir_ref_instruction(value, irb->current_basic_block);
+
+    return &instruction->base;
+}
+
+static IrInstruction *ir_build_bswap_from(IrBuilder *irb, IrInstruction *old_instruction, IrInstruction *value) {
+    IrInstruction *new_instruction = ir_build_bswap(irb, old_instruction->scope, old_instruction->source_node, value);
+    ir_link_new_instruction(new_instruction, old_instruction);
+    return new_instruction;
+}
+
+static IrInstruction *ir_build_pop_count(IrBuilder *irb, Scope *scope, AstNode *source_node, IrInstruction *value) {
+    IrInstructionPopCount *instruction = ir_build_instruction<IrInstructionPopCount>(irb, scope, source_node);
+    instruction->value = value;
+
+    ir_ref_instruction(value, irb->current_basic_block);
+
+    return &instruction->base;
+}
+
+static IrInstruction *ir_build_pop_count_from(IrBuilder *irb, IrInstruction *old_instruction, IrInstruction *value) {
+    IrInstruction *new_instruction = ir_build_pop_count(irb, old_instruction->scope, old_instruction->source_node, value);
+    ir_link_new_instruction(new_instruction, old_instruction);
+    return new_instruction;
+}
+
+static IrInstruction *ir_build_bit_reverse(IrBuilder *irb, Scope *scope, AstNode *source_node, IrInstruction *value) {
+    IrInstructionBitReverse *instruction = ir_build_instruction<IrInstructionBitReverse>(irb, scope, source_node);
+    instruction->value = value;
+
+    ir_ref_instruction(value, irb->current_basic_block);
+
+    return &instruction->base;
+}
+
+static IrInstruction *ir_build_bit_reverse_from(IrBuilder *irb, IrInstruction *old_instruction, IrInstruction *value) {
+    IrInstruction *new_instruction = ir_build_bit_reverse(irb, old_instruction->scope, old_instruction->source_node, value);
+    ir_link_new_instruction(new_instruction, old_instruction);
+    return new_instruction;
+}
+
+static IrInstruction *ir_build_rotate(IrBuilder *irb, Scope *scope, AstNode *source_node, IrInstruction *value,
+        IrInstruction *amount, bool is_left)
+{
+    IrInstructionRotate *instruction = ir_build_instruction<IrInstructionRotate>(irb, scope, source_node);
+    instruction->value = value;
+    instruction->amount = amount;
+    instruction->is_left = is_left;
+
+    ir_ref_instruction(value, irb->current_basic_block);
+    ir_ref_instruction(amount, irb->current_basic_block);
+
+    return &instruction->base;
+}
+
+static IrInstruction *ir_build_rotate_from(IrBuilder *irb, IrInstruction *old_instruction, IrInstruction *value,
+        IrInstruction *amount, bool is_left)
+{
+    IrInstruction *new_instruction = ir_build_rotate(irb, old_instruction->scope, old_instruction->source_node,
+            value, amount, is_left);
+    ir_link_new_instruction(new_instruction, old_instruction);
+    return new_instruction;
+}
+
+static IrInstruction *ir_build_vector_type(IrBuilder *irb, Scope *scope, AstNode *source_node, IrInstruction *len,
+        IrInstruction *elem_type)
+{
+    IrInstructionVectorType *instruction = ir_build_instruction<IrInstructionVectorType>(irb, scope, source_node);
+    instruction->len = len;
+    instruction->elem_type = elem_type;
+
+    ir_ref_instruction(len, irb->current_basic_block);
+    ir_ref_instruction(elem_type, irb->current_basic_block);
+
+    return &instruction->base;
+}
+
+static IrInstruction *ir_build_splat(IrBuilder *irb, Scope *scope, AstNode *source_node, IrInstruction *vector_type,
+        IrInstruction *value)
+{
+    IrInstructionSplat *instruction = ir_build_instruction<IrInstructionSplat>(irb, scope, source_node);
+    instruction->vector_type = vector_type;
+    instruction->value = value;
+
+    ir_ref_instruction(vector_type, irb->current_basic_block);
+    ir_ref_instruction(value, irb->current_basic_block);
+
+    return &instruction->base;
+}
+
+static IrInstruction *ir_build_splat_from(IrBuilder *irb, IrInstruction *old_instruction, IrInstruction *vector_type,
+        IrInstruction *value)
+{
+    IrInstruction *new_instruction = ir_build_splat(irb, old_instruction->scope, old_instruction->source_node,
+            vector_type, value);
+    ir_link_new_instruction(new_instruction, old_instruction);
+    return new_instruction;
+}
+
+static IrInstruction *ir_build_shuffle(IrBuilder *irb, Scope *scope, AstNode *source_node, IrInstruction *a,
+        IrInstruction *b, IrInstruction *mask)
+{
+    IrInstructionShuffle *instruction = ir_build_instruction<IrInstructionShuffle>(irb, scope, source_node);
+    instruction->a = a;
+    instruction->b = b;
+    instruction->mask = mask;
+
+    ir_ref_instruction(a, irb->current_basic_block);
+    ir_ref_instruction(b, irb->current_basic_block);
+    ir_ref_instruction(mask, irb->current_basic_block);
+
+    return &instruction->base;
+}
+
+static IrInstruction *ir_build_shuffle_from(IrBuilder *irb, IrInstruction *old_instruction, IrInstruction *a,
+        IrInstruction *b, IrInstruction *mask)
+{
+    IrInstruction *new_instruction = ir_build_shuffle(irb, old_instruction->scope, old_instruction->source_node,
+            a, b, mask);
+    ir_link_new_instruction(new_instruction, old_instruction);
+    return new_instruction;
+}
+
+static IrInstruction *ir_build_select(IrBuilder *irb, Scope *scope, AstNode *source_node, IrInstruction *mask,
+        IrInstruction *a, IrInstruction *b)
+{
+    IrInstructionSelect *instruction = ir_build_instruction<IrInstructionSelect>(irb, scope, source_node);
+    instruction->mask = mask;
+    instruction->a = a;
+    instruction->b = b;
+
+    ir_ref_instruction(mask, irb->current_basic_block);
+    ir_ref_instruction(a, irb->current_basic_block);
+    ir_ref_instruction(b, irb->current_basic_block);
+
+    return &instruction->base;
+}
+
+static IrInstruction *ir_build_select_from(IrBuilder *irb, IrInstruction *old_instruction, IrInstruction *mask,
+        IrInstruction *a, IrInstruction *b)
+{
+    IrInstruction *new_instruction = ir_build_select(irb, old_instruction->scope, old_instruction->source_node,
+            mask, a, b);
+    ir_link_new_instruction(new_instruction, old_instruction);
+    return new_instruction;
+}
+
+static IrInstruction *ir_build_reduce(IrBuilder *irb, Scope *scope, AstNode *source_node, IrInstruction *op_value,
+        IrInstruction *value, ReduceOp op)
+{
+    IrInstructionReduce *instruction = ir_build_instruction<IrInstructionReduce>(irb, scope, source_node);
+    instruction->op_value = op_value;
+    instruction->value = value;
+    instruction->op = op;
+
+    ir_ref_instruction(op_value, irb->current_basic_block);
+    ir_ref_instruction(value, irb->current_basic_block);
+
+    return &instruction->base;
+}
+
+static IrInstruction *ir_build_reduce_from(IrBuilder *irb, IrInstruction *old_instruction, IrInstruction *op_value,
+        IrInstruction *value, ReduceOp op)
+{
+    IrInstruction *new_instruction = ir_build_reduce(irb, old_instruction->scope, old_instruction->source_node,
+            op_value, value, op);
+    ir_link_new_instruction(new_instruction, old_instruction);
+    return new_instruction;
+}
+
 static IrInstruction *ir_build_switch_br(IrBuilder *irb, Scope *scope, AstNode *source_node, IrInstruction *target_value,
         IrBasicBlock *else_block, size_t case_count, IrInstructionSwitchBrCase *cases, IrInstruction *is_comptime)
 {
@@ -2320,6 +2547,14 @@ static IrInstruction *ir_instruction_setdebugsafety_get_dep(IrInstructionSetDebu
     }
 }
 
+static IrInstruction *ir_instruction_setfastmath_get_dep(IrInstructionSetFastMath *instruction, size_t index) {
+    switch (index) {
+        case 0: return instruction->scope_value;
+        case 1: return instruction->fast_math_on;
+        default: return nullptr;
+    }
+}
+
 static IrInstruction *ir_instruction_arraytype_get_dep(IrInstructionArrayType *instruction, size_t index) {
     switch (index) {
         case 0: return instruction->size;
@@ -2399,6 +2634,77 @@ static IrInstruction *ir_instruction_ctz_get_dep(IrInstructionCtz *instruction,
     }
 }
 
+static IrInstruction *ir_instruction_bswap_get_dep(IrInstructionBswap *instruction, size_t index) {
+    switch (index) {
+        case 0: return instruction->value;
+        default: return nullptr;
+    }
+}
+
+static IrInstruction *ir_instruction_popcount_get_dep(IrInstructionPopCount *instruction, size_t index) {
+    switch (index) {
+        case 0: return instruction->value;
+        default: return nullptr;
+    }
+}
+
+static IrInstruction *ir_instruction_bitreverse_get_dep(IrInstructionBitReverse *instruction, size_t index) {
+    switch (index) {
+        case 0: return instruction->value;
+        default: return nullptr;
+    }
+}
+
+static IrInstruction *ir_instruction_rotate_get_dep(IrInstructionRotate *instruction, size_t index) {
+    switch (index) {
+        case 0: return instruction->value;
+        case 1: return instruction->amount;
+        default: return nullptr;
+    }
+}
+
+static IrInstruction *ir_instruction_vectortype_get_dep(IrInstructionVectorType *instruction, size_t index) {
+    switch (index) {
+        case 0: return instruction->len;
+        case 1: return instruction->elem_type;
+        default: return nullptr;
+    }
+}
+
+static IrInstruction *ir_instruction_splat_get_dep(IrInstructionSplat *instruction, size_t index) {
+    switch (index) {
+        case 0: return instruction->vector_type;
+        case 1: return instruction->value;
+        default: return nullptr;
+    }
+}
+
+static IrInstruction *ir_instruction_shuffle_get_dep(IrInstructionShuffle *instruction, size_t index) {
+    switch (index) {
+        case 0: return instruction->a;
+        case 1: return instruction->b;
+        case 2: return instruction->mask;
+        default: return nullptr;
+    }
+}
+
+static IrInstruction *ir_instruction_select_get_dep(IrInstructionSelect *instruction, size_t index) {
+    switch (index) {
+        case 0: return instruction->mask;
+        case 1: return instruction->a;
+        case 2: return instruction->b;
+        default: return nullptr;
+    }
+}
+
+static IrInstruction *ir_instruction_reduce_get_dep(IrInstructionReduce *instruction, size_t index) {
+    switch (index) {
+        case 0: return instruction->op_value;
+        case 1: return instruction->value;
+        default: return nullptr;
+    }
+}
+
 static IrInstruction *ir_instruction_generatedcode_get_dep(IrInstructionGeneratedCode *instruction, size_t index) {
     switch (index) {
         case 0: return instruction->value;
@@ -2823,6 +3129,8 @@ static IrInstruction *ir_instruction_get_dep(IrInstruction *instruction, size_t
             return ir_instruction_setfnvisible_get_dep((IrInstructionSetFnVisible *) instruction, index);
         case IrInstructionIdSetDebugSafety:
             return ir_instruction_setdebugsafety_get_dep((IrInstructionSetDebugSafety *) instruction, index);
+        case IrInstructionIdSetFastMath:
+            return ir_instruction_setfastmath_get_dep((IrInstructionSetFastMath *) instruction, index);
         case IrInstructionIdArrayType:
             return ir_instruction_arraytype_get_dep((IrInstructionArrayType *) instruction, index);
         case IrInstructionIdSliceType:
@@ -2845,6 +3153,24 @@ static IrInstruction *ir_instruction_get_dep(IrInstruction *instruction, size_t
             return ir_instruction_clz_get_dep((IrInstructionClz *) instruction, index);
         case IrInstructionIdCtz:
             return ir_instruction_ctz_get_dep((IrInstructionCtz *) instruction, index);
+        case IrInstructionIdBswap:
+            return ir_instruction_bswap_get_dep((IrInstructionBswap *) instruction, index);
+        case IrInstructionIdPopCount:
+            return ir_instruction_popcount_get_dep((IrInstructionPopCount *) instruction, index);
+        case IrInstructionIdBitReverse:
+            return ir_instruction_bitreverse_get_dep((IrInstructionBitReverse *) instruction, index);
+        case IrInstructionIdRotate:
+            return ir_instruction_rotate_get_dep((IrInstructionRotate *) instruction, index);
+        case IrInstructionIdVectorType:
+            return ir_instruction_vectortype_get_dep((IrInstructionVectorType *) instruction, index);
+        case IrInstructionIdSplat:
+            return ir_instruction_splat_get_dep((IrInstructionSplat *) instruction, index);
+        case IrInstructionIdShuffle:
+            return ir_instruction_shuffle_get_dep((IrInstructionShuffle *) instruction, index);
+        case IrInstructionIdSelect:
+            return ir_instruction_select_get_dep((IrInstructionSelect *) instruction, index);
+        case IrInstructionIdReduce:
+            return ir_instruction_reduce_get_dep((IrInstructionReduce *) instruction, index);
         case IrInstructionIdGeneratedCode:
             return ir_instruction_generatedcode_get_dep((IrInstructionGeneratedCode *) instruction, index);
         case IrInstructionIdImport:
@@ -3857,6 +4183,20 @@ static IrInstruction *ir_gen_builtin_fn_call(IrBuilder *irb, Scope *scope, AstNo
 
                 return ir_build_set_debug_safety(irb, scope, node, arg0_value, arg1_value);
             }
+        case BuiltinFnIdSetFastMath:
+            {
+                AstNode *arg0_node = node->data.fn_call_expr.params.at(0);
+                IrInstruction *arg0_value = ir_gen_node(irb, arg0_node, scope);
+                if (arg0_value == irb->codegen->invalid_instruction)
+                    return arg0_value;
+
+                AstNode *arg1_node = node->data.fn_call_expr.params.at(1);
+                IrInstruction *arg1_value = ir_gen_node(irb, arg1_node, scope);
+                if (arg1_value == irb->codegen->invalid_instruction)
+                    return arg1_value;
+
+                return ir_build_set_fast_math(irb, scope, node, arg0_value, arg1_value);
+            }
         case BuiltinFnIdCompileVar:
             {
                 AstNode *arg0_node = node->data.fn_call_expr.params.at(0);
@@ -3884,52 +4224,50 @@ static IrInstruction *ir_gen_builtin_fn_call(IrBuilder *irb, Scope *scope, AstNo
 
                 return ir_build_ctz(irb, scope, node, arg0_value);
             }
-        case BuiltinFnIdClz:
+        case BuiltinFnIdBswap:
             {
                 AstNode *arg0_node = node->data.fn_call_expr.params.at(0);
                 IrInstruction *arg0_value = ir_gen_node(irb, arg0_node, scope);
                 if (arg0_value == irb->codegen->invalid_instruction)
                     return arg0_value;
 
-                return ir_build_clz(irb, scope, node, arg0_value);
+                return ir_build_bswap(irb, scope, node, arg0_value);
             }
-        case BuiltinFnIdGeneratedCode:
+        case BuiltinFnIdPopCount:
             {
                 AstNode *arg0_node = node->data.fn_call_expr.params.at(0);
                 IrInstruction *arg0_value = ir_gen_node(irb, arg0_node, scope);
                 if (arg0_value == irb->codegen->invalid_instruction)
                     return arg0_value;
 
-                return ir_build_generated_code(irb, scope, node, arg0_value);
+                return ir_build_pop_count(irb, scope, node, arg0_value);
             }
-        case BuiltinFnIdImport:
+        case BuiltinFnIdBitReverse:
             {
                 AstNode *arg0_node = node->data.fn_call_expr.params.at(0);
                 IrInstruction *arg0_value = ir_gen_node(irb, arg0_node, scope);
                 if (arg0_value == irb->codegen->invalid_instruction)
                     return arg0_value;
 
-                return ir_build_import(irb, scope, node, arg0_value);
-            }
-        case BuiltinFnIdCImport:
-            {
-                return ir_build_c_import(irb, scope, node);
+                return ir_build_bit_reverse(irb, scope, node, arg0_value);
             }
-        case BuiltinFnIdCInclude:
+        case BuiltinFnIdRotl:
+        case BuiltinFnIdRotr:
             {
                 AstNode *arg0_node = node->data.fn_call_expr.params.at(0);
                 IrInstruction *arg0_value = ir_gen_node(irb, arg0_node, scope);
                 if (arg0_value == irb->codegen->invalid_instruction)
                     return arg0_value;
 
-                if (!exec_c_import_buf(irb->exec)) {
-                    add_node_error(irb->codegen, node, buf_sprintf("C include valid only inside C import block"));
-                    return irb->codegen->invalid_instruction;
-                }
+                AstNode *arg1_node = node->data.fn_call_expr.params.at(1);
+                IrInstruction *arg1_value = ir_gen_node(irb, arg1_node, scope);
+                if (arg1_value == irb->codegen->invalid_instruction)
+                    return arg1_value;
 
-                return ir_build_c_include(irb, scope, node, arg0_value);
+                bool is_left = (builtin_fn->id == BuiltinFnIdRotl);
+                return ir_build_rotate(irb, scope, node, arg0_value, arg1_value, is_left);
             }
-        case BuiltinFnIdCDefine:
+        case BuiltinFnIdVectorType:
             {
                 AstNode *arg0_node = node->data.fn_call_expr.params.at(0);
                 IrInstruction *arg0_value = ir_gen_node(irb, arg0_node, scope);
@@ -3941,49 +4279,174 @@ static IrInstruction *ir_gen_builtin_fn_call(IrBuilder *irb, Scope *scope, AstNo
                 if (arg1_value == irb->codegen->invalid_instruction)
                     return arg1_value;
 
-                if (!exec_c_import_buf(irb->exec)) {
-                    add_node_error(irb->codegen, node, buf_sprintf("C define valid only inside C import block"));
-                    return irb->codegen->invalid_instruction;
-                }
-
-                return ir_build_c_define(irb, scope, node, arg0_value, arg1_value);
+                return ir_build_vector_type(irb, scope, node, arg0_value, arg1_value);
             }
-        case BuiltinFnIdCUndef:
+        case BuiltinFnIdSplat:
             {
                 AstNode *arg0_node = node->data.fn_call_expr.params.at(0);
                 IrInstruction *arg0_value = ir_gen_node(irb, arg0_node, scope);
                 if (arg0_value == irb->codegen->invalid_instruction)
                     return arg0_value;
 
-                if (!exec_c_import_buf(irb->exec)) {
-                    add_node_error(irb->codegen, node, buf_sprintf("C undef valid only inside C import block"));
-                    return irb->codegen->invalid_instruction;
-                }
+                AstNode *arg1_node = node->data.fn_call_expr.params.at(1);
+                IrInstruction *arg1_value = ir_gen_node(irb, arg1_node, scope);
+                if (arg1_value == irb->codegen->invalid_instruction)
+                    return arg1_value;
 
-                return ir_build_c_undef(irb, scope, node, arg0_value);
+                return ir_build_splat(irb, scope, node, arg0_value, arg1_value);
             }
-        case BuiltinFnIdMaxValue:
+        case BuiltinFnIdShuffle:
             {
                 AstNode *arg0_node = node->data.fn_call_expr.params.at(0);
                 IrInstruction *arg0_value = ir_gen_node(irb, arg0_node, scope);
                 if (arg0_value == irb->codegen->invalid_instruction)
                     return arg0_value;
 
-                return ir_build_max_value(irb, scope, node, arg0_value);
+                AstNode *arg1_node = node->data.fn_call_expr.params.at(1);
+                IrInstruction *arg1_value = ir_gen_node(irb, arg1_node, scope);
+                if (arg1_value == irb->codegen->invalid_instruction)
+                    return arg1_value;
+
+                AstNode *arg2_node = node->data.fn_call_expr.params.at(2);
+                IrInstruction *arg2_value = ir_gen_node(irb, arg2_node, scope);
+                if (arg2_value == irb->codegen->invalid_instruction)
+                    return arg2_value;
+
+                return ir_build_shuffle(irb, scope, node, arg0_value, arg1_value, arg2_value);
             }
-        case BuiltinFnIdMinValue:
+        case BuiltinFnIdSelect:
             {
                 AstNode *arg0_node = node->data.fn_call_expr.params.at(0);
                 IrInstruction *arg0_value = ir_gen_node(irb, arg0_node, scope);
                 if (arg0_value == irb->codegen->invalid_instruction)
                     return arg0_value;
 
-                return ir_build_min_value(irb, scope, node, arg0_value);
-            }
-        case BuiltinFnIdCompileErr:
-            {
-                AstNode *arg0_node = node->data.fn_call_expr.params.at(0);
-                IrInstruction *arg0_value = ir_gen_node(irb, arg0_node, scope);
+                AstNode *arg1_node = node->data.fn_call_expr.params.at(1);
+                IrInstruction *arg1_value = ir_gen_node(irb, arg1_node, scope);
+                if (arg1_value == irb->codegen->invalid_instruction)
+                    return arg1_value;
+
+                AstNode *arg2_node = node->data.fn_call_expr.params.at(2);
+                IrInstruction *arg2_value = ir_gen_node(irb, arg2_node, scope);
+                if (arg2_value == irb->codegen->invalid_instruction)
+                    return arg2_value;
+
+                return ir_build_select(irb, scope, node, arg0_value, arg1_value, arg2_value);
+            }
+        case BuiltinFnIdReduce:
+            {
+                AstNode *arg0_node = node->data.fn_call_expr.params.at(0);
+                IrInstruction *arg0_value = ir_gen_node(irb, arg0_node, scope);
+                if (arg0_value == irb->codegen->invalid_instruction)
+                    return arg0_value;
+
+                AstNode *arg1_node = node->data.fn_call_expr.params.at(1);
+                IrInstruction *arg1_value = ir_gen_node(irb, arg1_node, scope);
+                if (arg1_value == irb->codegen->invalid_instruction)
+                    return arg1_value;
+
+                return ir_build_reduce(irb, scope, node, arg0_value, arg1_value, ReduceOpAdd);
+            }
+        case BuiltinFnIdClz:
+            {
+                AstNode *arg0_node = node->data.fn_call_expr.params.at(0);
+                IrInstruction *arg0_value = ir_gen_node(irb, arg0_node, scope);
+                if (arg0_value == irb->codegen->invalid_instruction)
+                    return arg0_value;
+
+                return ir_build_clz(irb, scope, node, arg0_value);
+            }
+        case BuiltinFnIdGeneratedCode:
+            {
+                AstNode *arg0_node = node->data.fn_call_expr.params.at(0);
+                IrInstruction *arg0_value = ir_gen_node(irb, arg0_node, scope);
+                if (arg0_value == irb->codegen->invalid_instruction)
+                    return arg0_value;
+
+                return ir_build_generated_code(irb, scope, node, arg0_value);
+            }
+        case BuiltinFnIdImport:
+            {
+                AstNode *arg0_node = node->data.fn_call_expr.params.at(0);
+                IrInstruction *arg0_value = ir_gen_node(irb, arg0_node, scope);
+                if (arg0_value == irb->codegen->invalid_instruction)
+                    return arg0_value;
+
+                return ir_build_import(irb, scope, node, arg0_value);
+            }
+        case BuiltinFnIdCImport:
+            {
+                return ir_build_c_import(irb, scope, node);
+            }
+        case BuiltinFnIdCInclude:
+            {
+                AstNode *arg0_node = node->data.fn_call_expr.params.at(0);
+                IrInstruction *arg0_value = ir_gen_node(irb, arg0_node, scope);
+                if (arg0_value == irb->codegen->invalid_instruction)
+                    return arg0_value;
+
+                if (!exec_c_import_buf(irb->exec)) {
+                    add_node_error(irb->codegen, node, buf_sprintf("C include valid only inside C import block"));
+                    return irb->codegen->invalid_instruction;
+                }
+
+                return ir_build_c_include(irb, scope, node, arg0_value);
+            }
+        case BuiltinFnIdCDefine:
+            {
+                AstNode *arg0_node = node->data.fn_call_expr.params.at(0);
+                IrInstruction *arg0_value = ir_gen_node(irb, arg0_node, scope);
+                if (arg0_value == irb->codegen->invalid_instruction)
+                    return arg0_value;
+
+                AstNode *arg1_node = node->data.fn_call_expr.params.at(1);
+                IrInstruction *arg1_value = ir_gen_node(irb, arg1_node, scope);
+                if (arg1_value == irb->codegen->invalid_instruction)
+                    return arg1_value;
+
+                if (!exec_c_import_buf(irb->exec)) {
+                    add_node_error(irb->codegen, node, buf_sprintf("C define valid only inside C import block"));
+                    return irb->codegen->invalid_instruction;
+                }
+
+                return ir_build_c_define(irb, scope, node, arg0_value, arg1_value);
+            }
+        case BuiltinFnIdCUndef:
+            {
+                AstNode *arg0_node = node->data.fn_call_expr.params.at(0);
+                IrInstruction *arg0_value = ir_gen_node(irb, arg0_node, scope);
+                if (arg0_value == irb->codegen->invalid_instruction)
+                    return arg0_value;
+
+                if (!exec_c_import_buf(irb->exec)) {
+                    add_node_error(irb->codegen, node, buf_sprintf("C undef valid only inside C import block"));
+                    return irb->codegen->invalid_instruction;
+                }
+
+                return ir_build_c_undef(irb, scope, node, arg0_value);
+            }
+        case BuiltinFnIdMaxValue:
+            {
+                AstNode *arg0_node = node->data.fn_call_expr.params.at(0);
+                IrInstruction *arg0_value = ir_gen_node(irb, arg0_node, scope);
+                if (arg0_value == irb->codegen->invalid_instruction)
+                    return arg0_value;
+
+                return ir_build_max_value(irb, scope, node, arg0_value);
+            }
+        case BuiltinFnIdMinValue:
+            {
+                AstNode *arg0_node = node->data.fn_call_expr.params.at(0);
+                IrInstruction *arg0_value = ir_gen_node(irb, arg0_node, scope);
+                if (arg0_value == irb->codegen->invalid_instruction)
+                    return arg0_value;
+
+                return ir_build_min_value(irb, scope, node, arg0_value);
+            }
+        case BuiltinFnIdCompileErr:
+            {
+                AstNode *arg0_node = node->data.fn_call_expr.params.at(0);
+                IrInstruction *arg0_value = ir_gen_node(irb, arg0_node, scope);
                 if (arg0_value == irb->codegen->invalid_instruction)
                     return arg0_value;
 
@@ -6046,6 +6509,24 @@ static void eval_const_expr_implicit_cast(CastOp cast_op,
             bignum_init_unsigned(&const_val->data.x_bignum, other_val->data.x_bool ? 1 : 0);
             const_val->special = ConstValSpecialStatic;
             break;
+        case CastOpArrayToVector:
+            if (other_val->special == ConstValSpecialStatic) {
+                uint32_t len = new_type->data.vector.len;
+                const_val->data.x_vector.elements = allocate<ConstExprValue>(len);
+                for (uint32_t i = 0; i < len; i += 1) {
+                    const_val->data.x_vector.elements[i] = other_val->data.x_array.elements[i];
+                }
+            }
+            break;
+        case CastOpVectorToArray:
+            if (other_val->special == ConstValSpecialStatic) {
+                uint32_t len = other_type->data.vector.len;
+                const_val->data.x_array.elements = allocate<ConstExprValue>(len);
+                for (uint32_t i = 0; i < len; i += 1) {
+                    const_val->data.x_array.elements[i] = other_val->data.x_vector.elements[i];
+                }
+            }
+            break;
     }
 }
 static IrInstruction *ir_resolve_cast(IrAnalyze *ira, IrInstruction *source_instr, IrInstruction *value,
@@ -6839,6 +7320,22 @@ static IrInstruction *ir_analyze_cast(IrAnalyze *ira, IrInstruction *source_inst
         }
     }
 
+    // explicit cast from [N]T to @Vector(N, T)
+    if (wanted_type->id == TypeTableEntryIdVector && actual_type->id == TypeTableEntryIdArray &&
+        actual_type->data.array.len == wanted_type->data.vector.len &&
+        types_match_const_cast_only(wanted_type->data.vector.elem_type, actual_type->data.array.child_type))
+    {
+        return ir_resolve_cast(ira, source_instr, value, wanted_type, CastOpArrayToVector, false);
+    }
+
+    // explicit cast from @Vector(N, T) to [N]T
+    if (wanted_type->id == TypeTableEntryIdArray && actual_type->id == TypeTableEntryIdVector &&
+        wanted_type->data.array.len == actual_type->data.vector.len &&
+        types_match_const_cast_only(wanted_type->data.array.child_type, actual_type->data.vector.elem_type))
+    {
+        return ir_resolve_cast(ira, source_instr, value, wanted_type, CastOpVectorToArray, true);
+    }
+
     // explicit cast from []T to []u8 or []u8 to []T
     if (is_slice(wanted_type) && is_slice(actual_type) &&
         (is_u8(wanted_type->data.structure.fields[slice_ptr_index].type_entry->data.pointer.child_type) ||
@@ -7054,6 +7551,104 @@ static IrInstruction *ir_implicit_cast(IrAnalyze *ira, IrInstruction *value, Typ
     zig_unreachable();
 }
 
+// Whether ptr_val points into an array of bytes but was cast to a pointer to
+// a bigger integer, as mem.eql does to compare a word at a time and
+// mem.readInt and mem.writeInt do to load and store one.
+static bool is_reinterpreted_byte_ptr(ConstExprValue *ptr_val, TypeTableEntry *child_type) {
+    if (ptr_val->data.x_ptr.special != ConstPtrSpecialBaseArray)
+        return false;
+    ConstExprValue *array_val = ptr_val->data.x_ptr.data.base_array.array_val;
+    TypeTableEntry *canon_child_type = get_underlying_type(child_type);
+    TypeTableEntry *canon_elem_type = get_underlying_type(array_val->type->data.array.child_type);
+    return canon_child_type->id == TypeTableEntryIdInt &&
+        canon_child_type->data.integral.bit_count > 8 &&
+        canon_child_type->data.integral.bit_count <= 64 &&
+        canon_child_type->data.integral.bit_count % 8 == 0 &&
+        canon_elem_type->id == TypeTableEntryIdInt &&
+        canon_elem_type->data.integral.bit_count == 8;
+}
+
+// Loads an integer at compile time through a reinterpreted byte pointer by
+// assembling it from the bytes, the same way the load would at runtime.
+static IrInstruction *ir_get_deref_bytes(IrAnalyze *ira, IrInstruction *source_instruction,
+        ConstExprValue *ptr_val, TypeTableEntry *child_type)
+{
+    ConstExprValue *array_val = ptr_val->data.x_ptr.data.base_array.array_val;
+    size_t elem_index = ptr_val->data.x_ptr.data.base_array.elem_index;
+    TypeTableEntry *canon_child_type = get_underlying_type(child_type);
+    uint32_t bit_count = canon_child_type->data.integral.bit_count;
+    size_t byte_count = bit_count / 8;
+    if (elem_index + byte_count > array_val->type->data.array.len) {
+        ir_add_error(ira, source_instruction, buf_sprintf("out of bounds pointer access"));
+        return ira->codegen->invalid_instruction;
+    }
+    if (array_val->special != ConstValSpecialStatic) {
+        ir_add_error(ira, source_instruction, buf_sprintf("use of undefined value"));
+        return ira->codegen->invalid_instruction;
+    }
+
+    uint64_t x = 0;
+    for (size_t i = 0; i < byte_count; i += 1) {
+        size_t byte_index = ira->codegen->is_big_endian ? i : (byte_count - 1 - i);
+        ConstExprValue *byte_val = &array_val->data.x_array.elements[elem_index + byte_index];
+        if (byte_val->special != ConstValSpecialStatic) {
+            ir_add_error(ira, source_instruction, buf_sprintf("use of undefined value"));
+            return ira->codegen->invalid_instruction;
+        }
+        x = (x << 8) | (bignum_to_twos_complement(&byte_val->data.x_bignum) & 0xff);
+    }
+
+    IrInstruction *result = ir_create_const(&ira->new_irb, source_instruction->scope,
+        source_instruction->source_node, child_type);
+    if (canon_child_type->data.integral.is_signed) {
+        if (bit_count < 64 && ((x >> (bit_count - 1)) & 0x1) != 0)
+            x |= UINT64_MAX << bit_count;
+        bignum_init_signed(&result->value.data.x_bignum, (int64_t)x);
+    } else {
+        bignum_init_unsigned(&result->value.data.x_bignum, x);
+    }
+    return result;
+}
+
+// Stores an integer at compile time through a reinterpreted byte pointer by
+// splitting it into the bytes, the same way the store would at runtime.
+static bool ir_set_deref_bytes(IrAnalyze *ira, IrInstruction *source_instruction,
+        ConstExprValue *ptr_val, TypeTableEntry *child_type, ConstExprValue *value)
+{
+    ConstExprValue *array_val = ptr_val->data.x_ptr.data.base_array.array_val;
+    size_t elem_index = ptr_val->data.x_ptr.data.base_array.elem_index;
+    size_t byte_count = get_underlying_type(child_type)->data.integral.bit_count / 8;
+    size_t array_len = array_val->type->data.array.len;
+    if (elem_index + byte_count > array_len) {
+        ir_add_error(ira, source_instruction, buf_sprintf("out of bounds pointer access"));
+        return false;
+    }
+    if (array_val->special == ConstValSpecialUndef) {
+        // the other bytes stay undefined
+        TypeTableEntry *elem_type = array_val->type->data.array.child_type;
+        array_val->special = ConstValSpecialStatic;
+        array_val->data.x_array.elements = allocate<ConstExprValue>(array_len);
+        for (size_t i = 0; i < array_len; i += 1) {
+            array_val->data.x_array.elements[i].special = ConstValSpecialUndef;
+            array_val->data.x_array.elements[i].type = elem_type;
+        }
+    }
+    if (value->special != ConstValSpecialStatic) {
+        ir_add_error(ira, source_instruction, buf_sprintf("use of undefined value"));
+        return false;
+    }
+
+    uint64_t x = bignum_to_twos_complement(&value->data.x_bignum);
+    for (size_t i = 0; i < byte_count; i += 1) {
+        size_t byte_index = ira->codegen->is_big_endian ? (byte_count - 1 - i) : i;
+        ConstExprValue *byte_val = &array_val->data.x_array.elements[elem_index + byte_index];
+        byte_val->special = ConstValSpecialStatic;
+        bignum_init_unsigned(&byte_val->data.x_bignum, x & 0xff);
+        x >>= 8;
+    }
+    return true;
+}
+
 static IrInstruction *ir_get_deref(IrAnalyze *ira, IrInstruction *source_instruction, IrInstruction *ptr) {
     TypeTableEntry *type_entry = ptr->value.type;
     if (type_is_invalid(type_entry)) {
@@ -7066,6 +7661,8 @@ static IrInstruction *ir_get_deref(IrAnalyze *ira, IrInstruction *source_instruc
             {
                 ConstExprValue *pointee = const_ptr_pointee(&ptr->value);
                 if (pointee->special != ConstValSpecialRuntime) {
+                    if (is_reinterpreted_byte_ptr(&ptr->value, child_type))
+                        return ir_get_deref_bytes(ira, source_instruction, &ptr->value, child_type);
                     IrInstruction *result = ir_create_const(&ira->new_irb, source_instruction->scope,
                         source_instruction->source_node, child_type);
                     result->value = *pointee;
@@ -7149,6 +7746,22 @@ static bool ir_resolve_comptime(IrAnalyze *ira, IrInstruction *value, bool *out)
     return ir_resolve_bool(ira, value, out);
 }
 
+static bool ir_resolve_reduce_op(IrAnalyze *ira, IrInstruction *value, ReduceOp *out) {
+    if (type_is_invalid(value->value.type))
+        return false;
+
+    IrInstruction *casted_value = ir_implicit_cast(ira, value, ira->codegen->builtin_types.entry_reduce_op_enum);
+    if (type_is_invalid(casted_value->value.type))
+        return false;
+
+    ConstExprValue *const_val = ir_resolve_const(ira, casted_value, UndefBad);
+    if (!const_val)
+        return false;
+
+    *out = (ReduceOp)const_val->data.x_enum.tag;
+    return true;
+}
+
 static bool ir_resolve_atomic_order(IrAnalyze *ira, IrInstruction *value, AtomicOrder *out) {
     if (type_is_invalid(value->value.type))
         return false;
@@ -7260,6 +7873,85 @@ static TypeTableEntry *ir_analyze_bin_op_bool(IrAnalyze *ira, IrInstructionBinOp
     return bool_type;
 }
 
+static bool ir_eval_bignum_cmp(IrBinOp op_id, BigNum *op1, BigNum *op2) {
+    switch (op_id) {
+        case IrBinOpCmpEq:
+            return bignum_cmp_eq(op1, op2);
+        case IrBinOpCmpNotEq:
+            return bignum_cmp_neq(op1, op2);
+        case IrBinOpCmpLessThan:
+            return bignum_cmp_lt(op1, op2);
+        case IrBinOpCmpGreaterThan:
+            return bignum_cmp_gt(op1, op2);
+        case IrBinOpCmpLessOrEq:
+            return bignum_cmp_lte(op1, op2);
+        case IrBinOpCmpGreaterOrEq:
+            return bignum_cmp_gte(op1, op2);
+        default:
+            zig_unreachable();
+    }
+}
+
+// Vectors compare elementwise, to a vector of bool.
+static TypeTableEntry *ir_analyze_bin_op_cmp_vector(IrAnalyze *ira, IrInstructionBinOp *bin_op_instruction,
+        TypeTableEntry *vector_type, IrInstruction *op1, IrInstruction *op2)
+{
+    IrBinOp op_id = bin_op_instruction->op_id;
+    bool is_equality_cmp = (op_id == IrBinOpCmpEq || op_id == IrBinOpCmpNotEq);
+    TypeTableEntry *elem_type = get_underlying_type(vector_type->data.vector.elem_type);
+    if (elem_type->id == TypeTableEntryIdBool && !is_equality_cmp) {
+        ir_add_error(ira, &bin_op_instruction->base,
+            buf_sprintf("operator not allowed for type '%s'", buf_ptr(&vector_type->name)));
+        return ira->codegen->builtin_types.entry_invalid;
+    }
+
+    uint32_t len = vector_type->data.vector.len;
+    TypeTableEntry *result_type = get_vector_type(ira->codegen, len, ira->codegen->builtin_types.entry_bool);
+
+    IrInstruction *casted_op1 = ir_implicit_cast(ira, op1, vector_type);
+    if (casted_op1 == ira->codegen->invalid_instruction)
+        return ira->codegen->builtin_types.entry_invalid;
+
+    IrInstruction *casted_op2 = ir_implicit_cast(ira, op2, vector_type);
+    if (casted_op2 == ira->codegen->invalid_instruction)
+        return ira->codegen->builtin_types.entry_invalid;
+
+    if (instr_is_comptime(casted_op1) && instr_is_comptime(casted_op2)) {
+        ConstExprValue *op1_val = ir_resolve_const(ira, casted_op1, UndefBad);
+        if (!op1_val)
+            return ira->codegen->builtin_types.entry_invalid;
+        ConstExprValue *op2_val = ir_resolve_const(ira, casted_op2, UndefBad);
+        if (!op2_val)
+            return ira->codegen->builtin_types.entry_invalid;
+
+        ConstExprValue *out_val = ir_build_const_from(ira, &bin_op_instruction->base);
+        out_val->data.x_vector.elements = allocate<ConstExprValue>(len);
+        for (uint32_t i = 0; i < len; i += 1) {
+            ConstExprValue *elem1 = &op1_val->data.x_vector.elements[i];
+            ConstExprValue *elem2 = &op2_val->data.x_vector.elements[i];
+            ConstExprValue *out_elem = &out_val->data.x_vector.elements[i];
+            out_elem->type = ira->codegen->builtin_types.entry_bool;
+            if (elem1->special == ConstValSpecialUndef || elem2->special == ConstValSpecialUndef) {
+                out_elem->special = ConstValSpecialUndef;
+                continue;
+            }
+            out_elem->special = ConstValSpecialStatic;
+            if (elem_type->id == TypeTableEntryIdBool) {
+                bool are_equal = (elem1->data.x_bool == elem2->data.x_bool);
+                out_elem->data.x_bool = (op_id == IrBinOpCmpEq) ? are_equal : !are_equal;
+            } else {
+                out_elem->data.x_bool = ir_eval_bignum_cmp(op_id, &elem1->data.x_bignum, &elem2->data.x_bignum);
+            }
+        }
+        return result_type;
+    }
+
+    ir_build_bin_op_from(&ira->new_irb, &bin_op_instruction->base, op_id,
+            casted_op1, casted_op2, bin_op_instruction->safety_check_on);
+
+    return result_type;
+}
+
 static TypeTableEntry *ir_analyze_bin_op_cmp(IrAnalyze *ira, IrInstructionBinOp *bin_op_instruction) {
     IrInstruction *op1 = bin_op_instruction->op1->other;
     IrInstruction *op2 = bin_op_instruction->op2->other;
@@ -7363,6 +8055,9 @@ static TypeTableEntry *ir_analyze_bin_op_cmp(IrAnalyze *ira, IrInstructionBinOp
         case TypeTableEntryIdEnumTag:
             zig_panic("TODO implement comparison for enum tag type");
 
+        case TypeTableEntryIdVector:
+            return ir_analyze_bin_op_cmp_vector(ira, bin_op_instruction, resolved_type, op1, op2);
+
         case TypeTableEntryIdVar:
             zig_unreachable();
     }
@@ -7384,24 +8079,7 @@ static TypeTableEntry *ir_analyze_bin_op_cmp(IrAnalyze *ira, IrInstructionBinOp
                 resolved_type->id == TypeTableEntryIdInt);
         bool answer;
         if (type_can_gt_lt_cmp) {
-            bool (*bignum_cmp)(BigNum *, BigNum *);
-            if (op_id == IrBinOpCmpEq) {
-                bignum_cmp = bignum_cmp_eq;
-            } else if (op_id == IrBinOpCmpNotEq) {
-                bignum_cmp = bignum_cmp_neq;
-            } else if (op_id == IrBinOpCmpLessThan) {
-                bignum_cmp = bignum_cmp_lt;
-            } else if (op_id == IrBinOpCmpGreaterThan) {
-                bignum_cmp = bignum_cmp_gt;
-            } else if (op_id == IrBinOpCmpLessOrEq) {
-                bignum_cmp = bignum_cmp_lte;
-            } else if (op_id == IrBinOpCmpGreaterOrEq) {
-                bignum_cmp = bignum_cmp_gte;
-            } else {
-                zig_unreachable();
-            }
-
-            answer = bignum_cmp(&op1_val->data.x_bignum, &op2_val->data.x_bignum);
+            answer = ir_eval_bignum_cmp(op_id, &op1_val->data.x_bignum, &op2_val->data.x_bignum);
         } else {
             bool are_equal = resolved_type->id == TypeTableEntryIdVoid || const_values_equal(op1_val, op2_val);
             if (op_id == IrBinOpCmpEq) {
@@ -7449,7 +8127,15 @@ static int ir_eval_bignum(ConstExprValue *op1_val, ConstExprValue *op2_val,
 
     bool overflow = bignum_fn(&out_val->data.x_bignum, &op1_val->data.x_bignum, &op2_val->data.x_bignum);
     if (overflow) {
-        return ErrorOverflow;
+        // For unsigned operands, bignum_add and bignum_mul leave the result
+        // modulo 2^64 behind, which is what a wrapping op on a 64 bit
+        // integer needs.
+        bool can_wrap = wrapping_op && type->id == TypeTableEntryIdInt && !type->data.integral.is_signed &&
+            (bignum_fn == bignum_add || bignum_fn == bignum_mul);
+        if (!can_wrap) {
+            return ErrorOverflow;
+        }
+        out_val->data.x_bignum.is_negative = false;
     }
 
     if (type->id == TypeTableEntryIdInt && !bignum_fits_in_bits(&out_val->data.x_bignum,
@@ -7522,39 +8208,123 @@ static int ir_eval_math_op(TypeTableEntry *canon_type, ConstExprValue *op1_val,
     zig_unreachable();
 }
 
-static TypeTableEntry *ir_analyze_bin_op_math(IrAnalyze *ira, IrInstructionBinOp *bin_op_instruction) {
-    IrInstruction *op1 = bin_op_instruction->op1->other;
-    IrInstruction *op2 = bin_op_instruction->op2->other;
-    IrInstruction *instructions[] = {op1, op2};
-    TypeTableEntry *resolved_type = ir_resolve_peer_types(ira, bin_op_instruction->base.source_node, instructions, 2);
-    if (type_is_invalid(resolved_type))
-        return resolved_type;
-    TypeTableEntry *canon_resolved_type = get_underlying_type(resolved_type);
+// Vectors operate elementwise. Integer vectors only get the operators which
+// need no safety check: the wrapping ones, the bitwise ones and >>.
+static TypeTableEntry *ir_analyze_bin_op_math_vector(IrAnalyze *ira, IrInstructionBinOp *bin_op_instruction,
+        TypeTableEntry *vector_type, IrInstruction *op1, IrInstruction *op2)
+{
     IrBinOp op_id = bin_op_instruction->op_id;
-
-    if (canon_resolved_type->id == TypeTableEntryIdInt ||
-        canon_resolved_type->id == TypeTableEntryIdNumLitInt)
-    {
-        // int
-    } else if ((canon_resolved_type->id == TypeTableEntryIdFloat ||
-                canon_resolved_type->id == TypeTableEntryIdNumLitFloat) &&
-        (op_id == IrBinOpAdd ||
+    TypeTableEntry *elem_type = get_underlying_type(vector_type->data.vector.elem_type);
+    bool op_allowed;
+    if (elem_type->id == TypeTableEntryIdInt) {
+        if (op_id == IrBinOpAdd || op_id == IrBinOpSub || op_id == IrBinOpMult) {
+            ir_add_error(ira, &bin_op_instruction->base,
+                buf_sprintf("arithmetic on '%s' must use a wrapping operator: '+%%', '-%%' or '*%%'",
+                    buf_ptr(&vector_type->name)));
+            return ira->codegen->builtin_types.entry_invalid;
+        }
+        op_allowed = (op_id == IrBinOpAddWrap ||
+            op_id == IrBinOpSubWrap ||
+            op_id == IrBinOpMultWrap ||
+            op_id == IrBinOpBinOr ||
+            op_id == IrBinOpBinXor ||
+            op_id == IrBinOpBinAnd ||
+            op_id == IrBinOpBitShiftLeftWrap ||
+            op_id == IrBinOpBitShiftRight);
+    } else if (elem_type->id == TypeTableEntryIdFloat) {
+        op_allowed = (op_id == IrBinOpAdd ||
             op_id == IrBinOpSub ||
             op_id == IrBinOpMult ||
             op_id == IrBinOpDiv ||
-            op_id == IrBinOpMod))
-    {
-        // float
+            op_id == IrBinOpMod);
     } else {
-        AstNode *source_node = bin_op_instruction->base.source_node;
-        ir_add_error_node(ira, source_node,
+        op_allowed = false;
+    }
+    if (!op_allowed) {
+        ir_add_error(ira, &bin_op_instruction->base,
             buf_sprintf("invalid operands to binary expression: '%s' and '%s'",
                 buf_ptr(&op1->value.type->name),
                 buf_ptr(&op2->value.type->name)));
         return ira->codegen->builtin_types.entry_invalid;
     }
 
-    IrInstruction *casted_op1 = ir_implicit_cast(ira, op1, resolved_type);
+    IrInstruction *casted_op1 = ir_implicit_cast(ira, op1, vector_type);
+    if (casted_op1 == ira->codegen->invalid_instruction)
+        return ira->codegen->builtin_types.entry_invalid;
+
+    IrInstruction *casted_op2 = ir_implicit_cast(ira, op2, vector_type);
+    if (casted_op2 == ira->codegen->invalid_instruction)
+        return ira->codegen->builtin_types.entry_invalid;
+
+    if (instr_is_comptime(casted_op1) && instr_is_comptime(casted_op2)) {
+        ConstExprValue *op1_val = ir_resolve_const(ira, casted_op1, UndefBad);
+        if (!op1_val)
+            return ira->codegen->builtin_types.entry_invalid;
+        ConstExprValue *op2_val = ir_resolve_const(ira, casted_op2, UndefBad);
+        if (!op2_val)
+            return ira->codegen->builtin_types.entry_invalid;
+
+        uint32_t len = vector_type->data.vector.len;
+        ConstExprValue *out_val = ir_build_const_from(ira, &bin_op_instruction->base);
+        out_val->data.x_vector.elements = allocate<ConstExprValue>(len);
+        for (uint32_t i = 0; i < len; i += 1) {
+            ConstExprValue *elem1 = &op1_val->data.x_vector.elements[i];
+            ConstExprValue *elem2 = &op2_val->data.x_vector.elements[i];
+            ConstExprValue *out_elem = &out_val->data.x_vector.elements[i];
+            out_elem->type = vector_type->data.vector.elem_type;
+            if (elem1->special == ConstValSpecialUndef || elem2->special == ConstValSpecialUndef) {
+                out_elem->special = ConstValSpecialUndef;
+                continue;
+            }
+            if (ir_eval_math_op(elem_type, elem1, op_id, elem2, out_elem) == ErrorDivByZero) {
+                ir_add_error(ira, &bin_op_instruction->base, buf_sprintf("division by zero is undefined"));
+                return ira->codegen->builtin_types.entry_invalid;
+            }
+        }
+        return vector_type;
+    }
+
+    ir_build_bin_op_from(&ira->new_irb, &bin_op_instruction->base, op_id,
+            casted_op1, casted_op2, bin_op_instruction->safety_check_on);
+    return vector_type;
+}
+
+static TypeTableEntry *ir_analyze_bin_op_math(IrAnalyze *ira, IrInstructionBinOp *bin_op_instruction) {
+    IrInstruction *op1 = bin_op_instruction->op1->other;
+    IrInstruction *op2 = bin_op_instruction->op2->other;
+    IrInstruction *instructions[] = {op1, op2};
+    TypeTableEntry *resolved_type = ir_resolve_peer_types(ira, bin_op_instruction->base.source_node, instructions, 2);
+    if (type_is_invalid(resolved_type))
+        return resolved_type;
+    TypeTableEntry *canon_resolved_type = get_underlying_type(resolved_type);
+    IrBinOp op_id = bin_op_instruction->op_id;
+
+    if (canon_resolved_type->id == TypeTableEntryIdVector)
+        return ir_analyze_bin_op_math_vector(ira, bin_op_instruction, canon_resolved_type, op1, op2);
+
+    if (canon_resolved_type->id == TypeTableEntryIdInt ||
+        canon_resolved_type->id == TypeTableEntryIdNumLitInt)
+    {
+        // int
+    } else if ((canon_resolved_type->id == TypeTableEntryIdFloat ||
+                canon_resolved_type->id == TypeTableEntryIdNumLitFloat) &&
+        (op_id == IrBinOpAdd ||
+            op_id == IrBinOpSub ||
+            op_id == IrBinOpMult ||
+            op_id == IrBinOpDiv ||
+            op_id == IrBinOpMod))
+    {
+        // float
+    } else {
+        AstNode *source_node = bin_op_instruction->base.source_node;
+        ir_add_error_node(ira, source_node,
+            buf_sprintf("invalid operands to binary expression: '%s' and '%s'",
+                buf_ptr(&op1->value.type->name),
+                buf_ptr(&op2->value.type->name)));
+        return ira->codegen->builtin_types.entry_invalid;
+    }
+
+    IrInstruction *casted_op1 = ir_implicit_cast(ira, op1, resolved_type);
     if (casted_op1 == ira->codegen->invalid_instruction)
         return ira->codegen->builtin_types.entry_invalid;
 
@@ -7895,6 +8665,7 @@ static TypeTableEntry *ir_analyze_instruction_decl_var(IrAnalyze *ira, IrInstruc
         case TypeTableEntryIdFloat:
         case TypeTableEntryIdPointer:
         case TypeTableEntryIdArray:
+        case TypeTableEntryIdVector:
         case TypeTableEntryIdStruct:
         case TypeTableEntryIdMaybe:
         case TypeTableEntryIdErrorUnion:
@@ -8399,6 +9170,7 @@ static TypeTableEntry *ir_analyze_unary_prefix_op_err(IrAnalyze *ira, IrInstruct
         case TypeTableEntryIdFloat:
         case TypeTableEntryIdPointer:
         case TypeTableEntryIdArray:
+        case TypeTableEntryIdVector:
         case TypeTableEntryIdStruct:
         case TypeTableEntryIdMaybe:
         case TypeTableEntryIdErrorUnion:
@@ -8481,6 +9253,7 @@ static TypeTableEntry *ir_analyze_maybe(IrAnalyze *ira, IrInstructionUnOp *un_op
         case TypeTableEntryIdFloat:
         case TypeTableEntryIdPointer:
         case TypeTableEntryIdArray:
+        case TypeTableEntryIdVector:
         case TypeTableEntryIdStruct:
         case TypeTableEntryIdNumLitFloat:
         case TypeTableEntryIdNumLitInt:
@@ -9417,6 +10190,19 @@ static TypeTableEntry *ir_analyze_instruction_store_ptr(IrAnalyze *ira, IrInstru
     if (instr_is_comptime(ptr) && ptr->value.data.x_ptr.special != ConstPtrSpecialHardCodedAddr) {
         assert(ptr->value.data.x_ptr.mut != ConstPtrMutComptimeConst);
         if (ptr->value.data.x_ptr.mut == ConstPtrMutComptimeVar) {
+            if (instr_is_comptime(casted_value) && is_reinterpreted_byte_ptr(&ptr->value, child_type) &&
+                ptr->value.data.x_ptr.data.base_array.array_val->special != ConstValSpecialRuntime)
+            {
+                if (!ir_set_deref_bytes(ira, &store_ptr_instruction->base, &ptr->value, child_type,
+                            &casted_value->value))
+                {
+                    return ira->codegen->builtin_types.entry_invalid;
+                }
+                if (!ira->new_irb.current_basic_block->must_be_comptime_source_instr) {
+                    ira->new_irb.current_basic_block->must_be_comptime_source_instr = &store_ptr_instruction->base;
+                }
+                return ir_analyze_void(ira, &store_ptr_instruction->base);
+            }
             if (instr_is_comptime(casted_value)) {
                 ConstExprValue *dest_val = const_ptr_pointee(&ptr->value);
                 if (dest_val->special != ConstValSpecialRuntime) {
@@ -9464,6 +10250,7 @@ static TypeTableEntry *ir_analyze_instruction_typeof(IrAnalyze *ira, IrInstructi
         case TypeTableEntryIdFloat:
         case TypeTableEntryIdPointer:
         case TypeTableEntryIdArray:
+        case TypeTableEntryIdVector:
         case TypeTableEntryIdStruct:
         case TypeTableEntryIdMaybe:
         case TypeTableEntryIdErrorUnion:
@@ -9741,6 +10528,75 @@ static TypeTableEntry *ir_analyze_instruction_set_debug_safety(IrAnalyze *ira,
     return ira->codegen->builtin_types.entry_void;
 }
 
+static TypeTableEntry *ir_analyze_instruction_set_fast_math(IrAnalyze *ira,
+        IrInstructionSetFastMath *set_fast_math_instruction)
+{
+    IrInstruction *target_instruction = set_fast_math_instruction->scope_value->other;
+    TypeTableEntry *target_type = target_instruction->value.type;
+    if (type_is_invalid(target_type))
+        return ira->codegen->builtin_types.entry_invalid;
+    ConstExprValue *target_val = ir_resolve_const(ira, target_instruction, UndefBad);
+    if (!target_val)
+        return ira->codegen->builtin_types.entry_invalid;
+
+    if (ira->new_irb.exec->is_inline) {
+        // float math at compile time is always strict
+        ir_build_const_from(ira, &set_fast_math_instruction->base);
+        return ira->codegen->builtin_types.entry_void;
+    }
+
+    bool *fast_math_on_ptr;
+    AstNode **fast_math_set_node_ptr;
+    if (target_type->id == TypeTableEntryIdBlock) {
+        ScopeBlock *block_scope = (ScopeBlock *)target_val->data.x_block;
+        fast_math_on_ptr = &block_scope->fast_math_on;
+        fast_math_set_node_ptr = &block_scope->fast_math_set_node;
+    } else if (target_type->id == TypeTableEntryIdFn) {
+        FnTableEntry *target_fn = target_val->data.x_fn;
+        assert(target_fn->def_scope);
+        fast_math_on_ptr = &target_fn->def_scope->fast_math_on;
+        fast_math_set_node_ptr = &target_fn->def_scope->fast_math_set_node;
+    } else if (target_type->id == TypeTableEntryIdMetaType) {
+        ScopeDecls *decls_scope;
+        TypeTableEntry *type_arg = target_val->data.x_type;
+        if (type_arg->id == TypeTableEntryIdStruct) {
+            decls_scope = type_arg->data.structure.decls_scope;
+        } else if (type_arg->id == TypeTableEntryIdEnum) {
+            decls_scope = type_arg->data.enumeration.decls_scope;
+        } else if (type_arg->id == TypeTableEntryIdUnion) {
+            decls_scope = type_arg->data.unionation.decls_scope;
+        } else {
+            ir_add_error_node(ira, target_instruction->source_node,
+                buf_sprintf("expected scope reference, found type '%s'", buf_ptr(&type_arg->name)));
+            return ira->codegen->builtin_types.entry_invalid;
+        }
+        fast_math_on_ptr = &decls_scope->fast_math_on;
+        fast_math_set_node_ptr = &decls_scope->fast_math_set_node;
+    } else {
+        ir_add_error_node(ira, target_instruction->source_node,
+            buf_sprintf("expected scope reference, found type '%s'", buf_ptr(&target_type->name)));
+        return ira->codegen->builtin_types.entry_invalid;
+    }
+
+    IrInstruction *fast_math_on_value = set_fast_math_instruction->fast_math_on->other;
+    bool want_fast_math;
+    if (!ir_resolve_bool(ira, fast_math_on_value, &want_fast_math))
+        return ira->codegen->builtin_types.entry_invalid;
+
+    AstNode *source_node = set_fast_math_instruction->base.source_node;
+    if (*fast_math_set_node_ptr) {
+        ErrorMsg *msg = ir_add_error_node(ira, source_node,
+                buf_sprintf("fast math set twice for same scope"));
+        add_error_note(ira->codegen, msg, *fast_math_set_node_ptr, buf_sprintf("first set here"));
+        return ira->codegen->builtin_types.entry_invalid;
+    }
+    *fast_math_set_node_ptr = source_node;
+    *fast_math_on_ptr = want_fast_math;
+
+    ir_build_const_from(ira, &set_fast_math_instruction->base);
+    return ira->codegen->builtin_types.entry_void;
+}
+
 static TypeTableEntry *ir_analyze_instruction_slice_type(IrAnalyze *ira,
         IrInstructionSliceType *slice_type_instruction)
 {
@@ -9775,6 +10631,7 @@ static TypeTableEntry *ir_analyze_instruction_slice_type(IrAnalyze *ira,
         case TypeTableEntryIdFloat:
         case TypeTableEntryIdPointer:
         case TypeTableEntryIdArray:
+        case TypeTableEntryIdVector:
         case TypeTableEntryIdStruct:
         case TypeTableEntryIdNumLitFloat:
         case TypeTableEntryIdNumLitInt:
@@ -9867,6 +10724,7 @@ static TypeTableEntry *ir_analyze_instruction_array_type(IrAnalyze *ira,
         case TypeTableEntryIdFloat:
         case TypeTableEntryIdPointer:
         case TypeTableEntryIdArray:
+        case TypeTableEntryIdVector:
         case TypeTableEntryIdStruct:
         case TypeTableEntryIdNumLitFloat:
         case TypeTableEntryIdNumLitInt:
@@ -9964,6 +10822,7 @@ static TypeTableEntry *ir_analyze_instruction_size_of(IrAnalyze *ira,
         case TypeTableEntryIdFloat:
         case TypeTableEntryIdPointer:
         case TypeTableEntryIdArray:
+        case TypeTableEntryIdVector:
         case TypeTableEntryIdStruct:
         case TypeTableEntryIdMaybe:
         case TypeTableEntryIdErrorUnion:
@@ -10097,6 +10956,456 @@ static TypeTableEntry *ir_analyze_instruction_ctz(IrAnalyze *ira, IrInstructionC
     }
 }
 
+static TypeTableEntry *ir_analyze_instruction_bswap(IrAnalyze *ira, IrInstructionBswap *bswap_instruction) {
+    IrInstruction *value = bswap_instruction->value->other;
+    TypeTableEntry *int_type = value->value.type;
+    if (type_is_invalid(int_type)) {
+        return ira->codegen->builtin_types.entry_invalid;
+    } else if (int_type->id != TypeTableEntryIdInt) {
+        ir_add_error_node(ira, bswap_instruction->base.source_node,
+            buf_sprintf("expected integer type, found '%s'", buf_ptr(&int_type->name)));
+        return ira->codegen->builtin_types.entry_invalid;
+    }
+
+    uint32_t bit_count = int_type->data.integral.bit_count;
+    if (bit_count % 8 != 0) {
+        ir_add_error_node(ira, bswap_instruction->base.source_node,
+            buf_sprintf("@bswap of '%s' which is not a whole number of bytes", buf_ptr(&int_type->name)));
+        return ira->codegen->builtin_types.entry_invalid;
+    }
+
+    // compile time integers have 64 bits, so wider ones are swapped at runtime
+    if (value->value.special != ConstValSpecialRuntime && bit_count <= 64) {
+        ConstExprValue *out_val = ir_build_const_from(ira, &bswap_instruction->base);
+        bignum_bswap(&out_val->data.x_bignum, &value->value.data.x_bignum,
+                bit_count, int_type->data.integral.is_signed);
+        return int_type;
+    }
+
+    ir_build_bswap_from(&ira->new_irb, &bswap_instruction->base, value);
+    return int_type;
+}
+
+static TypeTableEntry *ir_analyze_instruction_pop_count(IrAnalyze *ira, IrInstructionPopCount *instruction) {
+    IrInstruction *value = instruction->value->other;
+    TypeTableEntry *int_type = value->value.type;
+    if (type_is_invalid(int_type)) {
+        return ira->codegen->builtin_types.entry_invalid;
+    } else if (int_type->id != TypeTableEntryIdInt) {
+        ir_add_error_node(ira, instruction->base.source_node,
+            buf_sprintf("expected integer type, found '%s'", buf_ptr(&int_type->name)));
+        return ira->codegen->builtin_types.entry_invalid;
+    }
+
+    // the count can be bit_count, which does not fit in a narrow signed type
+    uint32_t bit_count = int_type->data.integral.bit_count;
+    TypeTableEntry *result_type = get_int_type(ira->codegen, false, bit_count);
+    if (value->value.special != ConstValSpecialRuntime && bit_count <= 64) {
+        uint32_t result = bignum_pop_count(&value->value.data.x_bignum, bit_count);
+        ConstExprValue *out_val = ir_build_const_from(ira, &instruction->base);
+        bignum_init_unsigned(&out_val->data.x_bignum, result);
+        return result_type;
+    }
+
+    ir_build_pop_count_from(&ira->new_irb, &instruction->base, value);
+    return result_type;
+}
+
+static TypeTableEntry *ir_analyze_instruction_bit_reverse(IrAnalyze *ira, IrInstructionBitReverse *instruction) {
+    IrInstruction *value = instruction->value->other;
+    TypeTableEntry *int_type = value->value.type;
+    if (type_is_invalid(int_type)) {
+        return ira->codegen->builtin_types.entry_invalid;
+    } else if (int_type->id != TypeTableEntryIdInt) {
+        ir_add_error_node(ira, instruction->base.source_node,
+            buf_sprintf("expected integer type, found '%s'", buf_ptr(&int_type->name)));
+        return ira->codegen->builtin_types.entry_invalid;
+    }
+
+    uint32_t bit_count = int_type->data.integral.bit_count;
+    if (value->value.special != ConstValSpecialRuntime && bit_count <= 64) {
+        ConstExprValue *out_val = ir_build_const_from(ira, &instruction->base);
+        bignum_bit_reverse(&out_val->data.x_bignum, &value->value.data.x_bignum,
+                bit_count, int_type->data.integral.is_signed);
+        return int_type;
+    }
+
+    ir_build_bit_reverse_from(&ira->new_irb, &instruction->base, value);
+    return int_type;
+}
+
+static TypeTableEntry *ir_analyze_instruction_rotate(IrAnalyze *ira, IrInstructionRotate *instruction) {
+    IrInstruction *value = instruction->value->other;
+    TypeTableEntry *int_type = value->value.type;
+    if (type_is_invalid(int_type)) {
+        return ira->codegen->builtin_types.entry_invalid;
+    } else if (int_type->id != TypeTableEntryIdInt) {
+        ir_add_error_node(ira, instruction->base.source_node,
+            buf_sprintf("expected integer type, found '%s'", buf_ptr(&int_type->name)));
+        return ira->codegen->builtin_types.entry_invalid;
+    }
+
+    IrInstruction *amount = instruction->amount->other;
+    if (type_is_invalid(amount->value.type))
+        return ira->codegen->builtin_types.entry_invalid;
+
+    // the amount is an unsigned integer as wide as the value, so that the
+    // rotate is a single instruction
+    uint32_t bit_count = int_type->data.integral.bit_count;
+    TypeTableEntry *amount_type = get_int_type(ira->codegen, false, bit_count);
+    IrInstruction *casted_amount = ir_implicit_cast(ira, amount, amount_type);
+    if (casted_amount == ira->codegen->invalid_instruction)
+        return ira->codegen->builtin_types.entry_invalid;
+
+    if (instr_is_comptime(value) && instr_is_comptime(casted_amount) && bit_count <= 64) {
+        ConstExprValue *value_val = ir_resolve_const(ira, value, UndefBad);
+        if (!value_val)
+            return ira->codegen->builtin_types.entry_invalid;
+        ConstExprValue *amount_val = ir_resolve_const(ira, casted_amount, UndefBad);
+        if (!amount_val)
+            return ira->codegen->builtin_types.entry_invalid;
+
+        uint64_t shift = bignum_to_twos_complement(&amount_val->data.x_bignum) % bit_count;
+        uint64_t left_shift = instruction->is_left ? shift : (bit_count - shift);
+        ConstExprValue *out_val = ir_build_const_from(ira, &instruction->base);
+        bignum_rotl(&out_val->data.x_bignum, &value_val->data.x_bignum, left_shift,
+                bit_count, int_type->data.integral.is_signed);
+        return int_type;
+    }
+
+    ir_build_rotate_from(&ira->new_irb, &instruction->base, value, casted_amount, instruction->is_left);
+    return int_type;
+}
+
+static TypeTableEntry *ir_analyze_instruction_vector_type(IrAnalyze *ira, IrInstructionVectorType *instruction) {
+    IrInstruction *len_value = instruction->len->other;
+    uint64_t len;
+    if (!ir_resolve_usize(ira, len_value, &len))
+        return ira->codegen->builtin_types.entry_invalid;
+
+    IrInstruction *elem_type_value = instruction->elem_type->other;
+    TypeTableEntry *elem_type = ir_resolve_type(ira, elem_type_value);
+    if (type_is_invalid(elem_type))
+        return ira->codegen->builtin_types.entry_invalid;
+
+    if (!is_valid_vector_elem_type(elem_type)) {
+        ir_add_error(ira, elem_type_value,
+            buf_sprintf("expected integer, float or bool type, found '%s'", buf_ptr(&elem_type->name)));
+        return ira->codegen->builtin_types.entry_invalid;
+    }
+    if (len == 0 || len > UINT32_MAX) {
+        ir_add_error(ira, len_value, buf_sprintf("invalid vector length %" PRIu64, len));
+        return ira->codegen->builtin_types.entry_invalid;
+    }
+
+    ConstExprValue *out_val = ir_build_const_from(ira, &instruction->base);
+    out_val->data.x_type = get_vector_type(ira->codegen, (uint32_t)len, elem_type);
+    return ira->codegen->builtin_types.entry_type;
+}
+
+static bool ir_check_vector_operand(IrAnalyze *ira, IrInstruction *value) {
+    if (value->value.type->id != TypeTableEntryIdVector) {
+        ir_add_error(ira, value, buf_sprintf("expected vector type, found '%s'", buf_ptr(&value->value.type->name)));
+        return false;
+    }
+    return true;
+}
+
+static TypeTableEntry *ir_analyze_instruction_splat(IrAnalyze *ira, IrInstructionSplat *instruction) {
+    IrInstruction *vector_type_value = instruction->vector_type->other;
+    TypeTableEntry *vector_type = ir_resolve_type(ira, vector_type_value);
+    if (type_is_invalid(vector_type))
+        return ira->codegen->builtin_types.entry_invalid;
+    if (vector_type->id != TypeTableEntryIdVector) {
+        ir_add_error(ira, vector_type_value,
+            buf_sprintf("expected vector type, found '%s'", buf_ptr(&vector_type->name)));
+        return ira->codegen->builtin_types.entry_invalid;
+    }
+
+    IrInstruction *value = instruction->value->other;
+    if (type_is_invalid(value->value.type))
+        return ira->codegen->builtin_types.entry_invalid;
+
+    IrInstruction *casted_value = ir_implicit_cast(ira, value, vector_type->data.vector.elem_type);
+    if (casted_value == ira->codegen->invalid_instruction)
+        return ira->codegen->builtin_types.entry_invalid;
+
+    if (instr_is_comptime(casted_value)) {
+        ConstExprValue *value_val = ir_resolve_const(ira, casted_value, UndefOk);
+        if (!value_val)
+            return ira->codegen->builtin_types.entry_invalid;
+
+        uint32_t len = vector_type->data.vector.len;
+        ConstExprValue *out_val = ir_build_const_from(ira, &instruction->base);
+        out_val->data.x_vector.elements = allocate<ConstExprValue>(len);
+        for (uint32_t i = 0; i < len; i += 1) {
+            out_val->data.x_vector.elements[i] = *value_val;
+        }
+        return vector_type;
+    }
+
+    ir_build_splat_from(&ira->new_irb, &instruction->base, vector_type_value, casted_value);
+    return vector_type;
+}
+
+static TypeTableEntry *ir_analyze_instruction_shuffle(IrAnalyze *ira, IrInstructionShuffle *instruction) {
+    IrInstruction *a = instruction->a->other;
+    if (type_is_invalid(a->value.type))
+        return ira->codegen->builtin_types.entry_invalid;
+    if (!ir_check_vector_operand(ira, a))
+        return ira->codegen->builtin_types.entry_invalid;
+    TypeTableEntry *vector_type = a->value.type;
+    uint32_t len = vector_type->data.vector.len;
+
+    IrInstruction *b = instruction->b->other;
+    if (type_is_invalid(b->value.type))
+        return ira->codegen->builtin_types.entry_invalid;
+    IrInstruction *casted_b = ir_implicit_cast(ira, b, vector_type);
+    if (casted_b == ira->codegen->invalid_instruction)
+        return ira->codegen->builtin_types.entry_invalid;
+
+    IrInstruction *mask = instruction->mask->other;
+    TypeTableEntry *mask_type = mask->value.type;
+    if (type_is_invalid(mask_type))
+        return ira->codegen->builtin_types.entry_invalid;
+    if (mask_type->id != TypeTableEntryIdArray ||
+        get_underlying_type(mask_type->data.array.child_type)->id != TypeTableEntryIdInt)
+    {
+        ir_add_error(ira, mask, buf_sprintf("expected array of integers, found '%s'", buf_ptr(&mask_type->name)));
+        return ira->codegen->builtin_types.entry_invalid;
+    }
+    uint64_t mask_len = mask_type->data.array.len;
+    if (mask_len == 0 || mask_len > UINT32_MAX) {
+        ir_add_error(ira, mask, buf_sprintf("invalid vector length %" PRIu64, mask_len));
+        return ira->codegen->builtin_types.entry_invalid;
+    }
+    ConstExprValue *mask_val = ir_resolve_const(ira, mask, UndefBad);
+    if (!mask_val)
+        return ira->codegen->builtin_types.entry_invalid;
+
+    // Check the indexes and turn them into the vector of u32 which
+    // shufflevector takes.
+    TypeTableEntry *u32_type = ira->codegen->builtin_types.entry_u32;
+    IrInstruction *mask_vector = ir_create_const(&ira->new_irb, instruction->base.scope,
+            instruction->base.source_node, get_vector_type(ira->codegen, (uint32_t)mask_len, u32_type));
+    ConstExprValue *mask_vector_val = &mask_vector->value;
+    mask_vector_val->data.x_vector.elements = allocate<ConstExprValue>(mask_len);
+    for (uint32_t i = 0; i < mask_len; i += 1) {
+        ConstExprValue *index_val = &mask_val->data.x_array.elements[i];
+        if (index_val->special == ConstValSpecialUndef) {
+            ir_add_error(ira, mask, buf_sprintf("shuffle mask index %" PRIu32 " is undefined", i));
+            return ira->codegen->builtin_types.entry_invalid;
+        }
+        BigNum *index = &index_val->data.x_bignum;
+        if (index->is_negative || index->data.x_uint >= 2 * (uint64_t)len) {
+            ir_add_error(ira, mask,
+                buf_sprintf("shuffle mask index %" PRIu32 " selects element %s%" PRIu64 " of two vectors of %" PRIu32,
+                    i, index->is_negative ? "-" : "", (uint64_t)index->data.x_uint, len));
+            return ira->codegen->builtin_types.entry_invalid;
+        }
+        ConstExprValue *elem_val = &mask_vector_val->data.x_vector.elements[i];
+        elem_val->special = ConstValSpecialStatic;
+        elem_val->type = u32_type;
+        bignum_init_unsigned(&elem_val->data.x_bignum, index->data.x_uint);
+    }
+
+    TypeTableEntry *result_type = get_vector_type(ira->codegen, (uint32_t)mask_len, vector_type->data.vector.elem_type);
+
+    if (instr_is_comptime(a) && instr_is_comptime(casted_b)) {
+        ConstExprValue *a_val = ir_resolve_const(ira, a, UndefBad);
+        if (!a_val)
+            return ira->codegen->builtin_types.entry_invalid;
+        ConstExprValue *b_val = ir_resolve_const(ira, casted_b, UndefBad);
+        if (!b_val)
+            return ira->codegen->builtin_types.entry_invalid;
+
+        ConstExprValue *out_val = ir_build_const_from(ira, &instruction->base);
+        out_val->data.x_vector.elements = allocate<ConstExprValue>(mask_len);
+        for (uint32_t i = 0; i < mask_len; i += 1) {
+            uint64_t index = mask_vector_val->data.x_vector.elements[i].data.x_bignum.data.x_uint;
+            out_val->data.x_vector.elements[i] = (index < len) ?
+                a_val->data.x_vector.elements[index] : b_val->data.x_vector.elements[index - len];
+        }
+        return result_type;
+    }
+
+    ir_build_shuffle_from(&ira->new_irb, &instruction->base, a, casted_b, mask_vector);
+    return result_type;
+}
+
+static TypeTableEntry *ir_analyze_instruction_select(IrAnalyze *ira, IrInstructionSelect *instruction) {
+    IrInstruction *a = instruction->a->other;
+    if (type_is_invalid(a->value.type))
+        return ira->codegen->builtin_types.entry_invalid;
+    if (!ir_check_vector_operand(ira, a))
+        return ira->codegen->builtin_types.entry_invalid;
+    TypeTableEntry *vector_type = a->value.type;
+    uint32_t len = vector_type->data.vector.len;
+
+    IrInstruction *b = instruction->b->other;
+    if (type_is_invalid(b->value.type))
+        return ira->codegen->builtin_types.entry_invalid;
+    IrInstruction *casted_b = ir_implicit_cast(ira, b, vector_type);
+    if (casted_b == ira->codegen->invalid_instruction)
+        return ira->codegen->builtin_types.entry_invalid;
+
+    IrInstruction *mask = instruction->mask->other;
+    if (type_is_invalid(mask->value.type))
+        return ira->codegen->builtin_types.entry_invalid;
+    TypeTableEntry *mask_type = get_vector_type(ira->codegen, len, ira->codegen->builtin_types.entry_bool);
+    IrInstruction *casted_mask = ir_implicit_cast(ira, mask, mask_type);
+    if (casted_mask == ira->codegen->invalid_instruction)
+        return ira->codegen->builtin_types.entry_invalid;
+
+    if (instr_is_comptime(casted_mask) && instr_is_comptime(a) && instr_is_comptime(casted_b)) {
+        ConstExprValue *mask_val = ir_resolve_const(ira, casted_mask, UndefBad);
+        if (!mask_val)
+            return ira->codegen->builtin_types.entry_invalid;
+        ConstExprValue *a_val = ir_resolve_const(ira, a, UndefBad);
+        if (!a_val)
+            return ira->codegen->builtin_types.entry_invalid;
+        ConstExprValue *b_val = ir_resolve_const(ira, casted_b, UndefBad);
+        if (!b_val)
+            return ira->codegen->builtin_types.entry_invalid;
+
+        ConstExprValue *out_val = ir_build_const_from(ira, &instruction->base);
+        out_val->data.x_vector.elements = allocate<ConstExprValue>(len);
+        for (uint32_t i = 0; i < len; i += 1) {
+            ConstExprValue *mask_elem = &mask_val->data.x_vector.elements[i];
+            ConstExprValue *out_elem = &out_val->data.x_vector.elements[i];
+            if (mask_elem->special == ConstValSpecialUndef) {
+                out_elem->special = ConstValSpecialUndef;
+                out_elem->type = vector_type->data.vector.elem_type;
+            } else {
+                *out_elem = mask_elem->data.x_bool ?
+                    a_val->data.x_vector.elements[i] : b_val->data.x_vector.elements[i];
+            }
+        }
+        return vector_type;
+    }
+
+    ir_build_select_from(&ira->new_irb, &instruction->base, casted_mask, a, casted_b);
+    return vector_type;
+}
+
+// One step of a comptime @reduce, the same as gen_reduce_op in codegen.cpp.
+static int ir_eval_reduce_op(TypeTableEntry *canon_elem_type, ReduceOp op,
+        ConstExprValue *a, ConstExprValue *b, ConstExprValue *out_val)
+{
+    out_val->type = a->type;
+    if (a->special == ConstValSpecialUndef || b->special == ConstValSpecialUndef) {
+        out_val->special = ConstValSpecialUndef;
+        return 0;
+    }
+    bool is_float = (canon_elem_type->id == TypeTableEntryIdFloat);
+    bool is_bool = (canon_elem_type->id == TypeTableEntryIdBool);
+    switch (op) {
+        case ReduceOpAdd:
+            return ir_eval_math_op(canon_elem_type, a, is_float ? IrBinOpAdd : IrBinOpAddWrap, b, out_val);
+        case ReduceOpMul:
+            return ir_eval_math_op(canon_elem_type, a, is_float ? IrBinOpMult : IrBinOpMultWrap, b, out_val);
+        case ReduceOpAnd:
+        case ReduceOpOr:
+        case ReduceOpXor:
+            if (is_bool) {
+                out_val->special = ConstValSpecialStatic;
+                if (op == ReduceOpAnd) {
+                    out_val->data.x_bool = a->data.x_bool && b->data.x_bool;
+                } else if (op == ReduceOpOr) {
+                    out_val->data.x_bool = a->data.x_bool || b->data.x_bool;
+                } else {
+                    out_val->data.x_bool = a->data.x_bool != b->data.x_bool;
+                }
+                return 0;
+            } else {
+                IrBinOp op_id = (op == ReduceOpAnd) ? IrBinOpBinAnd :
+                    (op == ReduceOpOr) ? IrBinOpBinOr : IrBinOpBinXor;
+                return ir_eval_math_op(canon_elem_type, a, op_id, b, out_val);
+            }
+        case ReduceOpMin:
+            *out_val = bignum_cmp_lt(&a->data.x_bignum, &b->data.x_bignum) ? *a : *b;
+            return 0;
+        case ReduceOpMax:
+            *out_val = bignum_cmp_gt(&a->data.x_bignum, &b->data.x_bignum) ? *a : *b;
+            return 0;
+    }
+    zig_unreachable();
+}
+
+static TypeTableEntry *ir_analyze_instruction_reduce(IrAnalyze *ira, IrInstructionReduce *instruction) {
+    IrInstruction *op_value = instruction->op_value->other;
+    ReduceOp op;
+    if (!ir_resolve_reduce_op(ira, op_value, &op))
+        return ira->codegen->builtin_types.entry_invalid;
+
+    IrInstruction *value = instruction->value->other;
+    if (type_is_invalid(value->value.type))
+        return ira->codegen->builtin_types.entry_invalid;
+    if (!ir_check_vector_operand(ira, value))
+        return ira->codegen->builtin_types.entry_invalid;
+    TypeTableEntry *vector_type = value->value.type;
+    TypeTableEntry *elem_type = vector_type->data.vector.elem_type;
+    TypeTableEntry *canon_elem_type = get_underlying_type(elem_type);
+
+    bool op_allowed;
+    switch (canon_elem_type->id) {
+        case TypeTableEntryIdBool:
+            op_allowed = (op == ReduceOpAnd || op == ReduceOpOr || op == ReduceOpXor);
+            break;
+        case TypeTableEntryIdFloat:
+            op_allowed = (op == ReduceOpAdd || op == ReduceOpMul || op == ReduceOpMin || op == ReduceOpMax);
+            break;
+        default:
+            op_allowed = true;
+            break;
+    }
+    if (!op_allowed) {
+        Buf *op_name = ira->codegen->builtin_types.entry_reduce_op_enum->data.enumeration.fields[op].name;
+        ir_add_error(ira, op_value, buf_sprintf("unable to reduce '%s' with ReduceOp.%s",
+                    buf_ptr(&vector_type->name), buf_ptr(op_name)));
+        return ira->codegen->builtin_types.entry_invalid;
+    }
+
+    if (instr_is_comptime(value)) {
+        ConstExprValue *value_val = ir_resolve_const(ira, value, UndefBad);
+        if (!value_val)
+            return ira->codegen->builtin_types.entry_invalid;
+
+        // the same order as ir_render_reduce: halves while the length is
+        // even, then one element at a time
+        uint32_t len = vector_type->data.vector.len;
+        ConstExprValue *elems = allocate<ConstExprValue>(len);
+        for (uint32_t i = 0; i < len; i += 1) {
+            elems[i] = value_val->data.x_vector.elements[i];
+        }
+        ConstExprValue tmp = {};
+        while (len % 2 == 0) {
+            len /= 2;
+            for (uint32_t i = 0; i < len; i += 1) {
+                if (ir_eval_reduce_op(canon_elem_type, op, &elems[i], &elems[len + i], &tmp)) {
+                    ir_add_error(ira, &instruction->base, buf_sprintf("operation caused overflow"));
+                    return ira->codegen->builtin_types.entry_invalid;
+                }
+                elems[i] = tmp;
+            }
+        }
+        for (uint32_t i = 1; i < len; i += 1) {
+            if (ir_eval_reduce_op(canon_elem_type, op, &elems[0], &elems[i], &tmp)) {
+                ir_add_error(ira, &instruction->base, buf_sprintf("operation caused overflow"));
+                return ira->codegen->builtin_types.entry_invalid;
+            }
+            elems[0] = tmp;
+        }
+
+        ConstExprValue *out_val = ir_build_const_from(ira, &instruction->base);
+        *out_val = elems[0];
+        return elem_type;
+    }
+
+    ir_build_reduce_from(&ira->new_irb, &instruction->base, op_value, value, op);
+    return elem_type;
+}
+
 static TypeTableEntry *ir_analyze_instruction_clz(IrAnalyze *ira, IrInstructionClz *clz_instruction) {
     IrInstruction *value = clz_instruction->value->other;
     if (type_is_invalid(value->value.type)) {
@@ -10313,6 +11622,7 @@ static TypeTableEntry *ir_analyze_instruction_switch_target(IrAnalyze *ira,
             zig_panic("TODO switch on enum tag type");
         case TypeTableEntryIdUnreachable:
         case TypeTableEntryIdArray:
+        case TypeTableEntryIdVector:
         case TypeTableEntryIdStruct:
         case TypeTableEntryIdUndefLit:
         case TypeTableEntryIdNullLit:
@@ -10821,6 +12131,7 @@ static TypeTableEntry *ir_analyze_min_max(IrAnalyze *ira, IrInstruction *source_
         case TypeTableEntryIdUnreachable:
         case TypeTableEntryIdPointer:
         case TypeTableEntryIdArray:
+        case TypeTableEntryIdVector:
         case TypeTableEntryIdStruct:
         case TypeTableEntryIdNumLitFloat:
         case TypeTableEntryIdNumLitInt:
@@ -11486,6 +12797,7 @@ static TypeTableEntry *ir_analyze_instruction_memcpy(IrAnalyze *ira, IrInstructi
 
         ConstExprValue *dest_ptr_val = &casted_dest_ptr->value;
         ConstExprValue *dest_elements;
+        TypeTableEntry *dest_elem_type;
         size_t dest_start;
         size_t dest_end;
         switch (dest_ptr_val->data.x_ptr.special) {
@@ -11494,6 +12806,7 @@ static TypeTableEntry *ir_analyze_instruction_memcpy(IrAnalyze *ira, IrInstructi
                 zig_unreachable();
             case ConstPtrSpecialRef:
                 dest_elements = dest_ptr_val->data.x_ptr.data.ref.pointee;
+                dest_elem_type = dest_elements->type;
                 dest_start = 0;
                 dest_end = 1;
                 break;
@@ -11501,6 +12814,7 @@ static TypeTableEntry *ir_analyze_instruction_memcpy(IrAnalyze *ira, IrInstructi
                 {
                     ConstExprValue *array_val = dest_ptr_val->data.x_ptr.data.base_array.array_val;
                     dest_elements = array_val->data.x_array.elements;
+                    dest_elem_type = array_val->type->data.array.child_type;
                     dest_start = dest_ptr_val->data.x_ptr.data.base_array.elem_index;
                     dest_end = array_val->type->data.array.len;
                     break;
@@ -11511,6 +12825,18 @@ static TypeTableEntry *ir_analyze_instruction_memcpy(IrAnalyze *ira, IrInstructi
                 zig_unreachable();
         }
 
+        // The pointers were cast to &u8, so the count is in bytes, but the
+        // values are copied an element at a time.
+        uint64_t elem_size = type_size(ira->codegen, dest_elem_type);
+        if (elem_size > 1) {
+            if (count % elem_size != 0) {
+                ir_add_error(ira, &instruction->base,
+                    buf_sprintf("TODO compile time memcpy of part of an element"));
+                return ira->codegen->builtin_types.entry_invalid;
+            }
+            count /= elem_size;
+        }
+
         if (dest_start + count > dest_end) {
             ir_add_error(ira, &instruction->base, buf_sprintf("out of bounds pointer access"));
             return ira->codegen->builtin_types.entry_invalid;
@@ -11518,6 +12844,7 @@ static TypeTableEntry *ir_analyze_instruction_memcpy(IrAnalyze *ira, IrInstructi
 
         ConstExprValue *src_ptr_val = &casted_src_ptr->value;
         ConstExprValue *src_elements;
+        TypeTableEntry *src_elem_type;
         size_t src_start;
         size_t src_end;
 
@@ -11527,6 +12854,7 @@ static TypeTableEntry *ir_analyze_instruction_memcpy(IrAnalyze *ira, IrInstructi
                 zig_unreachable();
             case ConstPtrSpecialRef:
                 src_elements = src_ptr_val->data.x_ptr.data.ref.pointee;
+                src_elem_type = src_elements->type;
                 src_start = 0;
                 src_end = 1;
                 break;
@@ -11534,6 +12862,7 @@ static TypeTableEntry *ir_analyze_instruction_memcpy(IrAnalyze *ira, IrInstructi
                 {
                     ConstExprValue *array_val = src_ptr_val->data.x_ptr.data.base_array.array_val;
                     src_elements = array_val->data.x_array.elements;
+                    src_elem_type = array_val->type->data.array.child_type;
                     src_start = src_ptr_val->data.x_ptr.data.base_array.elem_index;
                     src_end = array_val->type->data.array.len;
                     break;
@@ -11544,6 +12873,33 @@ static TypeTableEntry *ir_analyze_instruction_memcpy(IrAnalyze *ira, IrInstructi
                 zig_unreachable();
         }
 
+        // a whole integer from or to the bytes of an array, as in
+        // mem.readUnaligned and mem.writeUnaligned
+        if (dest_ptr_val->data.x_ptr.special == ConstPtrSpecialRef && count == 1 &&
+            is_reinterpreted_byte_ptr(src_ptr_val, dest_elem_type))
+        {
+            IrInstruction *value = ir_get_deref_bytes(ira, &instruction->base, src_ptr_val, dest_elem_type);
+            if (type_is_invalid(value->value.type))
+                return ira->codegen->builtin_types.entry_invalid;
+            *dest_elements = value->value;
+            ir_build_const_from(ira, &instruction->base);
+            return ira->codegen->builtin_types.entry_void;
+        }
+        if (src_ptr_val->data.x_ptr.special == ConstPtrSpecialRef && count == type_size(ira->codegen, src_elem_type) &&
+            is_reinterpreted_byte_ptr(dest_ptr_val, src_elem_type))
+        {
+            if (!ir_set_deref_bytes(ira, &instruction->base, dest_ptr_val, src_elem_type, src_elements))
+                return ira->codegen->builtin_types.entry_invalid;
+            ir_build_const_from(ira, &instruction->base);
+            return ira->codegen->builtin_types.entry_void;
+        }
+
+        if (get_underlying_type(src_elem_type) != get_underlying_type(dest_elem_type)) {
+            ir_add_error(ira, &instruction->base,
+                buf_sprintf("TODO compile time memcpy between different element types"));
+            return ira->codegen->builtin_types.entry_invalid;
+        }
+
         if (src_start + count > src_end) {
             ir_add_error(ira, &instruction->base, buf_sprintf("out of bounds pointer access"));
             return ira->codegen->builtin_types.entry_invalid;
@@ -12215,6 +13571,8 @@ static TypeTableEntry *ir_analyze_instruction_nocast(IrAnalyze *ira, IrInstructi
             return ir_analyze_instruction_set_global_section(ira, (IrInstructionSetGlobalSection *)instruction);
         case IrInstructionIdSetDebugSafety:
             return ir_analyze_instruction_set_debug_safety(ira, (IrInstructionSetDebugSafety *)instruction);
+        case IrInstructionIdSetFastMath:
+            return ir_analyze_instruction_set_fast_math(ira, (IrInstructionSetFastMath *)instruction);
         case IrInstructionIdSliceType:
             return ir_analyze_instruction_slice_type(ira, (IrInstructionSliceType *)instruction);
         case IrInstructionIdAsm:
@@ -12233,6 +13591,24 @@ static TypeTableEntry *ir_analyze_instruction_nocast(IrAnalyze *ira, IrInstructi
             return ir_analyze_instruction_clz(ira, (IrInstructionClz *)instruction);
         case IrInstructionIdCtz:
             return ir_analyze_instruction_ctz(ira, (IrInstructionCtz *)instruction);
+        case IrInstructionIdBswap:
+            return ir_analyze_instruction_bswap(ira, (IrInstructionBswap *)instruction);
+        case IrInstructionIdPopCount:
+            return ir_analyze_instruction_pop_count(ira, (IrInstructionPopCount *)instruction);
+        case IrInstructionIdBitReverse:
+            return ir_analyze_instruction_bit_reverse(ira, (IrInstructionBitReverse *)instruction);
+        case IrInstructionIdRotate:
+            return ir_analyze_instruction_rotate(ira, (IrInstructionRotate *)instruction);
+        case IrInstructionIdVectorType:
+            return ir_analyze_instruction_vector_type(ira, (IrInstructionVectorType *)instruction);
+        case IrInstructionIdSplat:
+            return ir_analyze_instruction_splat(ira, (IrInstructionSplat *)instruction);
+        case IrInstructionIdShuffle:
+            return ir_analyze_instruction_shuffle(ira, (IrInstructionShuffle *)instruction);
+        case IrInstructionIdSelect:
+            return ir_analyze_instruction_select(ira, (IrInstructionSelect *)instruction);
+        case IrInstructionIdReduce:
+            return ir_analyze_instruction_reduce(ira, (IrInstructionReduce *)instruction);
         case IrInstructionIdSwitchBr:
             return ir_analyze_instruction_switch_br(ira, (IrInstructionSwitchBr *)instruction);
         case IrInstructionIdSwitchTarget:
@@ -12424,6 +13800,7 @@ bool ir_has_side_effects(IrInstruction *instruction) {
         case IrInstructionIdSetFnTest:
         case IrInstructionIdSetFnVisible:
         case IrInstructionIdSetDebugSafety:
+        case IrInstructionIdSetFastMath:
         case IrInstructionIdImport:
         case IrInstructionIdCompileErr:
         case IrInstructionIdCompileLog:
@@ -12467,6 +13844,15 @@ bool ir_has_side_effects(IrInstruction *instruction) {
         case IrInstructionIdUnwrapMaybe:
         case IrInstructionIdClz:
         case IrInstructionIdCtz:
+        case IrInstructionIdBswap:
+        case IrInstructionIdPopCount:
+        case IrInstructionIdBitReverse:
+        case IrInstructionIdRotate:
+        case IrInstructionIdVectorType:
+        case IrInstructionIdSplat:
+        case IrInstructionIdShuffle:
+        case IrInstructionIdSelect:
+        case IrInstructionIdReduce:
         case IrInstructionIdSwitchVar:
         case IrInstructionIdSwitchTarget:
         case IrInstructionIdEnumTag:
@@ -12579,3 +13965,553 @@ FnTableEntry *ir_create_inline_fn(CodeGen *codegen, Buf *fn_name, VariableTableE
     return fn_entry;
 }
 
+
+// Bounds check elision.
+//
+// After analysis, look for branches of the form `if (i < s.len)` or `if (i < N)`,
+// which includes the condition of every `for` loop, and turn off the runtime
+// safety check of `s[i]` and `array[i]` element accesses that only execute
+// while the condition holds. A forward dataflow pass over the basic blocks
+// tracks which of these facts are true at each instruction. A fact dies when
+// either of its variables is stored to or declared again.
+//
+// This is only sound for variables which cannot be modified behind our back,
+// so we only consider locals and parameters whose address never escapes:
+// every pointer to the variable must be consumed directly by a load, store,
+// element access, or slice. The slice variable of a fact additionally must
+// never be stored to, so that every load of `s.len` sees the same value.
+
+struct BoundsVar {
+    size_t total_uses;
+    size_t recognized_uses;
+    size_t field_ptr_uses;
+    size_t recognized_field_ptr_uses;
+    bool is_global;
+    bool is_escaped;
+    bool is_stored;
+};
+
+struct BoundsGuard {
+    VariableTableEntry *index_var;
+    // When this is null, the bound is the comptime known len.
+    VariableTableEntry *slice_var;
+    uint64_t len;
+};
+
+struct BoundsIndexLoad {
+    IrInstruction *load;
+    uint64_t facts;
+};
+
+static const size_t bounds_max_guards = 64;
+
+struct BoundsElide {
+    HashMap<const void *, size_t, ptr_hash, ptr_eq> var_table;
+    ZigList<BoundsVar> vars;
+    HashMap<const void *, size_t, ptr_hash, ptr_eq> block_table;
+    ZigList<size_t> block_guard;
+    ZigList<uint64_t> block_facts;
+    ZigList<BoundsGuard> guards;
+    ZigList<BoundsIndexLoad> index_loads;
+};
+
+static size_t bounds_var_index(BoundsElide *be, VariableTableEntry *var) {
+    auto entry = be->var_table.maybe_get(var);
+    if (entry)
+        return entry->value;
+
+    size_t index = be->vars.length;
+    be->var_table.put(var, index);
+    BoundsVar *bounds_var = be->vars.add_one();
+    bounds_var->total_uses = 0;
+    bounds_var->recognized_uses = 0;
+    bounds_var->field_ptr_uses = 0;
+    bounds_var->recognized_field_ptr_uses = 0;
+    bounds_var->is_global = (var->parent_scope->id == ScopeIdDecls);
+    bounds_var->is_escaped = false;
+    bounds_var->is_stored = false;
+    return index;
+}
+
+static VariableTableEntry *bounds_var_ptr_var(IrInstruction *instruction) {
+    if (instruction->id != IrInstructionIdVarPtr || instr_is_comptime(instruction))
+        return nullptr;
+    return ((IrInstructionVarPtr *)instruction)->var;
+}
+
+static VariableTableEntry *bounds_loaded_var(IrInstruction *instruction) {
+    if (instruction->id != IrInstructionIdLoadPtr)
+        return nullptr;
+    return bounds_var_ptr_var(((IrInstructionLoadPtr *)instruction)->ptr);
+}
+
+// Returns the variable whose fields a struct field pointer points into, whether
+// the struct is addressed through a pointer to the variable or its loaded value.
+static VariableTableEntry *bounds_field_ptr_var(IrInstruction *instruction) {
+    if (instruction->id != IrInstructionIdStructFieldPtr)
+        return nullptr;
+    IrInstruction *struct_ptr = ((IrInstructionStructFieldPtr *)instruction)->struct_ptr;
+    VariableTableEntry *var = bounds_var_ptr_var(struct_ptr);
+    return var ? var : bounds_loaded_var(struct_ptr);
+}
+
+static void bounds_recognize_use(BoundsElide *be, IrInstruction *operand) {
+    VariableTableEntry *var = bounds_var_ptr_var(operand);
+    if (var)
+        be->vars.at(bounds_var_index(be, var)).recognized_uses += 1;
+}
+
+static void bounds_recognize_field_ptr_use(BoundsElide *be, IrInstruction *operand, bool is_store) {
+    VariableTableEntry *var = bounds_field_ptr_var(operand);
+    if (!var)
+        return;
+    BoundsVar *bounds_var = &be->vars.at(bounds_var_index(be, var));
+    bounds_var->recognized_field_ptr_uses += 1;
+    if (is_store)
+        bounds_var->is_stored = true;
+}
+
+static void bounds_scan_var_uses(BoundsElide *be, IrInstruction *instruction) {
+    switch (instruction->id) {
+        case IrInstructionIdVarPtr:
+            {
+                size_t index = bounds_var_index(be, ((IrInstructionVarPtr *)instruction)->var);
+                be->vars.at(index).total_uses += instruction->ref_count;
+                break;
+            }
+        case IrInstructionIdLoadPtr:
+            {
+                IrInstruction *ptr = ((IrInstructionLoadPtr *)instruction)->ptr;
+                bounds_recognize_use(be, ptr);
+                bounds_recognize_field_ptr_use(be, ptr, false);
+                break;
+            }
+        case IrInstructionIdStorePtr:
+            {
+                IrInstruction *ptr = ((IrInstructionStorePtr *)instruction)->ptr;
+                VariableTableEntry *var = bounds_var_ptr_var(ptr);
+                if (var) {
+                    BoundsVar *bounds_var = &be->vars.at(bounds_var_index(be, var));
+                    bounds_var->recognized_uses += 1;
+                    bounds_var->is_stored = true;
+                }
+                bounds_recognize_field_ptr_use(be, ptr, true);
+                break;
+            }
+        case IrInstructionIdElemPtr:
+            bounds_recognize_use(be, ((IrInstructionElemPtr *)instruction)->array_ptr);
+            break;
+        case IrInstructionIdSlice:
+            bounds_recognize_use(be, ((IrInstructionSlice *)instruction)->ptr);
+            break;
+        case IrInstructionIdStructFieldPtr:
+            {
+                VariableTableEntry *var = bounds_field_ptr_var(instruction);
+                if (var) {
+                    be->vars.at(bounds_var_index(be, var)).field_ptr_uses += instruction->ref_count;
+                    bounds_recognize_use(be, ((IrInstructionStructFieldPtr *)instruction)->struct_ptr);
+                }
+                break;
+            }
+        case IrInstructionIdRef:
+            {
+                // For types which are passed by pointer, the loaded value of a
+                // variable is the address of the variable.
+                VariableTableEntry *var = bounds_loaded_var(((IrInstructionRef *)instruction)->value);
+                if (var)
+                    be->vars.at(bounds_var_index(be, var)).is_escaped = true;
+                break;
+            }
+        default:
+            break;
+    }
+}
+
+static bool bounds_var_is_tracked(BoundsElide *be, VariableTableEntry *var) {
+    auto entry = be->var_table.maybe_get(var);
+    if (!entry)
+        return false;
+    BoundsVar *bounds_var = &be->vars.at(entry->value);
+    return !bounds_var->is_global && !bounds_var->is_escaped &&
+        bounds_var->recognized_uses == bounds_var->total_uses &&
+        bounds_var->recognized_field_ptr_uses == bounds_var->field_ptr_uses;
+}
+
+static bool bounds_var_is_stored(BoundsElide *be, VariableTableEntry *var) {
+    return be->vars.at(be->var_table.get(var)).is_stored;
+}
+
+static VariableTableEntry *bounds_store_target(IrInstruction *instruction) {
+    if (instruction->id == IrInstructionIdStorePtr)
+        return bounds_var_ptr_var(((IrInstructionStorePtr *)instruction)->ptr);
+    if (instruction->id == IrInstructionIdDeclVar)
+        return ((IrInstructionDeclVar *)instruction)->var;
+    return nullptr;
+}
+
+// Returns the index of the guard established by taking the then branch of
+// cond_br, or SIZE_MAX if the condition is not a recognized bounds check.
+static size_t bounds_match_guard(BoundsElide *be, IrBasicBlock *bb, IrInstructionCondBr *cond_br) {
+    if (cond_br->then_block == cond_br->else_block)
+        return SIZE_MAX;
+    IrInstruction *condition = cond_br->condition;
+    if (condition->id != IrInstructionIdBinOp)
+        return SIZE_MAX;
+    IrInstructionBinOp *bin_op = (IrInstructionBinOp *)condition;
+
+    IrInstruction *index;
+    IrInstruction *bound;
+    if (bin_op->op_id == IrBinOpCmpLessThan) {
+        index = bin_op->op1;
+        bound = bin_op->op2;
+    } else if (bin_op->op_id == IrBinOpCmpGreaterThan) {
+        index = bin_op->op2;
+        bound = bin_op->op1;
+    } else {
+        return SIZE_MAX;
+    }
+
+    TypeTableEntry *index_type = get_underlying_type(index->value.type);
+    if (index_type->id != TypeTableEntryIdInt || index_type->data.integral.is_signed)
+        return SIZE_MAX;
+    VariableTableEntry *index_var = bounds_loaded_var(index);
+    if (!index_var || !bounds_var_is_tracked(be, index_var))
+        return SIZE_MAX;
+
+    // The loaded index must still be the value of the variable when we branch.
+    size_t instr_i = bb->instruction_list.length;
+    for (;;) {
+        if (instr_i == 0)
+            return SIZE_MAX;
+        instr_i -= 1;
+        IrInstruction *instruction = bb->instruction_list.at(instr_i);
+        if (instruction == index)
+            break;
+        if (bounds_store_target(instruction) == index_var)
+            return SIZE_MAX;
+    }
+
+    BoundsGuard guard;
+    guard.index_var = index_var;
+    guard.slice_var = nullptr;
+    guard.len = 0;
+    if (bound->value.special == ConstValSpecialStatic) {
+        TypeTableEntry *bound_type = get_underlying_type(bound->value.type);
+        if (bound_type->id != TypeTableEntryIdInt && bound_type->id != TypeTableEntryIdNumLitInt)
+            return SIZE_MAX;
+        BigNum *bignum = &bound->value.data.x_bignum;
+        if (bignum->kind != BigNumKindInt || bignum->is_negative)
+            return SIZE_MAX;
+        guard.len = bignum->data.x_uint;
+    } else {
+        if (bound->id != IrInstructionIdLoadPtr)
+            return SIZE_MAX;
+        IrInstruction *len_ptr = ((IrInstructionLoadPtr *)bound)->ptr;
+        VariableTableEntry *slice_var = bounds_field_ptr_var(len_ptr);
+        if (!slice_var || !bounds_var_is_tracked(be, slice_var) || bounds_var_is_stored(be, slice_var))
+            return SIZE_MAX;
+        TypeTableEntry *slice_type = get_underlying_type(((IrInstructionStructFieldPtr *)len_ptr)->struct_ptr->value.type);
+        if (slice_type->id == TypeTableEntryIdPointer)
+            slice_type = get_underlying_type(slice_type->data.pointer.child_type);
+        if (!is_slice(slice_type))
+            return SIZE_MAX;
+        if (((IrInstructionStructFieldPtr *)len_ptr)->field != &slice_type->data.structure.fields[slice_len_index])
+            return SIZE_MAX;
+        guard.slice_var = slice_var;
+    }
+
+    for (size_t i = 0; i < be->guards.length; i += 1) {
+        BoundsGuard *other = &be->guards.at(i);
+        if (other->index_var == guard.index_var && other->slice_var == guard.slice_var &&
+            other->len == guard.len)
+        {
+            return i;
+        }
+    }
+    if (be->guards.length >= bounds_max_guards)
+        return SIZE_MAX;
+    be->guards.append(guard);
+    return be->guards.length - 1;
+}
+
+static uint64_t bounds_var_guards(BoundsElide *be, VariableTableEntry *var, bool index_only) {
+    uint64_t mask = 0;
+    for (size_t i = 0; i < be->guards.length; i += 1) {
+        BoundsGuard *guard = &be->guards.at(i);
+        if (guard->index_var == var || (!index_only && guard->slice_var == var))
+            mask |= ((uint64_t)1) << i;
+    }
+    return mask;
+}
+
+static bool bounds_guard_covers(BoundsGuard *guard, IrInstruction *array_ptr) {
+    if (guard->slice_var)
+        return bounds_var_ptr_var(array_ptr) == guard->slice_var;
+
+    TypeTableEntry *ptr_type = get_underlying_type(array_ptr->value.type);
+    if (ptr_type->id != TypeTableEntryIdPointer)
+        return false;
+    TypeTableEntry *array_type = get_underlying_type(ptr_type->data.pointer.child_type);
+    return array_type->id == TypeTableEntryIdArray && guard->len <= array_type->data.array.len;
+}
+
+static void bounds_elide_elem_ptr(BoundsElide *be, IrInstructionElemPtr *elem_ptr, uint64_t facts) {
+    if (!elem_ptr->safety_check_on)
+        return;
+    uint64_t index_facts = 0;
+    for (size_t i = 0; i < be->index_loads.length; i += 1) {
+        if (be->index_loads.at(i).load == elem_ptr->elem_index) {
+            index_facts = be->index_loads.at(i).facts & facts;
+            break;
+        }
+    }
+    for (size_t i = 0; i < be->guards.length; i += 1) {
+        if (!(index_facts & (((uint64_t)1) << i)))
+            continue;
+        if (bounds_guard_covers(&be->guards.at(i), elem_ptr->array_ptr)) {
+            elem_ptr->safety_check_on = false;
+            return;
+        }
+    }
+}
+
+static uint64_t bounds_transfer(BoundsElide *be, IrBasicBlock *bb, uint64_t facts, bool elide) {
+    be->index_loads.resize(0);
+    for (size_t instr_i = 0; instr_i < bb->instruction_list.length; instr_i += 1) {
+        IrInstruction *instruction = bb->instruction_list.at(instr_i);
+        VariableTableEntry *stored_var = bounds_store_target(instruction);
+        if (stored_var) {
+            facts &= ~bounds_var_guards(be, stored_var, false);
+        } else if (elide && instruction->id == IrInstructionIdLoadPtr) {
+            VariableTableEntry *loaded_var = bounds_loaded_var(instruction);
+            uint64_t index_facts = loaded_var ? (facts & bounds_var_guards(be, loaded_var, true)) : 0;
+            if (index_facts) {
+                BoundsIndexLoad *index_load = be->index_loads.add_one();
+                index_load->load = instruction;
+                index_load->facts = index_facts;
+            }
+        } else if (elide && instruction->id == IrInstructionIdElemPtr) {
+            bounds_elide_elem_ptr(be, (IrInstructionElemPtr *)instruction, facts);
+        }
+    }
+    return facts;
+}
+
+static bool bounds_flow_to(BoundsElide *be, IrBasicBlock *dest_block, uint64_t facts) {
+    size_t dest_i = be->block_table.get(dest_block);
+    uint64_t new_facts = be->block_facts.at(dest_i) & facts;
+    if (new_facts == be->block_facts.at(dest_i))
+        return false;
+    be->block_facts.at(dest_i) = new_facts;
+    return true;
+}
+
+static bool bounds_flow_out(BoundsElide *be, IrBasicBlock *bb, uint64_t facts) {
+    IrInstruction *terminator = bb->instruction_list.last();
+    size_t guard_index = be->block_guard.at(be->block_table.get(bb));
+    bool changed = false;
+    switch (terminator->id) {
+        case IrInstructionIdBr:
+            changed = bounds_flow_to(be, ((IrInstructionBr *)terminator)->dest_block, facts) || changed;
+            break;
+        case IrInstructionIdCondBr:
+            {
+                IrInstructionCondBr *cond_br = (IrInstructionCondBr *)terminator;
+                uint64_t then_facts = facts;
+                if (guard_index != SIZE_MAX)
+                    then_facts |= ((uint64_t)1) << guard_index;
+                changed = bounds_flow_to(be, cond_br->then_block, then_facts) || changed;
+                changed = bounds_flow_to(be, cond_br->else_block, facts) || changed;
+                break;
+            }
+        case IrInstructionIdSwitchBr:
+            {
+                IrInstructionSwitchBr *switch_br = (IrInstructionSwitchBr *)terminator;
+                for (size_t i = 0; i < switch_br->case_count; i += 1) {
+                    changed = bounds_flow_to(be, switch_br->cases[i].block, facts) || changed;
+                }
+                changed = bounds_flow_to(be, switch_br->else_block, facts) || changed;
+                break;
+            }
+        default:
+            break;
+    }
+    return changed;
+}
+
+void ir_elide_bounds_checks(IrExecutable *executable) {
+    BoundsElide be = {};
+    be.var_table.init(16);
+    be.block_table.init(16);
+
+    for (size_t block_i = 0; block_i < executable->basic_block_list.length; block_i += 1) {
+        IrBasicBlock *bb = executable->basic_block_list.at(block_i);
+        be.block_table.put(bb, block_i);
+        for (size_t instr_i = 0; instr_i < bb->instruction_list.length; instr_i += 1) {
+            bounds_scan_var_uses(&be, bb->instruction_list.at(instr_i));
+        }
+    }
+
+    for (size_t block_i = 0; block_i < executable->basic_block_list.length; block_i += 1) {
+        IrBasicBlock *bb = executable->basic_block_list.at(block_i);
+        IrInstruction *terminator = bb->instruction_list.last();
+        size_t guard_index = SIZE_MAX;
+        if (terminator->id == IrInstructionIdCondBr)
+            guard_index = bounds_match_guard(&be, bb, (IrInstructionCondBr *)terminator);
+        be.block_guard.append(guard_index);
+    }
+
+    if (be.guards.length != 0) {
+        // Every block other than the entry block starts out assuming all facts,
+        // and we iterate until the intersection over the predecessors settles.
+        for (size_t block_i = 0; block_i < executable->basic_block_list.length; block_i += 1) {
+            be.block_facts.append((block_i == 0) ? 0 : UINT64_MAX);
+        }
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            for (size_t block_i = 0; block_i < executable->basic_block_list.length; block_i += 1) {
+                IrBasicBlock *bb = executable->basic_block_list.at(block_i);
+                uint64_t facts = bounds_transfer(&be, bb, be.block_facts.at(block_i), false);
+                changed = bounds_flow_out(&be, bb, facts) || changed;
+            }
+        }
+        for (size_t block_i = 0; block_i < executable->basic_block_list.length; block_i += 1) {
+            IrBasicBlock *bb = executable->basic_block_list.at(block_i);
+            bounds_transfer(&be, bb, be.block_facts.at(block_i), true);
+        }
+    }
+
+    be.var_table.deinit();
+    be.block_table.deinit();
+    be.vars.deinit();
+    be.block_guard.deinit();
+    be.block_facts.deinit();
+    be.guards.deinit();
+    be.index_loads.deinit();
+}
+
+// Branches end a basic block, and so does any instruction which never returns,
+// such as a call to a function with return type unreachable.
+static bool ir_ends_basic_block(IrInstruction *instruction) {
+    switch (instruction->id) {
+        case IrInstructionIdBr:
+        case IrInstructionIdCondBr:
+        case IrInstructionIdSwitchBr:
+        case IrInstructionIdReturn:
+        case IrInstructionIdUnreachable:
+            return true;
+        default:
+            return instr_is_unreachable(instruction);
+    }
+}
+
+static void ir_verify_fail(IrExecutable *executable, IrInstruction *instruction, const char *msg) {
+    const char *name = executable->fn_entry ? buf_ptr(&executable->fn_entry->symbol_name) : "(unknown)";
+    zig_panic("invalid IR in %s: instruction #%zu: %s", name, instruction->debug_id, msg);
+}
+
+static void ir_verify_branch_target(IrExecutable *executable,
+        HashMap<const void *, size_t, ptr_hash, ptr_eq> *block_table,
+        IrInstruction *instruction, IrBasicBlock *dest_block)
+{
+    if (!dest_block || !block_table->maybe_get(dest_block))
+        ir_verify_fail(executable, instruction, "branch to a basic block outside the function");
+}
+
+// A cheap structural check of analyzed IR, which catches the kind of mistakes
+// that otherwise only show up later as an LLVM verifier failure or a crash in
+// codegen. Every basic block must end in exactly one terminator, every branch
+// must target a block of this executable, and every runtime operand must be
+// an instruction of this executable which, within the same block, comes first.
+void ir_verify(IrExecutable *executable) {
+    if (executable->basic_block_list.length == 0)
+        zig_panic("invalid IR: executable has no basic blocks");
+
+    HashMap<const void *, size_t, ptr_hash, ptr_eq> block_table = {};
+    HashMap<const void *, size_t, ptr_hash, ptr_eq> instruction_table = {};
+    block_table.init(16);
+    instruction_table.init(64);
+    for (size_t block_i = 0; block_i < executable->basic_block_list.length; block_i += 1) {
+        IrBasicBlock *bb = executable->basic_block_list.at(block_i);
+        block_table.put(bb, block_i);
+    }
+
+    for (size_t block_i = 0; block_i < executable->basic_block_list.length; block_i += 1) {
+        IrBasicBlock *bb = executable->basic_block_list.at(block_i);
+        if (bb->instruction_list.length == 0)
+            zig_panic("invalid IR: basic block %s_%zu is empty", bb->name_hint, bb->debug_id);
+
+        for (size_t instr_i = 0; instr_i < bb->instruction_list.length; instr_i += 1) {
+            IrInstruction *instruction = bb->instruction_list.at(instr_i);
+            if (instruction->id == IrInstructionIdInvalid)
+                ir_verify_fail(executable, instruction, "invalid instruction");
+            bool is_last = (instr_i + 1 == bb->instruction_list.length);
+            if (ir_ends_basic_block(instruction) != is_last) {
+                ir_verify_fail(executable, instruction, is_last ?
+                        "basic block does not end with a terminator" :
+                        "terminator in the middle of a basic block");
+            }
+
+            for (size_t dep_i = 0; ; dep_i += 1) {
+                IrInstruction *dep_instruction = ir_instruction_get_dep(instruction, dep_i);
+                if (dep_instruction == nullptr)
+                    break;
+                if (dep_instruction->id == IrInstructionIdInvalid)
+                    ir_verify_fail(executable, instruction, "operand is an invalid instruction");
+                if (instr_is_comptime(dep_instruction))
+                    continue;
+                auto entry = instruction_table.maybe_get(dep_instruction);
+                if (entry)
+                    continue;
+                // Phi operands may come from later in the same block by way of a back edge.
+                if (instruction->id == IrInstructionIdPhi && dep_instruction->owner_bb == bb)
+                    continue;
+                if (dep_instruction->owner_bb == bb || !dep_instruction->owner_bb ||
+                    !block_table.maybe_get(dep_instruction->owner_bb))
+                {
+                    ir_verify_fail(executable, instruction, "operand is not defined before it is used");
+                }
+            }
+
+            switch (instruction->id) {
+                case IrInstructionIdBr:
+                    ir_verify_branch_target(executable, &block_table, instruction,
+                            ((IrInstructionBr *)instruction)->dest_block);
+                    break;
+                case IrInstructionIdCondBr:
+                    ir_verify_branch_target(executable, &block_table, instruction,
+                            ((IrInstructionCondBr *)instruction)->then_block);
+                    ir_verify_branch_target(executable, &block_table, instruction,
+                            ((IrInstructionCondBr *)instruction)->else_block);
+                    break;
+                case IrInstructionIdSwitchBr:
+                    {
+                        IrInstructionSwitchBr *switch_br = (IrInstructionSwitchBr *)instruction;
+                        for (size_t i = 0; i < switch_br->case_count; i += 1) {
+                            ir_verify_branch_target(executable, &block_table, instruction,
+                                    switch_br->cases[i].block);
+                        }
+                        ir_verify_branch_target(executable, &block_table, instruction, switch_br->else_block);
+                        break;
+                    }
+                case IrInstructionIdPhi:
+                    {
+                        IrInstructionPhi *phi = (IrInstructionPhi *)instruction;
+                        for (size_t i = 0; i < phi->incoming_count; i += 1) {
+                            ir_verify_branch_target(executable, &block_table, instruction,
+                                    phi->incoming_blocks[i]);
+                        }
+                        break;
+                    }
+                default:
+                    break;
+            }
+
+            instruction_table.put(instruction, block_i);
+        }
+    }
+
+    block_table.deinit();
+    instruction_table.deinit();
+}
@@ -11,6 +11,8 @@
 #include "codegen.hpp"
 #include "analyze.hpp"
 
+#include <llvm-c/BitWriter.h>
+
 struct LinkJob {
     CodeGen *codegen;
     Buf out_file;
@@ -58,6 +60,8 @@ static Buf *build_o(CodeGen *parent_gen, const char *oname) {
 
     codegen_set_verbose(child_gen, parent_gen->verbose);
     codegen_set_errmsg_color(child_gen, parent_gen->err_color);
+    codegen_set_emit(child_gen, parent_gen->emit_asm, parent_gen->emit_llvm_ir, parent_gen->emit_llvm_bc);
+    codegen_set_verify_llvm(child_gen, parent_gen->verify_llvm);
 
     codegen_set_mmacosx_version_min(child_gen, parent_gen->mmacosx_version_min);
     codegen_set_mios_version_min(child_gen, parent_gen->mios_version_min);
@@ -768,6 +772,50 @@ static void ensure_we_have_linker_path(CodeGen *g) {
     }
 }
 
+// Writes the requested --emit artifacts next to the object file, replacing
+// its extension.
+static void emit_artifacts(CodeGen *g, Buf *out_file_o) {
+    if (!g->emit_asm && !g->emit_llvm_ir && !g->emit_llvm_bc)
+        return;
+
+    Buf *base_path = buf_create_from_buf(out_file_o);
+    const char *o_ext = get_o_file_extension(g);
+    size_t o_ext_len = strlen(o_ext);
+    if (buf_len(base_path) > o_ext_len &&
+        memcmp(buf_ptr(base_path) + buf_len(base_path) - o_ext_len, o_ext, o_ext_len) == 0)
+    {
+        buf_resize(base_path, buf_len(base_path) - o_ext_len);
+    }
+
+    // Emitting code runs the code generation passes, which modify the
+    // module, so everything here is written before the object file and the
+    // assembly comes from a copy of the module.
+    if (g->emit_llvm_ir) {
+        Buf *ll_path = buf_sprintf("%s.ll", buf_ptr(base_path));
+        char *err_msg = nullptr;
+        if (LLVMPrintModuleToFile(g->module, buf_ptr(ll_path), &err_msg)) {
+            zig_panic("unable to write LLVM IR file: %s", err_msg);
+        }
+    }
+    if (g->emit_llvm_bc) {
+        Buf *bc_path = buf_sprintf("%s.bc", buf_ptr(base_path));
+        if (LLVMWriteBitcodeToFile(g->module, buf_ptr(bc_path))) {
+            zig_panic("unable to write LLVM bitcode file: %s", buf_ptr(bc_path));
+        }
+    }
+    if (g->emit_asm) {
+        Buf *asm_path = buf_sprintf("%s.s", buf_ptr(base_path));
+        LLVMModuleRef asm_module = LLVMCloneModule(g->module);
+        char *err_msg = nullptr;
+        if (LLVMTargetMachineEmitToFile(g->target_machine, asm_module, buf_ptr(asm_path),
+                    LLVMAssemblyFile, &err_msg))
+        {
+            zig_panic("unable to write assembly file: %s", err_msg);
+        }
+        LLVMDisposeModule(asm_module);
+    }
+}
+
 void codegen_link(CodeGen *g, const char *out_file) {
     LinkJob lj = {0};
     lj.codegen = g;
@@ -784,7 +832,8 @@ void codegen_link(CodeGen *g, const char *out_file) {
             fprintf(stderr, "---------------\n");
         }
 
-        ZigLLVMOptimizeModule(g->target_machine, g->module);
+        ZigLLVMOptimizeModule(g->target_machine, g->module,
+                g->opt_remarks_path ? buf_ptr(g->opt_remarks_path) : nullptr);
 
         if (g->verbose) {
             LLVMDumpModule(g->module);
@@ -811,6 +860,8 @@ void codegen_link(CodeGen *g, const char *out_file) {
         buf_append_str(&lj.out_file_o, o_ext);
     }
 
+    emit_artifacts(g, &lj.out_file_o);
+
     char *err_msg = nullptr;
     if (LLVMTargetMachineEmitToFile(g->target_machine, g->module, buf_ptr(&lj.out_file_o),
                 LLVMObjectFile, &err_msg))
@@ -57,6 +57,10 @@ static int usage(const char *arg0) {
         "  -framework [name]            (darwin only) link against framework\n"
         "  --check-unused               perform semantic analysis on unused declarations\n"
         "  --linker-script [path]       use a custom linker script\n"
+        "  --opt-remarks [file]         write optimization remarks to file (requires --release)\n"
+        "  --emit [asm|llvm-ir|llvm-bc] also write assembly, LLVM IR or bitcode next to the object\n"
+        "  --verify-llvm                run the LLVM module verifier (default in debug builds of zig)\n"
+        "  --no-verify-llvm             skip the LLVM module verifier\n"
     , arg0);
     return EXIT_FAILURE;
 }
@@ -142,6 +146,11 @@ int main(int argc, char **argv) {
     const char *mios_version_min = nullptr;
     bool check_unused = false;
     const char *linker_script = nullptr;
+    const char *opt_remarks_path = nullptr;
+    bool emit_asm = false;
+    bool emit_llvm_ir = false;
+    bool emit_llvm_bc = false;
+    int verify_llvm = -1;
 
     for (int i = 1; i < argc; i += 1) {
         char *arg = argv[i];
@@ -163,6 +172,10 @@ int main(int argc, char **argv) {
                 municode = true;
             } else if (strcmp(arg, "-rdynamic") == 0) {
                 rdynamic = true;
+            } else if (strcmp(arg, "--verify-llvm") == 0) {
+                verify_llvm = 1;
+            } else if (strcmp(arg, "--no-verify-llvm") == 0) {
+                verify_llvm = 0;
             } else if (strcmp(arg, "--check-unused") == 0) {
                 check_unused = true;
             } else if (i + 1 >= argc) {
@@ -235,6 +248,19 @@ int main(int argc, char **argv) {
                     frameworks.append(argv[i]);
                 } else if (strcmp(arg, "--linker-script") == 0) {
                     linker_script = argv[i];
+                } else if (strcmp(arg, "--opt-remarks") == 0) {
+                    opt_remarks_path = argv[i];
+                } else if (strcmp(arg, "--emit") == 0) {
+                    if (strcmp(argv[i], "asm") == 0) {
+                        emit_asm = true;
+                    } else if (strcmp(argv[i], "llvm-ir") == 0) {
+                        emit_llvm_ir = true;
+                    } else if (strcmp(argv[i], "llvm-bc") == 0) {
+                        emit_llvm_bc = true;
+                    } else {
+                        fprintf(stderr, "invalid --emit argument: %s\n", argv[i]);
+                        return usage(arg0);
+                    }
                 } else {
                     fprintf(stderr, "Invalid argument: %s\n", arg);
                     return usage(arg0);
@@ -401,6 +427,17 @@ int main(int argc, char **argv) {
                 return EXIT_FAILURE;
             }
 
+            if (opt_remarks_path) {
+                if (!is_release_build) {
+                    fprintf(stderr, "--opt-remarks requires --release\n");
+                    return EXIT_FAILURE;
+                }
+                codegen_set_opt_remarks_path(g, buf_create_from_str(opt_remarks_path));
+            }
+            codegen_set_emit(g, emit_asm, emit_llvm_ir, emit_llvm_bc);
+            if (verify_llvm != -1)
+                codegen_set_verify_llvm(g, verify_llvm == 1);
+
             if (mmacosx_version_min) {
                 codegen_set_mmacosx_version_min(g, buf_create_from_str(mmacosx_version_min));
             }
@@ -36,12 +36,15 @@
 #include <llvm/IR/IRBuilder.h>
 #include <llvm/IR/DIBuilder.h>
 #include <llvm/IR/DiagnosticInfo.h>
+#include <llvm/IR/DiagnosticPrinter.h>
 #include <llvm/Analysis/TargetLibraryInfo.h>
 #include <llvm/Analysis/TargetTransformInfo.h>
 #include <llvm/Transforms/IPO.h>
 #include <llvm/Transforms/IPO/PassManagerBuilder.h>
 #include <llvm/Transforms/Scalar.h>
 
+#include <stdio.h>
+
 using namespace llvm;
 
 void ZigLLVMInitializeLoopStrengthReducePass(LLVMPassRegistryRef R) {
@@ -74,11 +77,161 @@ static void addAddDiscriminatorsPass(const PassManagerBuilder &Builder, legacy::
 }
 
 
-void ZigLLVMOptimizeModule(LLVMTargetMachineRef targ_machine_ref, LLVMModuleRef module_ref) {
+namespace {
+
+struct OptRemarkCounts {
+    std::string fn_name;
+    unsigned inlined;
+    unsigned inline_missed;
+    unsigned vectorized;
+    unsigned vectorize_missed;
+    unsigned unrolled;
+    unsigned unroll_missed;
+    unsigned other_passed;
+    unsigned other_missed;
+};
+
+struct OptRemarkCollector {
+    raw_fd_ostream *yaml_out;
+    StringMap<size_t> fn_index;
+    std::vector<OptRemarkCounts> fn_counts;
+};
+
+} // end anonymous namespace
+
+static void write_yaml_str(raw_ostream &os, StringRef str) {
+    os << '\'';
+    for (char c : str) {
+        if (c == '\'') {
+            os << "''";
+        } else if (c == '\n') {
+            os << ' ';
+        } else {
+            os << c;
+        }
+    }
+    os << '\'';
+}
+
+static OptRemarkCounts *get_opt_remark_counts(OptRemarkCollector *collector, StringRef fn_name) {
+    auto it = collector->fn_index.find(fn_name);
+    if (it != collector->fn_index.end())
+        return &collector->fn_counts[it->second];
+
+    collector->fn_index[fn_name] = collector->fn_counts.size();
+    OptRemarkCounts counts = {};
+    counts.fn_name = fn_name.str();
+    collector->fn_counts.push_back(counts);
+    return &collector->fn_counts.back();
+}
+
+static void opt_remark_diagnostic_handler(const DiagnosticInfo &DI, void *context) {
+    OptRemarkCollector *collector = reinterpret_cast<OptRemarkCollector *>(context);
+
+    const char *yaml_tag;
+    bool passed;
+    switch (DI.getKind()) {
+        case DK_OptimizationRemark:
+            yaml_tag = "!Passed";
+            passed = true;
+            break;
+        case DK_OptimizationRemarkMissed:
+        case DK_OptimizationFailure:
+            yaml_tag = "!Missed";
+            passed = false;
+            break;
+        case DK_OptimizationRemarkAnalysis:
+        case DK_OptimizationRemarkAnalysisFPCommute:
+        case DK_OptimizationRemarkAnalysisAliasing:
+            yaml_tag = "!Analysis";
+            passed = false;
+            break;
+        default:
+            {
+                // Not an optimization remark; report it the way LLVM would without a handler.
+                DiagnosticPrinterRawOStream printer(errs());
+                errs() << LLVMContext::getDiagnosticMessagePrefix(DI.getSeverity()) << ": ";
+                DI.print(printer);
+                errs() << "\n";
+                if (DI.getSeverity() == DS_Error)
+                    exit(1);
+                return;
+            }
+    }
+
+    const DiagnosticInfoOptimizationBase &remark = static_cast<const DiagnosticInfoOptimizationBase &>(DI);
+    StringRef pass_name = remark.getPassName();
+    StringRef fn_name = remark.getFunction().getName();
+
+    OptRemarkCounts *counts = get_opt_remark_counts(collector, fn_name);
+    if (pass_name == "inline") {
+        if (passed) counts->inlined += 1; else counts->inline_missed += 1;
+    } else if (pass_name == "loop-vectorize" || pass_name == "slp-vectorizer") {
+        if (passed) counts->vectorized += 1; else counts->vectorize_missed += 1;
+    } else if (pass_name == "loop-unroll") {
+        if (passed) counts->unrolled += 1; else counts->unroll_missed += 1;
+    } else {
+        if (passed) counts->other_passed += 1; else counts->other_missed += 1;
+    }
+
+    if (!collector->yaml_out)
+        return;
+
+    raw_fd_ostream &os = *collector->yaml_out;
+    os << "--- " << yaml_tag << "\n";
+    os << "Pass:            "; write_yaml_str(os, pass_name); os << "\n";
+    if (remark.isLocationAvailable()) {
+        StringRef file_name;
+        unsigned line;
+        unsigned column;
+        remark.getLocation(&file_name, &line, &column);
+        os << "DebugLoc:        { File: "; write_yaml_str(os, file_name);
+        os << ", Line: " << line << ", Column: " << column << " }\n";
+    }
+    os << "Function:        "; write_yaml_str(os, fn_name); os << "\n";
+    os << "Message:         "; write_yaml_str(os, remark.getMsg().str()); os << "\n";
+    os << "...\n";
+}
+
+static void print_opt_remark_summary(OptRemarkCollector *collector) {
+    fprintf(stderr, "\nOptimization Remarks:\n");
+    fprintf(stderr, "----------------------\n");
+    for (const OptRemarkCounts &counts : collector->fn_counts) {
+        fprintf(stderr, "%s: inlined %u (missed %u), vectorized %u (missed %u), unrolled %u (missed %u)",
+                counts.fn_name.c_str(),
+                counts.inlined, counts.inline_missed,
+                counts.vectorized, counts.vectorize_missed,
+                counts.unrolled, counts.unroll_missed);
+        if (counts.other_passed != 0 || counts.other_missed != 0) {
+            fprintf(stderr, ", other %u (missed %u)", counts.other_passed, counts.other_missed);
+        }
+        fprintf(stderr, "\n");
+    }
+}
+
+void ZigLLVMOptimizeModule(LLVMTargetMachineRef targ_machine_ref, LLVMModuleRef module_ref,
+        const char *opt_remarks_path)
+{
     TargetMachine* target_machine = reinterpret_cast<TargetMachine*>(targ_machine_ref);
     Module* module = unwrap(module_ref);
     TargetLibraryInfoImpl tlii(Triple(module->getTargetTriple()));
 
+    LLVMContext &llvm_context = module->getContext();
+    LLVMContext::DiagnosticHandlerTy old_diag_handler = llvm_context.getDiagnosticHandler();
+    void *old_diag_context = llvm_context.getDiagnosticContext();
+
+    OptRemarkCollector remark_collector;
+    remark_collector.yaml_out = nullptr;
+    if (opt_remarks_path) {
+        std::error_code err_code;
+        remark_collector.yaml_out = new raw_fd_ostream(opt_remarks_path, err_code, sys::fs::F_Text);
+        if (err_code) {
+            fprintf(stderr, "unable to open '%s': %s\n", opt_remarks_path, err_code.message().c_str());
+            exit(1);
+        }
+        llvm_context.setDiagnosticHandler(opt_remark_diagnostic_handler, &remark_collector, false);
+    }
+
     PassManagerBuilder *PMBuilder = new PassManagerBuilder();
     PMBuilder->OptLevel = target_machine->getOptLevel();
     PMBuilder->SizeLevel = 0;
@@ -127,6 +280,12 @@ void ZigLLVMOptimizeModule(LLVMTargetMachineRef targ_machine_ref, LLVMModuleRef
 
     // run per module optimization passes
     MPM->run(*module);
+
+    if (opt_remarks_path) {
+        llvm_context.setDiagnosticHandler(old_diag_handler, old_diag_context, false);
+        delete remark_collector.yaml_out;
+        print_opt_remark_summary(&remark_collector);
+    }
 }
 
 LLVMValueRef ZigLLVMBuildCall(LLVMBuilderRef B, LLVMValueRef Fn, LLVMValueRef *Args,
@@ -0,0 +1,56 @@
+// Atomic operations built from @cmpxchg and @fence. T is an integer, bool or
+// pointer type no wider than usize, so that aligned plain loads and stores
+// of it are not torn.
+
+const debug = @import("debug.zig");
+const assert = debug.assert;
+
+/// Reads *ptr, ordered before the memory operations which follow it.
+pub inline fn load(comptime T: type, ptr: &const T) -> T {
+    const value = *ptr;
+    @fence(AtomicOrder.Acquire);
+    return value;
+}
+
+/// Writes *ptr, ordered after the memory operations which come before it.
+pub inline fn store(comptime T: type, ptr: &T, value: T) {
+    @fence(AtomicOrder.Release);
+    *ptr = value;
+}
+
+/// Replaces *ptr with value and returns what it was.
+pub fn swap(comptime T: type, ptr: &T, value: T) -> T {
+    while (true) {
+        const old = *ptr;
+        if (@cmpxchg(ptr, old, value, AtomicOrder.SeqCst, AtomicOrder.SeqCst)) return old;
+    }
+}
+
+/// Adds delta to *ptr, wrapping around on overflow, and returns what *ptr was.
+pub fn fetchAdd(comptime T: type, ptr: &T, delta: T) -> T {
+    while (true) {
+        const old = *ptr;
+        if (@cmpxchg(ptr, old, old +% delta, AtomicOrder.SeqCst, AtomicOrder.SeqCst)) return old;
+    }
+}
+
+/// Subtracts delta from *ptr, wrapping around on overflow, and returns what
+/// *ptr was.
+pub fn fetchSub(comptime T: type, ptr: &T, delta: T) -> T {
+    while (true) {
+        const old = *ptr;
+        if (@cmpxchg(ptr, old, old -% delta, AtomicOrder.SeqCst, AtomicOrder.SeqCst)) return old;
+    }
+}
+
+fn testFetchAdd() {
+    @setFnTest(this);
+
+    var x: u32 = @maxValue(u32);
+    assert(fetchAdd(u32, &x, 2) == @maxValue(u32));
+    assert(load(u32, &x) == 1);
+    assert(fetchSub(u32, &x, 1) == 1);
+    assert(swap(u32, &x, 1234) == 0);
+    store(u32, &x, 5);
+    assert(x == 5);
+}
@@ -10,7 +10,8 @@ const want_start_symbol = switch(@compileVar("os")) {
 const want_main_symbol = !want_start_symbol;
 
 const exit = switch(@compileVar("os")) {
-    Os.linux => std.linux.exit,
+    // other threads would keep the process alive after exit
+    Os.linux => std.linux.exit_group,
     Os.darwin => std.darwin.exit,
 };
 
@@ -44,6 +45,10 @@ fn callMain() -> %void {
 }
 
 fn callMainAndExit() -> unreachable {
+    switch (@compileVar("os")) {
+        Os.linux => std.thread.initMainThread(),
+        else => {},
+    }
     callMain() %% exit(1);
     exit(0);
 }
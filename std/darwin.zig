@@ -8,6 +8,7 @@ const errno = @import("errno.zig");
 
 pub const O_LARGEFILE = 0x0000;
 pub const O_RDONLY = 0x0000;
+pub const O_WRONLY = 0x0001;
 
 pub const SEEK_SET = 0x0;
 pub const SEEK_CUR = 0x1;
@@ -63,6 +64,10 @@ pub fn write(fd: i32, buf: &const u8, count: usize) -> usize {
     arch.syscall3(arch.SYS_write, usize(fd), usize(buf), count)
 }
 
+pub fn writev(fd: i32, iov: &const iovec_const, count: usize) -> usize {
+    arch.syscall3(arch.SYS_writev, usize(fd), usize(iov), count)
+}
+
 pub fn close(fd: i32) -> usize {
     arch.syscall1(arch.SYS_close, usize(fd))
 }
@@ -86,6 +91,11 @@ pub fn lseek(fd: i32, offset: usize, ref_pos: usize) -> usize {
     arch.syscall3(arch.SYS_lseek, usize(fd), offset, ref_pos)
 }
 
+pub const iovec_const = extern struct {
+    iov_base: &const u8,
+    iov_len: usize,
+};
+
 pub const stat = arch.stat;
 pub const timespec = arch.timespec;
 
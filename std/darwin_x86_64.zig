@@ -18,6 +18,7 @@ pub const SYS_open = 0x2000005;
 pub const SYS_close = 0x2000006;
 pub const SYS_kill = 0x2000025;
 pub const SYS_getpid = 0x2000030;
+pub const SYS_writev = 0x2000079;
 pub const SYS_fstat = 0x20000BD;
 pub const SYS_lseek = 0x20000C7;
 
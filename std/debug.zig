@@ -4,6 +4,8 @@ const os = @import("os.zig");
 const elf = @import("elf.zig");
 const DW = @import("dwarf.zig");
 const List = @import("list.zig").List;
+const sort = @import("sort.zig");
+const linux = @import("linux.zig");
 
 error MissingDebugInfo;
 error InvalidDebugInfo;
@@ -42,26 +44,7 @@ pub fn printStackTrace() -> %void {
 pub fn writeStackTrace(out_stream: &io.OutStream) -> %void {
     switch (@compileVar("object_format")) {
         ObjectFormat.elf => {
-            var stack_trace = ElfStackTrace {
-                .self_exe_stream = undefined,
-                .elf = undefined,
-                .debug_info = undefined,
-                .debug_abbrev = undefined,
-                .debug_str = undefined,
-                .abbrev_table_list = List(AbbrevTableHeader).init(&global_allocator),
-                .compile_unit_list = List(CompileUnit).init(&global_allocator),
-            };
-            const st = &stack_trace;
-            %return io.openSelfExe(&st.self_exe_stream);
-            defer st.self_exe_stream.close() %% {};
-
-            %return st.elf.openStream(&global_allocator, &st.self_exe_stream);
-            defer st.elf.close();
-
-            st.debug_info = (%return st.elf.findSection(".debug_info")) ?? return error.MissingDebugInfo;
-            st.debug_abbrev = (%return st.elf.findSection(".debug_abbrev")) ?? return error.MissingDebugInfo;
-            st.debug_str = (%return st.elf.findSection(".debug_str")) ?? return error.MissingDebugInfo;
-            %return scanAllCompileUnits(st);
+            const st = %return getSelfDebugInfo();
 
             %return out_stream.printf("(...work-in-progress stack unwinding code follows...)\n");
 
@@ -90,15 +73,117 @@ pub fn writeStackTrace(out_stream: &io.OutStream) -> %void {
 }
 
 const ElfStackTrace = struct {
-    self_exe_stream: io.InStream,
-    elf: elf.Elf,
-    debug_info: &elf.SectionHeader,
-    debug_abbrev: &elf.SectionHeader,
-    debug_str: &elf.SectionHeader,
+    /// The whole executable, mapped read only.
+    self_exe_file: []const u8,
+    is_big_endian: bool,
+    debug_info: []const u8,
+    debug_abbrev: []const u8,
+    debug_str: []const u8,
     abbrev_table_list: List(AbbrevTableHeader),
+    /// Sorted by pc_start, so that findCompileUnit can do a binary search.
     compile_unit_list: List(CompileUnit),
 };
 
+/// The debug info of the running executable is loaded the first time a stack
+/// trace is written, and kept for the rest of the process.
+var self_debug_info: ElfStackTrace = undefined;
+var self_debug_info_loaded = false;
+
+fn getSelfDebugInfo() -> %&ElfStackTrace {
+    if (!self_debug_info_loaded) {
+        %return openSelfDebugInfo(&self_debug_info);
+        self_debug_info_loaded = true;
+    }
+    return &self_debug_info;
+}
+
+fn openSelfDebugInfo(st: &ElfStackTrace) -> %void {
+    var self_exe_stream: io.InStream = undefined;
+    %return io.openSelfExe(&self_exe_stream);
+    defer self_exe_stream.close() %% {};
+
+    var self_exe_elf: elf.Elf = undefined;
+    %return self_exe_elf.openStream(&global_allocator, &self_exe_stream);
+    defer self_exe_elf.close();
+
+    const debug_info = (%return self_exe_elf.findSection(".debug_info")) ?? return error.MissingDebugInfo;
+    const debug_abbrev = (%return self_exe_elf.findSection(".debug_abbrev")) ?? return error.MissingDebugInfo;
+    const debug_str = (%return self_exe_elf.findSection(".debug_str")) ?? return error.MissingDebugInfo;
+
+    // The mapping stays valid after the file is closed.
+    st.self_exe_file = %return mapFile(&self_exe_stream);
+    st.is_big_endian = self_exe_elf.is_big_endian;
+    st.debug_info = %return getSectionBytes(st.self_exe_file, debug_info);
+    st.debug_abbrev = %return getSectionBytes(st.self_exe_file, debug_abbrev);
+    st.debug_str = %return getSectionBytes(st.self_exe_file, debug_str);
+    st.abbrev_table_list = List(AbbrevTableHeader).init(&global_allocator);
+    st.compile_unit_list = List(CompileUnit).init(&global_allocator);
+
+    %return scanAllCompileUnits(st);
+    sort.sort(CompileUnit, st.compile_unit_list.toSlice(), compileUnitPcStartAsc);
+}
+
+fn mapFile(stream: &io.InStream) -> %[]const u8 {
+    const size = %return stream.getEndPos();
+    const addr = linux.mmap(null, size, linux.MMAP_PROT_READ, linux.MMAP_MAP_PRIVATE, stream.fd, 0);
+    if (linux.getErrno(addr) > 0)
+        return error.MissingDebugInfo;
+    return (&const u8)(addr)[0...size];
+}
+
+fn getSectionBytes(file: []const u8, section: &const elf.SectionHeader) -> %[]const u8 {
+    if (section.offset > file.len || section.size > file.len - section.offset)
+        return error.InvalidDebugInfo;
+    const start = usize(section.offset);
+    return file[start...start + usize(section.size)];
+}
+
+/// Reads DWARF data out of a section of the mapped executable. The slices it
+/// returns point into the mapping.
+const DwarfReader = struct {
+    bytes: []const u8,
+    pos: usize,
+
+    fn init(bytes: []const u8, pos: u64) -> %DwarfReader {
+        if (pos > bytes.len)
+            return error.InvalidDebugInfo;
+        return DwarfReader {
+            .bytes = bytes,
+            .pos = usize(pos),
+        };
+    }
+
+    fn readBytes(self: &DwarfReader, n: u64) -> %[]const u8 {
+        if (n > self.bytes.len - self.pos)
+            return error.InvalidDebugInfo;
+        const result = self.bytes[self.pos...self.pos + usize(n)];
+        self.pos += usize(n);
+        return result;
+    }
+
+    fn readByte(self: &DwarfReader) -> %u8 {
+        if (self.pos == self.bytes.len)
+            return error.InvalidDebugInfo;
+        const result = self.bytes[self.pos];
+        self.pos += 1;
+        return result;
+    }
+
+    fn readInt(self: &DwarfReader, is_be: bool, comptime T: type) -> %T {
+        return mem.readInt(%return self.readBytes(@sizeOf(T)), T, is_be);
+    }
+
+    fn readIntLe(self: &DwarfReader, comptime T: type) -> %T {
+        return self.readInt(false, T);
+    }
+
+    fn readVarInt(self: &DwarfReader, is_be: bool, comptime T: type, size: usize) -> %T {
+        if (size > @sizeOf(T))
+            return error.InvalidDebugInfo;
+        return mem.readInt(%return self.readBytes(size), T, is_be);
+    }
+};
+
 const CompileUnit = struct {
     is_64: bool,
     die: &Die,
@@ -128,20 +213,20 @@ const AbbrevAttr = struct {
 
 const FormValue = enum {
     Address: u64,
-    Block: []u8,
+    Block: []const u8,
     Const: Constant,
-    ExprLoc: []u8,
+    ExprLoc: []const u8,
     Flag: bool,
     SecOffset: u64,
-    Ref: []u8,
+    Ref: []const u8,
     RefAddr: u64,
     RefSig8: u64,
-    String: []u8,
+    String: []const u8,
     StrPtr: u64,
 };
 
 const Constant = struct {
-    payload: []u8,
+    payload: []const u8,
     signed: bool,
 
     fn asUnsignedLe(self: &const Constant) -> %u64 {
@@ -187,7 +272,7 @@ const Die = struct {
         };
     }
 
-    fn getAttrString(self: &const Die, st: &ElfStackTrace, id: u64) -> %[]u8 {
+    fn getAttrString(self: &const Die, st: &ElfStackTrace, id: u64) -> %[]const u8 {
         const form_value = self.getAttr(id) ?? return error.InvalidDebugInfo;
         return switch (*form_value) {
             FormValue.String => |value| value,
@@ -197,48 +282,35 @@ const Die = struct {
     }
 };
 
-fn readString(in_stream: &io.InStream) -> %[]u8 {
-    var buf = List(u8).init(&global_allocator);
-    while (true) {
-        const byte = %return in_stream.readByte();
-        if (byte == 0)
-            break;
-        %return buf.append(byte);
-    }
-    return buf.items;
+fn readString(in_stream: &DwarfReader) -> %[]const u8 {
+    const start = in_stream.pos;
+    while ((%return in_stream.readByte()) != 0) {}
+    return in_stream.bytes[start...in_stream.pos - 1];
 }
 
-fn getString(st: &ElfStackTrace, offset: u64) -> %[]u8 {
-    const pos = st.debug_str.offset + offset;
-    %return st.self_exe_stream.seekTo(pos);
-    return readString(&st.self_exe_stream);
+fn getString(st: &ElfStackTrace, offset: u64) -> %[]const u8 {
+    var in_stream = %return DwarfReader.init(st.debug_str, offset);
+    return readString(&in_stream);
 }
 
-fn readAllocBytes(in_stream: &io.InStream, size: usize) -> %[]u8 {
-    const buf = %return global_allocator.alloc(u8, size);
-    %defer global_allocator.free(buf);
-    %return in_stream.read(buf);
-    return buf;
-}
-
-fn parseFormValueBlockLen(in_stream: &io.InStream, size: usize) -> %FormValue {
-    const buf = %return readAllocBytes(in_stream, size);
+fn parseFormValueBlockLen(in_stream: &DwarfReader, size: usize) -> %FormValue {
+    const buf = %return in_stream.readBytes(size);
     return FormValue.Block { buf };
 }
 
-fn parseFormValueBlock(in_stream: &io.InStream, size: usize) -> %FormValue {
+fn parseFormValueBlock(in_stream: &DwarfReader, size: usize) -> %FormValue {
     const block_len = %return in_stream.readVarInt(false, usize, size);
     return parseFormValueBlockLen(in_stream, block_len);
 }
 
-fn parseFormValueConstant(in_stream: &io.InStream, signed: bool, size: usize) -> %FormValue {
+fn parseFormValueConstant(in_stream: &DwarfReader, signed: bool, size: usize) -> %FormValue {
     FormValue.Const { Constant {
         .signed = signed,
-        .payload = %return readAllocBytes(in_stream, size),
+        .payload = %return in_stream.readBytes(size),
     }}
 }
 
-fn parseFormValueDwarfOffsetSize(in_stream: &io.InStream, is_64: bool) -> %u64 {
+fn parseFormValueDwarfOffsetSize(in_stream: &DwarfReader, is_64: bool) -> %u64 {
     return if (is_64) {
         %return in_stream.readIntLe(u64)
     } else {
@@ -246,7 +318,7 @@ fn parseFormValueDwarfOffsetSize(in_stream: &io.InStream, is_64: bool) -> %u64 {
     };
 }
 
-fn parseFormValueTargetAddrSize(in_stream: &io.InStream) -> %u64 {
+fn parseFormValueTargetAddrSize(in_stream: &DwarfReader) -> %u64 {
     return if (@sizeOf(usize) == 4) {
         u64(%return in_stream.readIntLe(u32))
     } else if (@sizeOf(usize) == 8) {
@@ -256,17 +328,17 @@ fn parseFormValueTargetAddrSize(in_stream: &io.InStream) -> %u64 {
     };
 }
 
-fn parseFormValueRefLen(in_stream: &io.InStream, size: usize) -> %FormValue {
-    const buf = %return readAllocBytes(in_stream, size);
+fn parseFormValueRefLen(in_stream: &DwarfReader, size: usize) -> %FormValue {
+    const buf = %return in_stream.readBytes(size);
     return FormValue.Ref { buf };
 }
 
-fn parseFormValueRef(in_stream: &io.InStream, comptime T: type) -> %FormValue {
+fn parseFormValueRef(in_stream: &DwarfReader, comptime T: type) -> %FormValue {
     const block_len = %return in_stream.readIntLe(T);
     return parseFormValueRefLen(in_stream, block_len);
 }
 
-fn parseFormValue(in_stream: &io.InStream, form_id: u64, is_64: bool) -> %FormValue {
+fn parseFormValue(in_stream: &DwarfReader, form_id: u64, is_64: bool) -> %FormValue {
     return switch (form_id) {
         DW.FORM_addr => FormValue.Address { %return parseFormValueTargetAddrSize(in_stream) },
         DW.FORM_block1 => parseFormValueBlock(in_stream, 1),
@@ -287,7 +359,7 @@ fn parseFormValue(in_stream: &io.InStream, form_id: u64, is_64: bool) -> %FormVa
         },
         DW.FORM_exprloc => {
             const size = %return readULeb128(in_stream);
-            const buf = %return readAllocBytes(in_stream, size);
+            const buf = %return in_stream.readBytes(size);
             return FormValue.ExprLoc { buf };
         },
         DW.FORM_flag => FormValue.Flag { (%return in_stream.readByte()) != 0 },
@@ -318,7 +390,7 @@ fn parseFormValue(in_stream: &io.InStream, form_id: u64, is_64: bool) -> %FormVa
     }
 }
 
-fn parseAbbrevTable(in_stream: &io.InStream) -> %AbbrevTable {
+fn parseAbbrevTable(in_stream: &DwarfReader) -> %AbbrevTable {
     var result = AbbrevTable.init(&global_allocator);
     while (true) {
         const abbrev_code = %return readULeb128(in_stream);
@@ -353,10 +425,10 @@ fn getAbbrevTable(st: &ElfStackTrace, abbrev_offset: u64) -> %&const AbbrevTable
             return &header.table;
         }
     }
-    %return st.self_exe_stream.seekTo(st.debug_abbrev.offset + abbrev_offset);
+    var in_stream = %return DwarfReader.init(st.debug_abbrev, abbrev_offset);
     %return st.abbrev_table_list.append(AbbrevTableHeader {
         .offset = abbrev_offset,
-        .table = %return parseAbbrevTable(&st.self_exe_stream),
+        .table = %return parseAbbrevTable(&in_stream),
     });
     return &st.abbrev_table_list.items[st.abbrev_table_list.len - 1].table;
 }
@@ -369,7 +441,7 @@ fn getAbbrevTableEntry(abbrev_table: &const AbbrevTable, abbrev_code: u64) -> ?&
     return null;
 }
 
-fn parseDie(in_stream: &io.InStream, abbrev_table: &const AbbrevTable, is_64: bool) -> %Die {
+fn parseDie(in_stream: &DwarfReader, abbrev_table: &const AbbrevTable, is_64: bool) -> %Die {
     const abbrev_code = %return readULeb128(in_stream);
     const table_entry = getAbbrevTableEntry(abbrev_table, abbrev_code) ?? return error.InvalidDebugInfo;
 
@@ -389,36 +461,32 @@ fn parseDie(in_stream: &io.InStream, abbrev_table: &const AbbrevTable, is_64: bo
 }
 
 fn scanAllCompileUnits(st: &ElfStackTrace) -> %void {
-    const debug_info_end = st.debug_info.offset + st.debug_info.size;
-    var this_unit_offset = st.debug_info.offset;
-    while (this_unit_offset < debug_info_end) {
-        %return st.self_exe_stream.seekTo(this_unit_offset);
+    var this_unit_offset: u64 = 0;
+    while (this_unit_offset < st.debug_info.len) {
+        var in_stream = %return DwarfReader.init(st.debug_info, this_unit_offset);
 
         var is_64: bool = undefined;
-        const unit_length = %return readInitialLength(&st.self_exe_stream, &is_64);
+        const unit_length = %return readInitialLength(&in_stream, &is_64);
         if (unit_length == 0)
             return;
-        const next_offset = unit_length + (if (is_64) usize(12) else usize(4));
+        const next_offset = unit_length + (if (is_64) u64(12) else u64(4));
 
-        const version = %return st.self_exe_stream.readInt(st.elf.is_big_endian, u16);
+        const version = %return in_stream.readInt(st.is_big_endian, u16);
         if (version != 4) return error.InvalidDebugInfo;
 
         const debug_abbrev_offset = if (is_64) {
-            %return st.self_exe_stream.readInt(st.elf.is_big_endian, u64)
+            %return in_stream.readInt(st.is_big_endian, u64)
         } else {
-            %return st.self_exe_stream.readInt(st.elf.is_big_endian, u32)
+            u64(%return in_stream.readInt(st.is_big_endian, u32))
         };
 
-        const address_size = %return st.self_exe_stream.readByte();
+        const address_size = %return in_stream.readByte();
         if (address_size != @sizeOf(usize)) return error.InvalidDebugInfo;
 
-        const compile_unit_pos = %return st.self_exe_stream.getPos();
         const abbrev_table = %return getAbbrevTable(st, debug_abbrev_offset);
 
-        %return st.self_exe_stream.seekTo(compile_unit_pos);
-
         const compile_unit_die = (%return global_allocator.alloc(Die, 1)).ptr;
-        *compile_unit_die = %return parseDie(&st.self_exe_stream, abbrev_table, is_64);
+        *compile_unit_die = %return parseDie(&in_stream, abbrev_table, is_64);
 
         if (compile_unit_die.tag_id != DW.TAG_compile_unit)
             return error.InvalidDebugInfo;
@@ -445,15 +513,32 @@ fn scanAllCompileUnits(st: &ElfStackTrace) -> %void {
     }
 }
 
+fn compileUnitPcStartAsc(a: &const CompileUnit, b: &const CompileUnit) -> sort.Cmp {
+    if (a.pc_start > b.pc_start) sort.Cmp.Greater else if (a.pc_start < b.pc_start) sort.Cmp.Less else sort.Cmp.Equal
+}
+
 fn findCompileUnit(st: &ElfStackTrace, target_address: u64) -> ?&const CompileUnit {
-    for (st.compile_unit_list.toSlice()) |*compile_unit| {
-        if (target_address >= compile_unit.pc_start && target_address < compile_unit.pc_end)
-            return compile_unit;
+    // Find the last compile unit which starts at or before the target address.
+    const compile_units = st.compile_unit_list.toSlice();
+    var left: usize = 0;
+    var right: usize = compile_units.len;
+    while (left < right) {
+        const mid = left + (right - left) / 2;
+        if (compile_units[mid].pc_start <= target_address) {
+            left = mid + 1;
+        } else {
+            right = mid;
+        }
     }
-    return null;
+    if (left == 0)
+        return null;
+    const compile_unit = &compile_units[left - 1];
+    if (target_address >= compile_unit.pc_end)
+        return null;
+    return compile_unit;
 }
 
-fn readInitialLength(in_stream: &io.InStream, is_64: &bool) -> %u64 {
+fn readInitialLength(in_stream: &DwarfReader, is_64: &bool) -> %u64 {
     const first_32_bits = %return in_stream.readIntLe(u32);
     *is_64 = (first_32_bits == 0xffffffff);
     return if (*is_64) {
@@ -464,7 +549,7 @@ fn readInitialLength(in_stream: &io.InStream, is_64: &bool) -> %u64 {
     };
 }
 
-fn readULeb128(in_stream: &io.InStream) -> %u64 {
+fn readULeb128(in_stream: &DwarfReader) -> %u64 {
     var result: u64 = 0;
     var shift: u64 = 0;
 
@@ -484,7 +569,7 @@ fn readULeb128(in_stream: &io.InStream) -> %u64 {
     }
 }
 
-fn readILeb128(in_stream: &io.InStream) -> %i64 {
+fn readILeb128(in_stream: &DwarfReader) -> %i64 {
     var result: i64 = 0;
     var shift: i64 = 0;
 
@@ -1,5 +1,3 @@
-const mem = @import("mem.zig");
-
 pub fn swapIfLe(comptime T: type, x: T) -> T {
     swapIf(false, T, x)
 }
@@ -12,8 +10,8 @@ pub fn swapIf(is_be: bool, comptime T: type, x: T) -> T {
     if (@compileVar("is_big_endian") == is_be) swap(T, x) else x
 }
 
+/// Reverses the order of the bytes of x, with one instruction where the
+/// target has one.
 pub fn swap(comptime T: type, x: T) -> T {
-    var buf: [@sizeOf(T)]u8 = undefined;
-    mem.writeInt(buf[0...], x, false);
-    return mem.readInt(buf, T, true);
+    @bswap(x)
 }
@@ -0,0 +1,260 @@
+const linux = @import("linux.zig");
+const errno = @import("errno.zig");
+const debug = @import("debug.zig");
+const assert = debug.assert;
+const mem = @import("mem.zig");
+
+error Unexpected;
+error NoMem;
+error BadFd;
+error ProcessFdQuotaExceeded;
+error SystemFdQuotaExceeded;
+error NotPollable;
+error AlreadyWatched;
+error NotWatched;
+
+/// How many events a single epoll_wait call can return.
+const max_events = 128;
+
+/// Something which is told when its file descriptor becomes ready. Put the
+/// object the handler works on in context, like Allocator does.
+pub const Watcher = struct {
+    fd: i32,
+    handler: fn(watcher: &Watcher, events: u32),
+    context: ?&mem.Context,
+};
+
+/// Dispatches readiness of file descriptors to Watchers using epoll. Readiness
+/// is edge triggered: a handler is called when its file descriptor becomes
+/// ready, and must read or write until the operation would block, otherwise
+/// it is not called again for data which is already waiting.
+/// Use `init` to initialize this state.
+pub const Loop = struct {
+    epoll_fd: i32,
+    events: [max_events]linux.epoll_event,
+    // events of the current epoll_wait call which are yet to be dispatched
+    pending: []linux.epoll_event,
+    running: bool,
+
+    /// Call deinit to clean up.
+    pub fn init(loop: &Loop) -> %void {
+        const epoll_ret = linux.epoll_create1(linux.EPOLL_CLOEXEC);
+        const epoll_err = linux.getErrno(epoll_ret);
+        if (epoll_err > 0) {
+            return switch (epoll_err) {
+                errno.EMFILE => error.ProcessFdQuotaExceeded,
+                errno.ENFILE => error.SystemFdQuotaExceeded,
+                errno.ENOMEM => error.NoMem,
+                else => error.Unexpected,
+            }
+        }
+        loop.epoll_fd = i32(epoll_ret);
+        loop.pending = loop.events[0...0];
+        loop.running = false;
+    }
+
+    pub fn deinit(loop: &Loop) {
+        _ = linux.close(loop.epoll_fd);
+    }
+
+    /// Starts calling the handler of watcher when watcher.fd has any of
+    /// events, which is a mask of linux.EPOLLIN, linux.EPOLLOUT and so on.
+    /// Errors and hang ups are always reported.
+    pub fn add(loop: &Loop, watcher: &Watcher, events: u32) -> %void {
+        return loop.control(linux.EPOLL_CTL_ADD, watcher, events);
+    }
+
+    /// Changes which events of watcher are reported.
+    pub fn modify(loop: &Loop, watcher: &Watcher, events: u32) -> %void {
+        return loop.control(linux.EPOLL_CTL_MOD, watcher, events);
+    }
+
+    /// Stops watching watcher. Events for it which were already received are
+    /// dropped, so it may be freed even from within a handler. Closing the
+    /// file descriptor also stops the watching, but does not drop the events.
+    pub fn remove(loop: &Loop, watcher: &Watcher) -> %void {
+        for (loop.pending) |*event| {
+            if (event.data == u64(usize(watcher))) {
+                event.data = 0;
+            }
+        }
+        return loop.control(linux.EPOLL_CTL_DEL, watcher, 0);
+    }
+
+    /// Waits up to timeout_ms milliseconds for events, or forever if it is -1,
+    /// and calls the handlers. Returns the number of events received.
+    pub fn poll(loop: &Loop, timeout_ms: i32) -> %usize {
+        const wait_ret = linux.epoll_wait(loop.epoll_fd, &loop.events[0], max_events, timeout_ms);
+        const wait_err = linux.getErrno(wait_ret);
+        if (wait_err > 0) {
+            return switch (wait_err) {
+                errno.EINTR => 0,
+                errno.EBADF => error.BadFd,
+                errno.EFAULT, errno.EINVAL => @unreachable(),
+                else => error.Unexpected,
+            }
+        }
+
+        loop.pending = loop.events[0...wait_ret];
+        while (loop.pending.len > 0) {
+            const event = loop.pending[0];
+            loop.pending = loop.pending[1...];
+            if (event.data != 0) {
+                const watcher = (&Watcher)(usize(event.data));
+                watcher.handler(watcher, event.events);
+            }
+        }
+        return wait_ret;
+    }
+
+    /// Calls poll until stop is called.
+    pub fn run(loop: &Loop) -> %void {
+        loop.running = true;
+        while (loop.running) {
+            _ = %return loop.poll(-1);
+        }
+    }
+
+    /// Makes run return once the current handler returns.
+    pub fn stop(loop: &Loop) {
+        loop.running = false;
+    }
+
+    fn control(loop: &Loop, op: i32, watcher: &Watcher, events: u32) -> %void {
+        var event = linux.epoll_event {
+            .events = events | linux.EPOLLET,
+            .data = u64(usize(watcher)),
+        };
+        const ctl_ret = linux.epoll_ctl(loop.epoll_fd, op, watcher.fd, &event);
+        const ctl_err = linux.getErrno(ctl_ret);
+        if (ctl_err > 0) {
+            return switch (ctl_err) {
+                errno.EBADF => error.BadFd,
+                errno.EEXIST => error.AlreadyWatched,
+                errno.ENOENT => error.NotWatched,
+                errno.ENOMEM, errno.ENOSPC => error.NoMem,
+                errno.EPERM => error.NotPollable,
+                errno.EINVAL => @unreachable(),
+                else => error.Unexpected,
+            }
+        }
+    }
+};
+
+/// A timer on CLOCK_MONOTONIC, driven by a Loop.
+/// Use `init` to initialize this state.
+pub const Timer = struct {
+    watcher: Watcher,
+    /// Called with the number of times the timer expired since the last call,
+    /// which is more than 1 if the loop fell behind.
+    handler: fn(timer: &Timer, expirations: u64),
+    context: ?&mem.Context,
+
+    /// The timer starts disarmed. Call deinit to clean up.
+    pub fn init(timer: &Timer, loop: &Loop, handler: fn(timer: &Timer, expirations: u64),
+        context: ?&mem.Context) -> %void
+    {
+        const timer_ret = linux.timerfd_create(linux.CLOCK_MONOTONIC, linux.TFD_NONBLOCK | linux.TFD_CLOEXEC);
+        const timer_err = linux.getErrno(timer_ret);
+        if (timer_err > 0) {
+            return switch (timer_err) {
+                errno.EMFILE => error.ProcessFdQuotaExceeded,
+                errno.ENFILE => error.SystemFdQuotaExceeded,
+                errno.ENOMEM, errno.ENODEV => error.NoMem,
+                else => error.Unexpected,
+            }
+        }
+        timer.watcher = Watcher {
+            .fd = i32(timer_ret),
+            .handler = onReady,
+            .context = (&mem.Context)(timer),
+        };
+        timer.handler = handler;
+        timer.context = context;
+        loop.add(&timer.watcher, linux.EPOLLIN) %% |err| {
+            _ = linux.close(timer.watcher.fd);
+            return err;
+        };
+    }
+
+    pub fn deinit(timer: &Timer, loop: &Loop) {
+        loop.remove(&timer.watcher) %% {};
+        _ = linux.close(timer.watcher.fd);
+    }
+
+    /// Expires after delay_ns nanoseconds, and then every interval_ns
+    /// nanoseconds unless that is 0. Replaces any earlier setting.
+    pub fn set(timer: &Timer, delay_ns: u64, interval_ns: u64) -> %void {
+        // a zero delay would disarm the timer
+        const delay = if (delay_ns == 0) u64(1) else delay_ns;
+        return timer.setTime(toTimespec(delay), toTimespec(interval_ns));
+    }
+
+    pub fn cancel(timer: &Timer) -> %void {
+        return timer.setTime(toTimespec(0), toTimespec(0));
+    }
+
+    fn setTime(timer: &Timer, value: linux.timespec, interval: linux.timespec) -> %void {
+        const spec = linux.itimerspec {
+            .it_interval = interval,
+            .it_value = value,
+        };
+        const set_err = linux.getErrno(linux.timerfd_settime(timer.watcher.fd, 0, &spec, null));
+        if (set_err > 0) {
+            return switch (set_err) {
+                errno.EBADF => error.BadFd,
+                errno.EFAULT, errno.EINVAL => @unreachable(),
+                else => error.Unexpected,
+            }
+        }
+    }
+
+    fn onReady(watcher: &Watcher, events: u32) {
+        const timer = (&Timer)(watcher.context ?? @unreachable());
+        var expirations: u64 = 0;
+        while (true) {
+            var count: u64 = undefined;
+            const read_ret = linux.read(watcher.fd, (&u8)(&count), @sizeOf(u64));
+            const read_err = linux.getErrno(read_ret);
+            if (read_err == errno.EINTR) continue;
+            // EAGAIN once there is nothing left to read
+            if (read_err > 0) break;
+            expirations += count;
+        }
+        if (expirations > 0) {
+            timer.handler(timer, expirations);
+        }
+    }
+};
+
+fn toTimespec(ns: u64) -> linux.timespec {
+    return linux.timespec {
+        .tv_sec = isize(ns / 1000000000),
+        .tv_nsec = isize(ns % 1000000000),
+    };
+}
+
+fn testTimer() {
+    @setFnTest(this);
+
+    var loop: Loop = undefined;
+    %%loop.init();
+    defer loop.deinit();
+
+    var fired: u64 = 0;
+    var timer: Timer = undefined;
+    %%timer.init(&loop, countExpirations, (&mem.Context)(&fired));
+    defer timer.deinit(&loop);
+
+    %%timer.set(1000000, 1000000);
+    while (fired < 3) {
+        _ = %%loop.poll(-1);
+    }
+    %%timer.cancel();
+    assert(fired >= 3);
+}
+
+fn countExpirations(timer: &Timer, expirations: u64) {
+    const fired = (&u64)(timer.context ?? @unreachable());
+    *fired += expirations;
+}
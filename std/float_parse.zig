@@ -0,0 +1,540 @@
+// Parsing of decimal floats, correctly rounded to nearest even. Up to 19
+// significant digits are read into a u64, which is converted either exactly
+// with one float multiply or divide, or with the Eisel-Lemire algorithm by
+// Daniel Lemire, which scales by the 128 bit powers of ten in
+// float_pow10.zig. The rare inputs which are too close to halfway between
+// two floats for that are converted exactly from a decimal of up to 800
+// digits, by shifting it a few bits at a time.
+
+const debug = @import("debug.zig");
+const assert = debug.assert;
+const mem = @import("mem.zig");
+const math = @import("math.zig");
+const pow10 = @import("float_pow10.zig");
+const float_print = @import("float_print.zig");
+const FloatInfo = float_print.FloatInfo;
+
+error InvalidChar;
+
+/// Parses buf as an f32 or an f64: an optional sign, digits with an optional
+/// point, and an optional exponent such as "e-7". "inf", "infinity" and
+/// "nan" in any case are accepted too. Values too large for T become an
+/// infinity, and values too small become zero.
+pub fn parseFloat(comptime T: type, buf: []const u8) -> %T {
+    const info = FloatInfo(T);
+    var i: usize = 0;
+    var negative = false;
+    if (buf.len > 0 && (buf[0] == '+' || buf[0] == '-')) {
+        negative = buf[0] == '-';
+        i = 1;
+    }
+    const sign_bit = if (negative) u64(1) << info.sign_shift else 0;
+    const digits_start = i;
+    const rest = buf[i...];
+    if (eqlIgnoreCase(rest, "inf") || eqlIgnoreCase(rest, "infinity")) {
+        return fromBits(T, sign_bit | info.inf_bits);
+    }
+    if (eqlIgnoreCase(rest, "nan")) {
+        return fromBits(T, info.inf_bits | (u64(1) << (info.mant_bits - 1)));
+    }
+
+    // mantissa * 10^exp10 is the value, with leading zeros skipped
+    var mantissa: u64 = 0;
+    var digit_count: i32 = 0;
+    var mantissa_digits: i32 = 0;
+    var point: i32 = 0;
+    var saw_point = false;
+    var saw_digits = false;
+    var truncated = false;
+    while (i < buf.len; i += 1) {
+        const c = buf[i];
+        if (c == '.') {
+            if (saw_point) return error.InvalidChar;
+            saw_point = true;
+            point = digit_count;
+        } else if (c >= '0' && c <= '9') {
+            saw_digits = true;
+            if (c == '0' && digit_count == 0) {
+                point -= 1;
+                continue;
+            }
+            digit_count += 1;
+            if (mantissa_digits < 19) {
+                mantissa = mantissa * 10 + (c - '0');
+                mantissa_digits += 1;
+            } else if (c != '0') {
+                truncated = true;
+            }
+        } else {
+            break;
+        }
+    }
+    if (!saw_digits) return error.InvalidChar;
+    if (!saw_point) point = digit_count;
+    if (i < buf.len) {
+        point += %return parseExponent(buf[i...]);
+    }
+
+    const exp10 = if (mantissa == 0) 0 else point - mantissa_digits;
+    var result: T = undefined;
+    if (!truncated && exactValue(T, mantissa, exp10, &result)) {
+        return if (negative) -result else result;
+    }
+    var bits: u64 = undefined;
+    if (eiselLemire(T, mantissa, exp10, &bits)) {
+        if (!truncated) {
+            return fromBits(T, sign_bit | bits);
+        }
+        // The digits which were cut off only matter if the value with
+        // the last kept digit one higher is a different float.
+        var bits_up: u64 = undefined;
+        if (eiselLemire(T, mantissa + 1, exp10, &bits_up) && bits_up == bits) {
+            return fromBits(T, sign_bit | bits);
+        }
+    }
+
+    var decimal: BigDecimal = undefined;
+    decimal.set(buf[digits_start...]);
+    return fromBits(T, sign_bit | decimal.floatBits(T));
+}
+
+// Parses "e" or "E", an optional sign and digits, which must be the rest of
+// buf. Exponents past 10000 are clamped, which is enough to give an infinity
+// or zero.
+fn parseExponent(buf: []const u8) -> %i32 {
+    if (buf[0] != 'e' && buf[0] != 'E') return error.InvalidChar;
+    var i: usize = 1;
+    var negative = false;
+    if (i < buf.len && (buf[i] == '+' || buf[i] == '-')) {
+        negative = buf[i] == '-';
+        i += 1;
+    }
+    if (i == buf.len) return error.InvalidChar;
+    var e: i32 = 0;
+    for (buf[i...]) |c| {
+        if (c < '0' || c > '9') return error.InvalidChar;
+        if (e < 10000) e = e * 10 + i32(c - '0');
+    }
+    return if (negative) -e else e;
+}
+
+// The powers of ten which are exact in an f64. Those up to 1e10 are exact in
+// an f32 too.
+const exact_powers = []f64 {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+    1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+// When the mantissa and the power of ten are both exact floats, one correctly
+// rounded multiply or divide gives the result.
+fn exactValue(comptime T: type, mantissa: u64, exp10: i32, result: &T) -> bool {
+    const info = FloatInfo(T);
+    // the exponents of the largest exact power of ten and integer
+    const max_exp10 = if (T == f32) 10 else 22;
+    const max_int_exp10 = if (T == f32) 7 else 15;
+    if (mantissa >> info.mant_bits != 0) return false;
+
+    var x = T(mantissa);
+    if (exp10 == 0) {
+        *result = x;
+    } else if (exp10 > 0 && exp10 <= max_int_exp10 + max_exp10) {
+        // move zeros into the mantissa while it stays exact
+        var e = exp10;
+        if (e > max_exp10) {
+            x *= T(exact_powers[usize(e - max_exp10)]);
+            e = max_exp10;
+        }
+        if (x > T(exact_powers[max_int_exp10])) return false;
+        *result = x * T(exact_powers[usize(e)]);
+    } else if (exp10 < 0 && exp10 >= -max_exp10) {
+        *result = x / T(exact_powers[usize(-exp10)]);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Stores the bits of mantissa * 10^exp10 rounded to a T, without the sign, in
+// bits, or returns false when the 128 bit product is too close to halfway
+// between two floats to tell, or the result is subnormal or overflows.
+fn eiselLemire(comptime T: type, mantissa: u64, exp10: i32, bits: &u64) -> bool {
+    const info = FloatInfo(T);
+    // the bits below the mantissa and its rounding bit in the high word
+    const low_mask = if (T == f32) u64(0x3FFFFFFFFF) else u64(0x1FF);
+    const low_bits = if (T == f32) u64(38) else u64(9);
+
+    if (mantissa == 0) {
+        *bits = 0;
+        return true;
+    }
+    if (exp10 < pow10.min_exp10 || exp10 > pow10.max_exp10) return false;
+
+    const clz = @clz(mantissa);
+    const man = mantissa << clz;
+    var exp2 = ((217706 * exp10) >> 16) + 64 + info.exp_bias - i32(clz);
+
+    const i = 2 * usize(exp10 - pow10.min_exp10);
+    var lo: u64 = undefined;
+    var hi = math.mulWide(man, pow10.powers[i], &lo);
+
+    // The truncated power of ten may be too low by enough to change the
+    // result. Then bring in the low 64 bits of the power of ten too.
+    if (hi & low_mask == low_mask && lo +% man < man) {
+        var low_lo: u64 = undefined;
+        const low_hi = math.mulWide(man, pow10.powers[i + 1], &low_lo);
+        var merged_hi = hi;
+        const merged_lo = lo +% low_hi;
+        if (merged_lo < lo) merged_hi += 1;
+        if (merged_hi & low_mask == low_mask && merged_lo +% 1 == 0 && low_lo +% man < man) {
+            return false;
+        }
+        hi = merged_hi;
+        lo = merged_lo;
+    }
+
+    // keep the mantissa and one more bit for rounding
+    const msb = hi >> 63;
+    var result_mant = hi >> (msb + low_bits);
+    exp2 -= i32(1 ^ msb);
+
+    // exactly halfway, or maybe just above
+    if (lo == 0 && hi & low_mask == 0 && result_mant & 3 == 1) return false;
+
+    result_mant += result_mant & 1;
+    result_mant >>= 1;
+    if (result_mant >> (info.mant_bits + 1) != 0) {
+        result_mant >>= 1;
+        exp2 += 1;
+    }
+    if (exp2 <= 0 || exp2 >= i32(info.exp_mask)) return false;
+
+    *bits = (u64(exp2) << info.mant_bits) | (result_mant & info.mant_mask);
+    return true;
+}
+
+const max_big_digits = 800;
+// the most bits shifted at a time, which leaves room for a digit above them
+const max_shift = 60;
+
+// An exact decimal, for the inputs which are too close to halfway between
+// two floats. 800 digits are enough to tell which side of halfway they are
+// on, and truncated records whether any nonzero digits went past that.
+// value = 0.digits * 10^point
+const BigDecimal = struct {
+    digits: [max_big_digits]u8,
+    len: usize,
+    point: i32,
+    truncated: bool,
+
+    // buf has already been checked by parseFloat, and has no sign.
+    fn set(self: &BigDecimal, buf: []const u8) {
+        self.len = 0;
+        self.point = 0;
+        self.truncated = false;
+        // digits past max_big_digits are not stored but still move the point
+        var digit_count: i32 = 0;
+        var saw_point = false;
+        var i: usize = 0;
+        while (i < buf.len; i += 1) {
+            const c = buf[i];
+            if (c == '.') {
+                saw_point = true;
+                self.point = digit_count;
+            } else if (c >= '0' && c <= '9') {
+                if (c == '0' && digit_count == 0) {
+                    self.point -= 1;
+                    continue;
+                }
+                digit_count += 1;
+                if (self.len < max_big_digits) {
+                    self.digits[self.len] = c - '0';
+                    self.len += 1;
+                } else if (c != '0') {
+                    self.truncated = true;
+                }
+            } else {
+                break;
+            }
+        }
+        if (!saw_point) self.point = digit_count;
+        if (i < buf.len) {
+            self.point += %%parseExponent(buf[i...]);
+        }
+        self.trim();
+    }
+
+    fn trim(self: &BigDecimal) {
+        while (self.len > 0 && self.digits[self.len - 1] == 0) {
+            self.len -= 1;
+        }
+        if (self.len == 0) self.point = 0;
+    }
+
+    // Multiplies by 2^k, or divides by 2^-k when k is negative.
+    fn shift(self: &BigDecimal, k: i32) {
+        if (self.len == 0) return;
+        var left = k;
+        while (left > max_shift) {
+            self.shiftLeft(max_shift);
+            left -= max_shift;
+        }
+        while (left < -max_shift) {
+            self.shiftRight(max_shift);
+            left += max_shift;
+        }
+        if (left > 0) {
+            self.shiftLeft(u64(left));
+        } else if (left < 0) {
+            self.shiftRight(u64(-left));
+        }
+    }
+
+    fn shiftLeft(self: &BigDecimal, k: u64) {
+        // the digits come out from the lowest, so collect them at the end
+        // of a scratch buffer first
+        var scratch: [max_big_digits + 20]u8 = undefined;
+        var w = scratch.len;
+        var n: u64 = 0;
+        var r = self.len;
+        while (r > 0) {
+            r -= 1;
+            n += u64(self.digits[r]) << k;
+            w -= 1;
+            scratch[w] = u8(n % 10);
+            n /= 10;
+        }
+        while (n > 0) {
+            w -= 1;
+            scratch[w] = u8(n % 10);
+            n /= 10;
+        }
+        var count = scratch.len - w;
+        self.point += i32(count) - i32(self.len);
+        if (count > max_big_digits) {
+            for (scratch[w + max_big_digits...]) |digit| {
+                if (digit != 0) self.truncated = true;
+            }
+            count = max_big_digits;
+        }
+        mem.copy(u8, self.digits[0...], scratch[w...w + count]);
+        self.len = count;
+        self.trim();
+    }
+
+    fn shiftRight(self: &BigDecimal, k: u64) {
+        var r: usize = 0;
+        var w: usize = 0;
+        // read enough leading digits to have something to shift out
+        var n: u64 = 0;
+        while (n >> k == 0; r += 1) {
+            if (r >= self.len) {
+                if (n == 0) {
+                    self.len = 0;
+                    return;
+                }
+                while (n >> k == 0; r += 1) {
+                    n *= 10;
+                }
+                break;
+            }
+            n = n * 10 + self.digits[r];
+        }
+        self.point -= i32(r) - 1;
+
+        const mask = (u64(1) << k) - 1;
+        while (r < self.len; r += 1) {
+            self.digits[w] = u8(n >> k);
+            w += 1;
+            n = (n & mask) * 10 + self.digits[r];
+        }
+        while (n > 0) {
+            const digit = u8(n >> k);
+            if (w < max_big_digits) {
+                self.digits[w] = digit;
+                w += 1;
+            } else if (digit > 0) {
+                self.truncated = true;
+            }
+            n = (n & mask) * 10;
+        }
+        self.len = w;
+        self.trim();
+    }
+
+    // The integer part, rounded to nearest even. It must be below 10^19.
+    fn roundedInteger(self: &BigDecimal) -> u64 {
+        if (self.point < 0) return 0;
+        var n: u64 = 0;
+        var i: usize = 0;
+        const point = usize(self.point);
+        while (i < point; i += 1) {
+            n = n * 10 + (if (i < self.len) self.digits[i] else 0);
+        }
+        if (point < self.len) {
+            const digit = self.digits[point];
+            if (digit == 5 && point + 1 == self.len) {
+                // exactly halfway unless digits were cut off
+                if (self.truncated || (point > 0 && self.digits[point - 1] & 1 == 1)) n += 1;
+            } else if (digit >= 5) {
+                n += 1;
+            }
+        }
+        return n;
+    }
+
+    // The bits of the value rounded to a T, without the sign.
+    fn floatBits(self: &BigDecimal, comptime T: type) -> u64 {
+        const info = FloatInfo(T);
+        if (self.len == 0 || self.point < -330) return 0;
+        if (self.point > 310) return info.inf_bits;
+
+        // bring the value into [0.5, 1), keeping count of the power of two,
+        // a few digits at a time
+        const powers_shift = []i32 { 1, 3, 6, 9, 13, 16, 19, 23, 26 };
+        var exp: i32 = 0;
+        while (self.point > 0) {
+            const n = if (self.point >= powers_shift.len) 27 else powers_shift[usize(self.point)];
+            self.shift(-n);
+            exp += n;
+        }
+        while (self.point < 0 || (self.point == 0 && self.digits[0] < 5)) {
+            const n = if (-self.point >= powers_shift.len) 27 else powers_shift[usize(-self.point)];
+            self.shift(n);
+            exp -= n;
+        }
+        // floats are in [1, 2)
+        exp -= 1;
+
+        // subnormals have the exponent of the smallest normal float
+        const min_exp = 1 - info.exp_bias;
+        if (exp < min_exp) {
+            self.shift(exp - min_exp);
+            exp = min_exp;
+        }
+        if (exp + info.exp_bias >= i32(info.exp_mask)) return info.inf_bits;
+
+        self.shift(info.mant_bits + 1);
+        var mant = self.roundedInteger();
+        // rounding up carried into a new bit
+        if (mant == u64(2) << info.mant_bits) {
+            mant >>= 1;
+            exp += 1;
+            if (exp + info.exp_bias >= i32(info.exp_mask)) return info.inf_bits;
+        }
+        if (mant & (u64(1) << info.mant_bits) == 0) {
+            return mant;
+        }
+        return (u64(exp + info.exp_bias) << info.mant_bits) | (mant & info.mant_mask);
+    }
+};
+
+fn fromBits(comptime T: type, bits: u64) -> T {
+    if (T == f32) {
+        const bits32 = u32(bits);
+        *(&const f32)(&bits32)
+    } else if (T == f64) {
+        *(&const f64)(&bits)
+    } else {
+        @compileError("expected f32 or f64, found '" ++ @typeName(T) ++ "'")
+    }
+}
+
+fn eqlIgnoreCase(a: []const u8, b: []const u8) -> bool {
+    if (a.len != b.len) return false;
+    for (a) |c, i| {
+        const lower = if (c >= 'A' && c <= 'Z') c + ('a' - 'A') else c;
+        if (lower != b[i]) return false;
+    }
+    return true;
+}
+
+fn testParseFloat() {
+    @setFnTest(this);
+
+    testParse(f64, "0", 0);
+    testParse(f64, "-0", 0x8000000000000000);
+    testParse(f64, "1", 0x3ff0000000000000);
+    testParse(f64, "+1.5", 0x3ff8000000000000);
+    testParse(f64, "0.1", 0x3fb999999999999a);
+    testParse(f64, ".5", 0x3fe0000000000000);
+    testParse(f64, "5.", 0x4014000000000000);
+    testParse(f64, "1e23", 0x44b52d02c7e14af6);
+    testParse(f64, "123456789012345678901234567890", 0x45f8ee90ff6c373e);
+    testParse(f64, "4.9e-324", 1);
+    testParse(f64, "2.4703282292062327e-324", 0);
+    testParse(f64, "2.4703282292062328e-324", 1);
+    testParse(f64, "2.2250738585072011e-308", 0x000fffffffffffff);
+    testParse(f64, "1.7976931348623157e308", 0x7fefffffffffffff);
+    testParse(f64, "1e400", 0x7ff0000000000000);
+    testParse(f64, "-1e-400", 0x8000000000000000);
+    testParse(f64, "-INF", 0xfff0000000000000);
+    // 2^53 + 1 is halfway between two floats, until a digit far past it
+    testParse(f64, "9007199254740993", 0x4340000000000000);
+    testParse(f64, "9007199254740993.0000000000000000001", 0x4340000000000001);
+    // more integer digits than BigDecimal keeps
+    testParse(f64, "9007199254740993" ++ "0" ** 900 ++ "e-900", 0x4340000000000000);
+    testParse(f64, "9007199254740993" ++ "0" ** 900 ++ "1e-901", 0x4340000000000001);
+
+    testParse(f32, "0.1", 0x3dcccccd);
+    testParse(f32, "16777217", 0x4b800000);
+    // rounding to an f64 first would give 0x15ae43fe
+    testParse(f32, "7.038531e-26", 0x15ae43fd);
+    testParse(f32, "1.000000059604644775390625", 0x3f800000);
+    testParse(f32, "1.00000005960464477550", 0x3f800001);
+    testParse(f32, "1e39", 0x7f800000);
+    testParse(f32, "1e-46", 0);
+
+    assert(isNan(%%parseFloat(f64, "nan")));
+    testInvalid("");
+    testInvalid("-");
+    testInvalid(".");
+    testInvalid("1.2.3");
+    testInvalid("1e");
+    testInvalid("1e+");
+    testInvalid("1x");
+    testInvalid("e5");
+}
+
+// Every 65521st f32, and pseudo random f64 bits, print and parse back to
+// themselves. example/float_bench checks every f32.
+fn testRoundTrip() {
+    @setFnTest(this);
+
+    var buf: [float_print.max_float_digits]u8 = undefined;
+    var bits32: u32 = 0;
+    while (bits32 < 0x7f800000; bits32 += 65521) {
+        const x = *(&const f32)(&bits32);
+        const len = float_print.bufPrintFloat(buf[0...], x);
+        const y = %%parseFloat(f32, buf[0...len]);
+        assert(*(&const u32)(&y) == bits32);
+    }
+
+    var state: u64 = 0x9e3779b97f4a7c15;
+    var i: usize = 0;
+    while (i < 20000; i += 1) {
+        state = state *% 6364136223846793005 +% 1442695040888963407;
+        const bits64 = state >> 1;
+        if (bits64 >> 52 == 0x7ff) continue;
+        const x = *(&const f64)(&bits64);
+        const len = float_print.bufPrintFloat(buf[0...], x);
+        const y = %%parseFloat(f64, buf[0...len]);
+        assert(*(&const u64)(&y) == bits64);
+    }
+}
+
+fn testParse(comptime T: type, buf: []const u8, expected_bits: u64) {
+    const x = %%parseFloat(T, buf);
+    assert(float_print.floatBits(T, x) == expected_bits);
+}
+
+fn testInvalid(buf: []const u8) {
+    parseFloat(f64, buf) %% |err| {
+        assert(err == error.InvalidChar);
+        return;
+    };
+    @unreachable();
+}
+
+fn isNan(x: f64) -> bool {
+    return x != x;
+}
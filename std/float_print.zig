@@ -0,0 +1,425 @@
+// Shortest round trip formatting of floats: of the decimal numbers which
+// parse back to the same float, print one with the fewest digits, and of
+// those the one closest to the float. The digits come from the Ryu algorithm
+// by Ulf Adams, in the form which scales the bounds of the float by the
+// 128 bit powers of ten in float_pow10.zig, which float_parse.zig uses too.
+
+const debug = @import("debug.zig");
+const assert = debug.assert;
+const mem = @import("mem.zig");
+const math = @import("math.zig");
+const pow10 = @import("float_pow10.zig");
+
+/// The most bytes bufPrintFloat writes, for example "-2.2250738585072014e-308".
+pub const max_float_digits = 32;
+
+/// value = 0.digits * 10^point, with no leading or trailing zero digits.
+/// Zero has no digits.
+pub const Decimal = struct {
+    digits: [24]u8,
+    len: usize,
+    point: i32,
+};
+
+/// Writes x, which is an f32 or an f64, to out_buf as the shortest decimal
+/// which parses back to x, and returns how many bytes that is. It is laid out
+/// like JavaScript numbers: 21 digits at most before the point and 6 zeros
+/// at most after it, or else an exponent, as in "1e21" and "1.5e-7".
+/// Infinities and NaN are "inf", "-inf" and "nan".
+/// Guaranteed to not use more than max_float_digits.
+pub fn bufPrintFloat(out_buf: []u8, x: var) -> usize {
+    const T = @typeOf(x);
+    const bits = floatBits(T, x);
+    const info = FloatInfo(T);
+    var index: usize = 0;
+
+    if ((bits >> info.exp_shift) & info.exp_mask == info.exp_mask) {
+        if (bits & info.mant_mask != 0) return copyStr(out_buf, "nan");
+        index = if (bits >> info.sign_shift != 0) copyStr(out_buf, "-") else 0;
+        return index + copyStr(out_buf[index...], "inf");
+    }
+    if (bits >> info.sign_shift != 0) {
+        out_buf[0] = '-';
+        index = 1;
+    }
+
+    var d: Decimal = undefined;
+    shortestDigits(T, x, &d);
+    if (d.len == 0) {
+        out_buf[index] = '0';
+        return index + 1;
+    }
+
+    const digits = d.digits[0...d.len];
+    const k = isize(d.len);
+    const n = isize(d.point);
+    if (k <= n && n <= 21) {
+        // an integer, padded with zeros
+        index += copyStr(out_buf[index...], digits);
+        index += fillZeros(out_buf[index...], usize(n - k));
+    } else if (0 < n && n <= 21) {
+        index += copyStr(out_buf[index...], digits[0...usize(n)]);
+        out_buf[index] = '.';
+        index += 1;
+        index += copyStr(out_buf[index...], digits[usize(n)...]);
+    } else if (-6 < n && n <= 0) {
+        index += copyStr(out_buf[index...], "0.");
+        index += fillZeros(out_buf[index...], usize(-n));
+        index += copyStr(out_buf[index...], digits);
+    } else {
+        out_buf[index] = digits[0];
+        index += 1;
+        if (k > 1) {
+            out_buf[index] = '.';
+            index += 1;
+            index += copyStr(out_buf[index...], digits[1...]);
+        }
+        out_buf[index] = 'e';
+        index += 1;
+        var e = usize(if (n > 0) n - 1 else 1 - n);
+        if (n <= 0) {
+            out_buf[index] = '-';
+            index += 1;
+        }
+        var e_digits: [3]u8 = undefined;
+        var i: usize = e_digits.len;
+        while (true) {
+            i -= 1;
+            e_digits[i] = '0' + u8(e % 10);
+            e /= 10;
+            if (e == 0) break;
+        }
+        index += copyStr(out_buf[index...], e_digits[i...]);
+    }
+    return index;
+}
+
+/// Computes the shortest digits of the absolute value of x, which is a
+/// finite f32 or f64.
+pub fn shortestDigits(comptime T: type, x: T, d: &Decimal) {
+    const info = FloatInfo(T);
+    const bits = floatBits(T, x);
+
+    // value = mant * 2^exp
+    var mant = bits & info.mant_mask;
+    const biased_exp = (bits >> info.exp_shift) & info.exp_mask;
+    var exp = i32(biased_exp) + info.min_exp - 1;
+    if (biased_exp == 0) {
+        exp += 1;
+    } else {
+        mant |= info.implicit_bit;
+    }
+
+    d.len = 0;
+    d.point = 0;
+    if (mant == 0) return;
+
+    // An integer with fewer bits than the mantissa: the integers next to it
+    // are floats too, so all its digits are needed.
+    if (exp <= 0 && @ctz(mant) >= u64(-exp)) {
+        mant >>= u64(-exp);
+        ryuDigits(d, mant, mant, mant, true, false);
+        return;
+    }
+
+    // The bounds of the interval which rounds to x, times 2^e2. When mant
+    // is a power of two the float below x is closer than the one above it.
+    var ml: u64 = undefined;
+    var mc: u64 = undefined;
+    var mu: u64 = undefined;
+    var e2: i32 = undefined;
+    if (mant != info.implicit_bit || exp == info.min_exp) {
+        ml = 2 * mant - 1;
+        mc = 2 * mant;
+        mu = 2 * mant + 1;
+        e2 = exp - 1;
+    } else {
+        ml = 4 * mant - 1;
+        mc = 4 * mant;
+        mu = 4 * mant + 2;
+        e2 = exp - 2;
+    }
+    if (e2 == 0) {
+        ryuDigits(d, ml, mc, mu, true, false);
+        return;
+    }
+
+    // Multiply by the power of ten 10^q just above 2^-e2, which leaves fixed
+    // point numbers with -e2 bits after the point.
+    const q = pow10.log10Pow2(-e2) + 1;
+    var lower_exact: bool = undefined;
+    var central_exact: bool = undefined;
+    var upper_exact: bool = undefined;
+    var lower = mulPow10(T, ml, q, &lower_exact);
+    var central = mulPow10(T, mc, q, &central_exact);
+    var upper = mulPow10(T, mu, q, &upper_exact);
+    e2 += pow10.log2Pow10(q) - (if (T == f32) i32(6) else i32(8));
+    assert(e2 < 0);
+
+    if (q > 55) {
+        // large powers of ten do not fit in 128 bits
+        lower_exact = false;
+        central_exact = false;
+        upper_exact = false;
+    } else if (q < 0 && q >= -24) {
+        // dividing by 10^-q can be exact, but not by 5^25 or more, which has
+        // 59 bits
+        const k = u32(-q);
+        lower_exact = lower_exact || divisibleByPow5(ml, k);
+        central_exact = central_exact || divisibleByPow5(mc, k);
+        upper_exact = upper_exact || divisibleByPow5(mu, k);
+    }
+
+    const extra = u64(-e2);
+    const extra_mask = (u64(1) << extra) - 1;
+    const half = u64(1) << (extra - 1);
+    const lower_frac = lower & extra_mask;
+    const central_frac = central & extra_mask;
+    const upper_frac = upper & extra_mask;
+    lower >>= extra;
+    central >>= extra;
+    upper >>= extra;
+
+    // upper is allowed when it was truncated, or when it is exact and x
+    // rounds to it because mant is even.
+    if (upper_exact && upper_frac == 0 && mant & 1 == 1) {
+        upper -= 1;
+    }
+    // lower is allowed only when it is exact and mant is even.
+    if (!(lower_exact && lower_frac == 0 && mant & 1 == 0)) {
+        lower += 1;
+    }
+    // Whether central rounds up. When it is exact, round half to even.
+    var central_up: bool = undefined;
+    if (central_exact) {
+        central_up = central_frac > half || (central_frac == half && central & 1 == 1);
+    } else {
+        central_up = central_frac >= half;
+    }
+    ryuDigits(d, lower, central, upper, central_exact && central_frac == 0, central_up);
+    d.point -= q;
+}
+
+// Multiplies m by 10^q, using the top 64 bits of the power of ten for an
+// f32 and all 128 for an f64, and returns the top bits of the product.
+// exact tells whether nothing was cut off.
+fn mulPow10(comptime T: type, m: u64, q: i32, exact: &bool) -> u64 {
+    if (q == 0) {
+        // 10^0 is 1 << 63 or 1 << 127
+        *exact = true;
+        return if (T == f32) m << 6 else m << 8;
+    }
+    const i = 2 * usize(q - pow10.min_exp10);
+    var lo: u64 = undefined;
+    if (T == f32) {
+        var power = pow10.powers[i];
+        // the inverse powers of ten are rounded up
+        if (q < 0) power += 1;
+        const hi = math.mulWide(m, power, &lo);
+        *exact = lo <<% 7 == 0;
+        return (hi << 7) | (lo >> 57);
+    } else {
+        var power_lo = pow10.powers[i + 1];
+        if (q < 0) power_lo += 1;
+        var low_lo: u64 = undefined;
+        const low_hi = math.mulWide(m, power_lo, &low_lo);
+        var hi = math.mulWide(m, pow10.powers[i], &lo);
+        const mid = lo +% low_hi;
+        if (mid < lo) hi += 1;
+        *exact = mid <<% 9 == 0 && low_lo == 0;
+        return (hi << 9) | (mid >> 55);
+    }
+}
+
+fn divisibleByPow5(m: u64, k: u32) -> bool {
+    if (m == 0) return true;
+    var x = m;
+    var i: u32 = 0;
+    while (i < k; i += 1) {
+        if (x % 5 != 0) return false;
+        x /= 5;
+    }
+    return true;
+}
+
+// Finds the shortest digits between lower and upper, which are inclusive,
+// and rounds the rest of central to get the last one. central_zero tells
+// whether central had only zero bits cut off, and central_up whether the cut
+// off part is at least one half.
+fn ryuDigits(d: &Decimal, lower: u64, central: u64, upper: u64, central_zero: bool, central_up: bool) {
+    const lower_hi = u32(lower / 1000000000);
+    const lower_lo = u32(lower % 1000000000);
+    const central_hi = u32(central / 1000000000);
+    const central_lo = u32(central % 1000000000);
+    const upper_hi = u32(upper / 1000000000);
+    const upper_lo = u32(upper % 1000000000);
+    if (upper_hi == 0) {
+        // subnormals only have low digits
+        ryuDigits32(d, lower_lo, central_lo, upper_lo, central_zero, central_up, 8);
+    } else if (lower_hi < upper_hi) {
+        // the low 9 digits can all go
+        const l = if (lower_lo != 0) lower_hi + 1 else lower_hi;
+        const up = central_lo > 500000000 || (central_lo == 500000000 && central_up);
+        ryuDigits32(d, l, central_hi, upper_hi, central_zero && central_lo == 0, up, 8);
+        d.point += 9;
+    } else {
+        var high: [9]u8 = undefined;
+        var v = central_hi;
+        var n: usize = high.len;
+        while (v > 0) {
+            n -= 1;
+            high[n] = '0' + u8(v % 10);
+            v /= 10;
+        }
+        d.len = copyStr(d.digits[0...], high[n...]);
+        ryuDigits32(d, lower_lo, central_lo, upper_lo, central_zero, central_up, isize(d.len) + 8);
+    }
+
+    while (d.len > 0 && d.digits[d.len - 1] == '0') {
+        d.len -= 1;
+    }
+    var zeros: usize = 0;
+    while (zeros < d.len && d.digits[zeros] == '0') {
+        zeros += 1;
+    }
+    if (zeros > 0) {
+        d.len -= zeros;
+        d.point -= i32(zeros);
+        for (d.digits[0...d.len]) |*digit, i| {
+            *digit = d.digits[i + zeros];
+        }
+    }
+}
+
+// Appends the digits of a number below 10^9 to d, ending at end_index. It
+// drops digits while the result stays between lower and upper.
+fn ryuDigits32(d: &Decimal, lower_arg: u32, central_arg: u32, upper_arg: u32,
+    central_zero_arg: bool, central_up_arg: bool, end_index: isize)
+{
+    var lower = lower_arg;
+    var central = central_arg;
+    var upper = upper_arg;
+    var central_zero = central_zero_arg;
+    var central_up = central_up_arg;
+    if (upper == 0) {
+        d.point = i32(end_index) + 1;
+        return;
+    }
+
+    var trimmed: isize = 0;
+    // the last digit trimmed from central, which decides the rounding
+    var next_digit: u32 = 0;
+    while (upper > 0) {
+        const l = (lower + 9) / 10;
+        var c = central / 10;
+        var c_digit = central % 10;
+        const u = upper / 10;
+        if (l > u) break;
+        // central is just below a multiple of a larger power of ten, which
+        // is closer
+        if (l == c + 1 && c < u) {
+            c += 1;
+            c_digit = 0;
+            central_up = false;
+        }
+        trimmed += 1;
+        central_zero = central_zero && next_digit == 0;
+        next_digit = c_digit;
+        lower = l;
+        central = c;
+        upper = u;
+    }
+    if (trimmed > 0) {
+        central_up = next_digit > 5 || (next_digit == 5 && (!central_zero || central & 1 == 1));
+    }
+    if (central < upper && central_up) {
+        central += 1;
+    }
+
+    const last = end_index - trimmed;
+    var n = last;
+    while (n >= isize(d.len)) {
+        d.digits[usize(n)] = '0' + u8(central % 10);
+        central /= 10;
+        n -= 1;
+    }
+    d.len = usize(last + 1);
+    d.point = i32(last + 1 + trimmed);
+}
+
+/// The layout of an f32 or an f64, for working on its bits in a u64.
+pub fn FloatInfo(comptime T: type) -> type {
+    struct {
+        pub const mant_bits = if (T == f32) 23 else 52;
+        pub const exp_bits = if (T == f32) 8 else 11;
+        pub const exp_bias = if (T == f32) 127 else 1023;
+        pub const exp_shift = mant_bits;
+        pub const sign_shift = mant_bits + exp_bits;
+        pub const mant_mask = (u64(1) << mant_bits) - 1;
+        pub const exp_mask = (u64(1) << exp_bits) - 1;
+        pub const implicit_bit = u64(1) << mant_bits;
+        pub const inf_bits = exp_mask << mant_bits;
+        // the exponent of the lowest mantissa bit of the smallest normal float
+        pub const min_exp = i32(1) - exp_bias - mant_bits;
+    }
+}
+
+/// The bits of an f32 or an f64, in a u64.
+pub fn floatBits(comptime T: type, x: T) -> u64 {
+    if (T == f32) {
+        u64(*(&const u32)(&x))
+    } else if (T == f64) {
+        *(&const u64)(&x)
+    } else {
+        @compileError("expected f32 or f64, found '" ++ @typeName(T) ++ "'")
+    }
+}
+
+fn copyStr(out_buf: []u8, s: []const u8) -> usize {
+    mem.copy(u8, out_buf, s);
+    return s.len;
+}
+
+fn fillZeros(out_buf: []u8, count: usize) -> usize {
+    mem.set(u8, out_buf[0...count], '0');
+    return count;
+}
+
+fn testBufPrintFloat() {
+    @setFnTest(this);
+
+    testPrint(f64(1.0), "1");
+    testPrint(f64(-2.5), "-2.5");
+    testPrint(f64(0.1), "0.1");
+    testPrint(f64(123.456), "123.456");
+    testPrint(f64(0.000001), "0.000001");
+    testPrint(f64(1.5e-7), "1.5e-7");
+    testPrint(f64(1e20), "100000000000000000000");
+    testPrint(f64(1e21), "1e21");
+    testPrint(f64(1e23), "1e23");
+    testPrint(f64(9007199254740992.0), "9007199254740992");
+    testPrint(f64(5e-324), "5e-324");
+    testPrint(f64(2.2250738585072014e-308), "2.2250738585072014e-308");
+    testPrint(f64(1.7976931348623157e308), "1.7976931348623157e308");
+
+    testPrint(f32(0.1), "0.1");
+    testPrint(f32(0.3), "0.3");
+    testPrint(f32(16777216.0), "16777216");
+    testPrint(f32(1e-45), "1e-45");
+    testPrint(f32(1.17549435e-38), "1.1754944e-38");
+    var max_bits: u32 = 0x7f7fffff;
+    testPrint(*(&const f32)(&max_bits), "3.4028235e38");
+
+    var zero: f64 = 0.0;
+    testPrint(zero, "0");
+    testPrint(-zero, "-0");
+    testPrint(1.0 / zero, "inf");
+    testPrint(-1.0 / zero, "-inf");
+    testPrint(zero / zero, "nan");
+}
+
+fn testPrint(x: var, expected: []const u8) {
+    var buf: [max_float_digits]u8 = undefined;
+    const len = bufPrintFloat(buf[0...], x);
+    assert(mem.eql(u8, buf[0...len], expected));
+}
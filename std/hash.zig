@@ -0,0 +1,194 @@
+const debug = @import("debug.zig");
+const assert = debug.assert;
+const mem = @import("mem.zig");
+
+const prime1: u64 = 11400714785074694791;
+const prime2: u64 = 14029467366897019727;
+const prime3: u64 = 1609587929392839161;
+const prime4: u64 = 9650029242287828579;
+const prime5: u64 = 2870177450012600261;
+
+/// XXH64 of input with the given seed. This is a fast non-cryptographic hash
+/// which consumes 32 bytes per round in four independent lanes. It is not
+/// suitable where an attacker chooses the keys and can observe collisions.
+pub fn hash64(seed: u64, input: []const u8) -> u64 {
+    const len = input.len;
+    var i: usize = 0;
+    var h: u64 = undefined;
+
+    if (len >= 32) {
+        var v1 = seed +% prime1 +% prime2;
+        var v2 = seed +% prime2;
+        var v3 = seed;
+        var v4 = seed -% prime1;
+        while (i + 32 <= len; i += 32) {
+            v1 = round(v1, read64(input, i));
+            v2 = round(v2, read64(input, i + 8));
+            v3 = round(v3, read64(input, i + 16));
+            v4 = round(v4, read64(input, i + 24));
+        }
+        h = @rotl(v1, 1) +% @rotl(v2, 7) +% @rotl(v3, 12) +% @rotl(v4, 18);
+        h = mergeRound(h, v1);
+        h = mergeRound(h, v2);
+        h = mergeRound(h, v3);
+        h = mergeRound(h, v4);
+    } else {
+        h = seed +% prime5;
+    }
+
+    h +%= u64(len);
+    while (i + 8 <= len; i += 8) {
+        h ^= round(0, read64(input, i));
+        h = @rotl(h, 27) *% prime1 +% prime4;
+    }
+    if (i + 4 <= len) {
+        h ^= u64(read32(input, i)) *% prime1;
+        h = @rotl(h, 23) *% prime2 +% prime3;
+        i += 4;
+    }
+    while (i < len; i += 1) {
+        h ^= u64(input[i]) *% prime5;
+        h = @rotl(h, 11) *% prime1;
+    }
+
+    h ^= h >> 33;
+    h *%= prime2;
+    h ^= h >> 29;
+    h *%= prime3;
+    h ^= h >> 32;
+    return h;
+}
+
+/// hash64 folded to the 32 bits HashMap wants.
+pub fn hash32(seed: u64, input: []const u8) -> u32 {
+    const h = hash64(seed, input);
+    return @truncate(u32, h ^ (h >> 32));
+}
+
+fn round(acc: u64, input: u64) -> u64 {
+    return @rotl(acc +% input *% prime2, 31) *% prime1;
+}
+
+fn mergeRound(acc: u64, value: u64) -> u64 {
+    return (acc ^ round(0, value)) *% prime1 +% prime4;
+}
+
+/// Reads a little endian u64 at index i. The load is not necessarily aligned.
+fn read64(input: []const u8, i: usize) -> u64 {
+    return mem.readInt(input[i...i + 8], u64, false);
+}
+
+fn read32(input: []const u8, i: usize) -> u32 {
+    return mem.readInt(input[i...i + 4], u32, false);
+}
+
+/// Finalizer of MurmurHash3, which makes every bit of the result depend on
+/// every bit of x. Useful to turn integer keys into hashes.
+pub fn mix64(x: u64) -> u64 {
+    var h = x;
+    h ^= h >> 33;
+    h *%= 0xff51afd7ed558ccd;
+    h ^= h >> 33;
+    h *%= 0xc4ceb9fe1a85ec53;
+    h ^= h >> 33;
+    return h;
+}
+
+/// 32 bit version of mix64.
+pub fn mix32(x: u32) -> u32 {
+    var h = x;
+    h ^= h >> 16;
+    h *%= 0x85ebca6b;
+    h ^= h >> 13;
+    h *%= 0xc2b2ae35;
+    h ^= h >> 16;
+    return h;
+}
+
+/// Seed used by the hash functions built below. Change it to make the
+/// iteration order of hash maps differ between runs.
+pub var default_seed: u64 = 0;
+
+/// Returns a HashMap hash function for keys of type T which hashes the memory
+/// of the key. T must be an integer, pointer, or a struct of such types
+/// without padding, because padding bytes are undefined.
+pub fn hashRaw(comptime T: type) -> fn(key: T)->u32 {
+    const S = struct {
+        fn hash(key: T) -> u32 {
+            if (@isInteger(T)) {
+                if (T.bit_count <= 64) {
+                    const U = @intType(false, T.bit_count);
+                    const bits = *(&const U)(&key);
+                    return @truncate(u32, mix64(u64(bits) ^ default_seed));
+                }
+            }
+            return hash32(default_seed, (&const u8)(&key)[0...@sizeOf(T)]);
+        }
+    };
+    return S.hash;
+}
+
+/// Returns a HashMap eql function matching hashRaw.
+pub fn eqlRaw(comptime T: type) -> fn(a: T, b: T)->bool {
+    const S = struct {
+        fn eql(a: T, b: T) -> bool {
+            return mem.eql(u8, (&const u8)(&a)[0...@sizeOf(T)], (&const u8)(&b)[0...@sizeOf(T)]);
+        }
+    };
+    return S.eql;
+}
+
+/// Returns a HashMap hash function for slice keys, which hashes the memory of
+/// the elements. The same restrictions on T as for hashRaw apply.
+pub fn hashSlice(comptime T: type) -> fn(key: []const T)->u32 {
+    const S = struct {
+        fn hash(key: []const T) -> u32 {
+            return hash32(default_seed, ([]const u8)(key));
+        }
+    };
+    return S.hash;
+}
+
+/// Returns a HashMap eql function matching hashSlice.
+pub fn eqlSlice(comptime T: type) -> fn(a: []const T, b: []const T)->bool {
+    const S = struct {
+        fn eql(a: []const T, b: []const T) -> bool {
+            return mem.eql(T, a, b);
+        }
+    };
+    return S.eql;
+}
+
+fn testHash64() {
+    @setFnTest(this);
+
+    testHash64Impl();
+    comptime testHash64Impl();
+}
+fn testHash64Impl() {
+    // Reference values from the XXH64 implementation.
+    assert(hash64(0, "") == 0xef46db3751d8e999);
+    assert(hash64(0, "a") == 0xd24ec4f1a98c6e5b);
+    assert(hash64(0, "abc") == 0x44bc2cf5ad770999);
+    assert(hash64(0, "message digest") == 0x066ed728fceeb3be);
+    assert(hash64(0, "abcdefghijklmnopqrstuvwxyz") == 0xcfe1f278fa89835c);
+    assert(hash64(0, "12345678901234567890123456789012345678901234567890123456789012345678901234567890") ==
+        0xe04a477f19ee145d);
+    assert(hash64(1, "abc") == 0xbea9ca8199328908);
+}
+
+fn testHashHelpers() {
+    @setFnTest(this);
+
+    const hashI32 = hashRaw(i32);
+    const eqlI32 = eqlRaw(i32);
+    assert(hashI32(1) == hashI32(1));
+    assert(hashI32(1) != hashI32(2));
+    assert(eqlI32(3, 3) && !eqlI32(3, 4));
+
+    const hashString = hashSlice(u8);
+    const eqlString = eqlSlice(u8);
+    assert(hashString("hello") == hashString("hello"));
+    assert(hashString("hello") != hashString("hellp"));
+    assert(eqlString("hello", "hello") && !eqlString("hello", "hellp"));
+}
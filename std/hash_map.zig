@@ -1,20 +1,39 @@
 const debug = @import("debug.zig");
 const assert = debug.assert;
-const math = @import("math.zig");
 const mem = @import("mem.zig");
+const hash_fns = @import("hash.zig");
 const Allocator = mem.Allocator;
 
 const want_modification_safety = !@compileVar("is_release");
 const debug_u32 = if (want_modification_safety) u32 else void;
 
+// Every slot of a map has a control byte. A used slot stores the low 7 bits
+// of the hash of its key, so most mismatching keys are rejected without
+// calling eql. The high bit marks slots which are free.
+const ctrl_empty: u8 = 0x80;
+const ctrl_deleted: u8 = 0xfe;
+
+// Control bytes are examined a word at a time. The word is always loaded in
+// little endian order, so byte i of the group is bits 8*i to 8*i+7.
+const group_width = @sizeOf(usize);
+const lsbs = @maxValue(usize) / 0xff;
+const msbs = lsbs * 0x80;
+
+const min_capacity = 8;
+
 pub fn HashMap(comptime K: type, comptime V: type,
     comptime hash: fn(key: K)->u32,
     comptime eql: fn(a: K, b: K)->bool) -> type
 {
     struct {
+        // One control byte per entry, followed by a copy of the first
+        // group_width control bytes so that a group may start at any slot.
+        metadata: []u8,
         entries: []Entry,
         size: usize,
-        max_distance_from_start_index: usize,
+        // how many more keys fit before the table has to grow. deleted slots
+        // are not given back, so this only goes up when the table is rebuilt.
+        growth_left: usize,
         allocator: &Allocator,
         // this is used to detect bugs where a hashtable is edited while an iterator is running.
         modification_count: debug_u32,
@@ -22,16 +41,17 @@ pub fn HashMap(comptime K: type, comptime V: type,
         const Self = this;
 
         pub const Entry = struct {
-            used: bool,
-            distance_from_start_index: usize,
             key: K,
             value: V,
         };
 
+        pub const GetOrPutResult = struct {
+            entry: &Entry,
+            found_existing: bool,
+        };
+
         pub const Iterator = struct {
             hm: &Self,
-            // how many items have we returned
-            count: usize,
             // iterator through the entry array
             index: usize,
             // used to detect concurrent modification
@@ -41,111 +61,230 @@ pub fn HashMap(comptime K: type, comptime V: type,
                 if (want_modification_safety) {
                     assert(it.initial_modification_count == it.hm.modification_count); // concurrent modification
                 }
-                if (it.count >= it.hm.size) return null;
                 while (it.index < it.hm.entries.len; it.index += 1) {
-                    const entry = &it.hm.entries[it.index];
-                    if (entry.used) {
+                    if (it.hm.metadata[it.index] & 0x80 == 0) {
+                        const entry = &it.hm.entries[it.index];
                         it.index += 1;
-                        it.count += 1;
                         return entry;
                     }
                 }
-                @unreachable() // no next item
+                return null;
             }
         };
 
         pub fn init(hm: &Self, allocator: &Allocator) {
+            hm.metadata = []u8{};
             hm.entries = []Entry{};
             hm.allocator = allocator;
             hm.size = 0;
-            hm.max_distance_from_start_index = 0;
+            hm.growth_left = 0;
             // it doesn't actually matter what we set this to since we use wrapping integer arithmetic
             hm.modification_count = undefined;
         }
 
         pub fn deinit(hm: &Self) {
+            hm.allocator.free(hm.metadata);
             hm.allocator.free(hm.entries);
         }
 
         pub fn clear(hm: &Self) {
-            for (hm.entries) |*entry| {
-                entry.used = false;
-            }
+            mem.set(u8, hm.metadata, ctrl_empty);
             hm.size = 0;
-            hm.max_distance_from_start_index = 0;
+            hm.growth_left = maxLoad(hm.entries.len);
             hm.incrementModificationCount();
         }
 
-        pub fn put(hm: &Self, key: K, value: V) -> %void {
-            if (hm.entries.len == 0) {
-                %return hm.initCapacity(16);
+        pub fn count(hm: &const Self) -> usize {
+            return hm.size;
+        }
+
+        /// Makes room for a total of new_size keys, so that putting that many
+        /// keys does not allocate. Use it when the final size is known to
+        /// avoid rebuilding the table several times while it grows.
+        pub fn ensureCapacity(hm: &Self, new_size: usize) -> %void {
+            if (new_size <= hm.size + hm.growth_left) return;
+            var capacity: usize = min_capacity;
+            while (maxLoad(capacity) < new_size) {
+                capacity *= 2;
             }
+            %return hm.resize(capacity);
+        }
+
+        pub fn put(hm: &Self, key: K, value: V) -> %void {
+            const result = %return hm.getOrPut(key);
+            result.entry.key = key;
+            result.entry.value = value;
+        }
+
+        /// Returns the entry for key, adding one if it is missing. The value
+        /// of an added entry is undefined and must be set by the caller.
+        /// Only a single probe sequence is walked unless the table grows.
+        pub fn getOrPut(hm: &Self, key: K) -> %GetOrPutResult {
             hm.incrementModificationCount();
+            const h = hash(key);
+            const fragment = hashFragment(h);
+
+            var free_index: usize = undefined;
+            var have_free_index = false;
+            if (hm.entries.len != 0) {
+                const mask = hm.entries.len - 1;
+                var pos = usize(h >> 7) & mask;
+                var stride: usize = 0;
+                while (true) {
+                    const group = loadGroup(hm.metadata, pos);
+
+                    var matches = matchByte(group, fragment);
+                    while (matches != 0; matches &= matches - 1) {
+                        const index = (pos + lowestMatch(matches)) & mask;
+                        if (hm.metadata[index] == fragment && eql(hm.entries[index].key, key)) {
+                            return GetOrPutResult {
+                                .entry = &hm.entries[index],
+                                .found_existing = true,
+                            };
+                        }
+                    }
 
-            // if we get too full (60%), double the capacity
-            if (hm.size * 5 >= hm.entries.len * 3) {
-                const old_entries = hm.entries;
-                %return hm.initCapacity(hm.entries.len * 2);
-                // dump all of the old elements into the new table
-                for (old_entries) |*old_entry| {
-                    if (old_entry.used) {
-                        hm.internalPut(old_entry.key, old_entry.value);
+                    const free = matchEmptyOrDeleted(group);
+                    if (!have_free_index && free != 0) {
+                        free_index = (pos + lowestMatch(free)) & mask;
+                        have_free_index = true;
                     }
+                    // an empty slot ends every probe sequence which passes it
+                    if (matchEmpty(group) != 0) break;
+
+                    stride += group_width;
+                    pos = (pos + stride) & mask;
                 }
-                hm.allocator.free(old_entries);
             }
 
-            hm.internalPut(key, value);
+            // reusing a deleted slot does not use up growth, filling an empty one does
+            if (!have_free_index || (hm.metadata[free_index] == ctrl_empty && hm.growth_left == 0)) {
+                %return hm.grow();
+                free_index = hm.findInsertSlot(h);
+            }
+            if (hm.metadata[free_index] == ctrl_empty) {
+                hm.growth_left -= 1;
+            }
+            hm.setCtrl(free_index, fragment);
+            hm.size += 1;
+
+            const entry = &hm.entries[free_index];
+            entry.key = key;
+            return GetOrPutResult {
+                .entry = entry,
+                .found_existing = false,
+            };
         }
 
         pub fn get(hm: &Self, key: K) -> ?&Entry {
-            return hm.internalGet(key);
+            if (const index ?= hm.find(key)) {
+                return &hm.entries[index];
+            }
+            return null;
+        }
+
+        pub fn contains(hm: &Self, key: K) -> bool {
+            return if (const index ?= hm.find(key)) true else false;
         }
 
         pub fn remove(hm: &Self, key: K) {
             hm.incrementModificationCount();
-            const start_index = hm.keyToIndex(key);
-            {var roll_over: usize = 0; while (roll_over <= hm.max_distance_from_start_index; roll_over += 1) {
-                const index = (start_index + roll_over) % hm.entries.len;
-                var entry = &hm.entries[index];
-
-                assert(entry.used); // key not found
-
-                if (!eql(entry.key, key)) continue;
-
-                while (roll_over < hm.entries.len; roll_over += 1) {
-                    const next_index = (start_index + roll_over + 1) % hm.entries.len;
-                    const next_entry = &hm.entries[next_index];
-                    if (!next_entry.used || next_entry.distance_from_start_index == 0) {
-                        entry.used = false;
-                        hm.size -= 1;
-                        return;
-                    }
-                    *entry = *next_entry;
-                    entry.distance_from_start_index -= 1;
-                    entry = next_entry;
-                }
-                @unreachable() // shifting everything in the table
-            }}
-            @unreachable() // key not found
+            const index = hm.find(key) ?? @unreachable(); // key not found
+            hm.setCtrl(index, ctrl_deleted);
+            hm.size -= 1;
         }
 
         pub fn entryIterator(hm: &Self) -> Iterator {
             return Iterator {
                 .hm = hm,
-                .count = 0,
                 .index = 0,
                 .initial_modification_count = hm.modification_count,
             };
         }
 
-        fn initCapacity(hm: &Self, capacity: usize) -> %void {
-            hm.entries = %return hm.allocator.alloc(Entry, capacity);
-            hm.size = 0;
-            hm.max_distance_from_start_index = 0;
-            for (hm.entries) |*entry| {
-                entry.used = false;
+        fn find(hm: &Self, key: K) -> ?usize {
+            if (hm.entries.len == 0) return null;
+            const h = hash(key);
+            const fragment = hashFragment(h);
+            const mask = hm.entries.len - 1;
+            var pos = usize(h >> 7) & mask;
+            var stride: usize = 0;
+            while (true) {
+                const group = loadGroup(hm.metadata, pos);
+                var matches = matchByte(group, fragment);
+                while (matches != 0; matches &= matches - 1) {
+                    const index = (pos + lowestMatch(matches)) & mask;
+                    if (hm.metadata[index] == fragment && eql(hm.entries[index].key, key)) {
+                        return index;
+                    }
+                }
+                if (matchEmpty(group) != 0) return null;
+
+                stride += group_width;
+                pos = (pos + stride) & mask;
+            }
+        }
+
+        /// Returns the first free slot on the probe sequence of h. The table
+        /// must have room for another key.
+        fn findInsertSlot(hm: &Self, h: u32) -> usize {
+            const mask = hm.entries.len - 1;
+            var pos = usize(h >> 7) & mask;
+            var stride: usize = 0;
+            while (true) {
+                const free = matchEmptyOrDeleted(loadGroup(hm.metadata, pos));
+                if (free != 0) {
+                    return (pos + lowestMatch(free)) & mask;
+                }
+                stride += group_width;
+                pos = (pos + stride) & mask;
+            }
+        }
+
+        fn setCtrl(hm: &Self, index: usize, ctrl: u8) {
+            hm.metadata[index] = ctrl;
+            if (index < group_width) {
+                hm.metadata[hm.entries.len + index] = ctrl;
+            }
+        }
+
+        /// Called when no empty slot may be filled. If deleted slots take up
+        /// much of the table it is rebuilt at the same size, otherwise at twice
+        /// the size.
+        fn grow(hm: &Self) -> %void {
+            const capacity = hm.entries.len;
+            if (capacity == 0) {
+                %return hm.resize(min_capacity);
+            } else if (hm.size < maxLoad(capacity) / 2) {
+                %return hm.resize(capacity);
+            } else {
+                %return hm.resize(capacity * 2);
+            }
+        }
+
+        fn resize(hm: &Self, capacity: usize) -> %void {
+            const new_metadata = %return hm.allocator.alloc(u8, capacity + group_width);
+            %defer hm.allocator.free(new_metadata);
+            const new_entries = %return hm.allocator.alloc(Entry, capacity);
+
+            const old_metadata = hm.metadata;
+            const old_entries = hm.entries;
+            hm.metadata = new_metadata;
+            hm.entries = new_entries;
+            mem.set(u8, hm.metadata, ctrl_empty);
+            hm.growth_left = maxLoad(capacity) - hm.size;
+
+            // keys are known to be distinct, so they are placed without calling eql
+            for (old_entries) |*old_entry, i| {
+                if (old_metadata[i] & 0x80 == 0) {
+                    const h = hash(old_entry.key);
+                    const index = hm.findInsertSlot(h);
+                    hm.setCtrl(index, hashFragment(h));
+                    hm.entries[index] = *old_entry;
+                }
             }
+            hm.allocator.free(old_metadata);
+            hm.allocator.free(old_entries);
         }
 
         fn incrementModificationCount(hm: &Self) {
@@ -153,76 +292,112 @@ pub fn HashMap(comptime K: type, comptime V: type,
                 hm.modification_count +%= 1;
             }
         }
+    }
+}
 
-        fn internalPut(hm: &Self, orig_key: K, orig_value: V) {
-            var key = orig_key;
-            var value = orig_value;
-            const start_index = hm.keyToIndex(key);
-            var roll_over: usize = 0;
-            var distance_from_start_index: usize = 0;
-            while (roll_over < hm.entries.len; {roll_over += 1; distance_from_start_index += 1}) {
-                const index = (start_index + roll_over) % hm.entries.len;
-                const entry = &hm.entries[index];
-
-                if (entry.used && !eql(entry.key, key)) {
-                    if (entry.distance_from_start_index < distance_from_start_index) {
-                        // robin hood to the rescue
-                        const tmp = *entry;
-                        hm.max_distance_from_start_index = math.max(hm.max_distance_from_start_index,
-                            distance_from_start_index);
-                        *entry = Entry {
-                            .used = true,
-                            .distance_from_start_index = distance_from_start_index,
-                            .key = key,
-                            .value = value,
-                        };
-                        key = tmp.key;
-                        value = tmp.value;
-                        distance_from_start_index = tmp.distance_from_start_index;
-                    }
-                    continue;
-                }
+/// A set of keys, which is a HashMap without values.
+pub fn HashSet(comptime K: type,
+    comptime hash: fn(key: K)->u32,
+    comptime eql: fn(a: K, b: K)->bool) -> type
+{
+    struct {
+        map: Map,
 
-                if (!entry.used) {
-                    // adding an entry. otherwise overwriting old value with
-                    // same key
-                    hm.size += 1;
-                }
+        const Self = this;
+        const Map = HashMap(K, void, hash, eql);
 
-                hm.max_distance_from_start_index = math.max(distance_from_start_index, hm.max_distance_from_start_index);
-                *entry = Entry {
-                    .used = true,
-                    .distance_from_start_index = distance_from_start_index,
-                    .key = key,
-                    .value = value,
-                };
-                return;
+        pub const Iterator = struct {
+            it: Map.Iterator,
+
+            pub fn next(it: &Iterator) -> ?K {
+                const entry = it.it.next() ?? return null;
+                return entry.key;
             }
-            @unreachable() // put into a full map
+        };
+
+        pub fn init(set: &Self, allocator: &Allocator) {
+            set.map.init(allocator);
         }
 
-        fn internalGet(hm: &Self, key: K) -> ?&Entry {
-            const start_index = hm.keyToIndex(key);
-            {var roll_over: usize = 0; while (roll_over <= hm.max_distance_from_start_index; roll_over += 1) {
-                const index = (start_index + roll_over) % hm.entries.len;
-                const entry = &hm.entries[index];
+        pub fn deinit(set: &Self) {
+            set.map.deinit();
+        }
 
-                if (!entry.used) return null;
-                if (eql(entry.key, key)) return entry;
-            }}
-            return null;
+        pub fn clear(set: &Self) {
+            set.map.clear();
+        }
+
+        pub fn count(set: &const Self) -> usize {
+            return set.map.count();
+        }
+
+        pub fn ensureCapacity(set: &Self, new_size: usize) -> %void {
+            return set.map.ensureCapacity(new_size);
         }
 
-        fn keyToIndex(hm: &Self, key: K) -> usize {
-            return usize(hash(key)) % hm.entries.len;
+        /// Adds key to the set. Returns whether it was already there.
+        pub fn put(set: &Self, key: K) -> %bool {
+            const result = %return set.map.getOrPut(key);
+            return result.found_existing;
+        }
+
+        pub fn contains(set: &Self, key: K) -> bool {
+            return set.map.contains(key);
+        }
+
+        pub fn remove(set: &Self, key: K) {
+            set.map.remove(key);
+        }
+
+        pub fn iterator(set: &Self) -> Iterator {
+            return Iterator {
+                .it = set.map.entryIterator(),
+            };
         }
     }
 }
 
+/// The most keys a table of the given capacity holds, which is 7/8 of it.
+/// At least one slot stays empty so that every probe sequence ends.
+fn maxLoad(capacity: usize) -> usize {
+    return capacity - capacity / 8;
+}
+
+fn hashFragment(h: u32) -> u8 {
+    return @truncate(u8, h) & 0x7f;
+}
+
+// The load is not necessarily aligned.
+fn loadGroup(metadata: []const u8, pos: usize) -> usize {
+    return mem.readInt(metadata[pos...pos + group_width], usize, false);
+}
+
+/// Sets the high bit of each byte of the group which equals byte. May also
+/// set it for a byte following a match, so candidates must be checked.
+fn matchByte(group: usize, byte: u8) -> usize {
+    const x = group ^ (lsbs * usize(byte));
+    return (x -% lsbs) & ~x & msbs;
+}
+
+/// Sets the high bit of each byte of the group which is ctrl_empty.
+fn matchEmpty(group: usize) -> usize {
+    return group & (~group <<% 6) & msbs;
+}
+
+/// Sets the high bit of each byte of the group which is ctrl_empty or ctrl_deleted.
+fn matchEmptyOrDeleted(group: usize) -> usize {
+    return group & ~(group <<% 7) & msbs;
+}
+
+/// Index within the group of the first byte set in a mask from the match functions.
+fn lowestMatch(mask: usize) -> usize {
+    return usize(@ctz(mask)) / 8;
+}
+
 fn basicHashMapTest() {
     @setFnTest(this);
 
-    var map: HashMap(i32, i32, hash_i32, eql_i32) = undefined;
+    var map: HashMap(i32, i32, hash_fns.hashRaw(i32), hash_fns.eqlRaw(i32)) = undefined;
     map.init(&debug.global_allocator);
     defer map.deinit();
 
@@ -237,9 +412,107 @@ fn basicHashMapTest() {
     assert(if (const entry ?= map.get(2)) false else true);
 }
 
-fn hash_i32(x: i32) -> u32 {
-    *(&u32)(&x)
+fn stringKeyHashMapTest() {
+    @setFnTest(this);
+
+    var map: HashMap([]const u8, i32, hash_fns.hashSlice(u8), hash_fns.eqlSlice(u8)) = undefined;
+    map.init(&debug.global_allocator);
+    defer map.deinit();
+
+    %%map.put("one", 1);
+    %%map.put("two", 2);
+    %%map.put("three", 3);
+
+    assert((??map.get("two")).value == 2);
+    assert(if (const entry ?= map.get("four")) false else true);
+}
+
+fn hashMapGrowAndRemoveTest() {
+    @setFnTest(this);
+
+    var map: HashMap(u32, u32, hash_fns.hashRaw(u32), hash_fns.eqlRaw(u32)) = undefined;
+    map.init(&debug.global_allocator);
+    defer map.deinit();
+
+    {var i: u32 = 0; while (i < 1000; i += 1) {
+        %%map.put(i, i * 2);
+    }}
+    assert(map.count() == 1000);
+    assert(map.entries.len & (map.entries.len - 1) == 0);
+
+    {var i: u32 = 0; while (i < 1000; i += 2) {
+        map.remove(i);
+    }}
+    assert(map.count() == 500);
+    {var i: u32 = 0; while (i < 1000; i += 1) {
+        if (i % 2 == 0) {
+            assert(!map.contains(i));
+        } else {
+            assert((??map.get(i)).value == i * 2);
+        }
+    }}
+
+    // put into deleted slots, then check iteration sees every key once
+    {var i: u32 = 0; while (i < 1000; i += 2) {
+        %%map.put(i, i * 2);
+    }}
+    var sum: u32 = 0;
+    var seen: usize = 0;
+    var it = map.entryIterator();
+    while (true) {
+        const entry = it.next() ?? break;
+        assert(entry.value == entry.key * 2);
+        sum += entry.key;
+        seen += 1;
+    }
+    assert(seen == 1000);
+    assert(sum == 999 * 1000 / 2);
+
+    map.clear();
+    assert(map.count() == 0);
+    assert(!map.contains(1));
+}
+
+fn hashMapGetOrPutTest() {
+    @setFnTest(this);
+
+    var map: HashMap(u32, u32, hash_fns.hashRaw(u32), hash_fns.eqlRaw(u32)) = undefined;
+    map.init(&debug.global_allocator);
+    defer map.deinit();
+
+    %%map.ensureCapacity(100);
+    const capacity = map.entries.len;
+    {var i: u32 = 0; while (i < 300; i += 1) {
+        const result = %%map.getOrPut(i % 100);
+        if (result.found_existing) {
+            result.entry.value += 1;
+        } else {
+            result.entry.value = 1;
+        }
+    }}
+    assert(map.entries.len == capacity);
+    assert(map.count() == 100);
+    {var i: u32 = 0; while (i < 100; i += 1) {
+        assert((??map.get(i)).value == 3);
+    }}
 }
-fn eql_i32(a: i32, b: i32) -> bool {
-    a == b
+
+fn hashSetTest() {
+    @setFnTest(this);
+
+    var set: HashSet([]const u8, hash_fns.hashSlice(u8), hash_fns.eqlSlice(u8)) = undefined;
+    set.init(&debug.global_allocator);
+    defer set.deinit();
+
+    assert(!%%set.put("apple"));
+    assert(!%%set.put("pear"));
+    assert(%%set.put("apple"));
+    assert(set.count() == 2);
+    assert(set.contains("pear"));
+    set.remove("pear");
+    assert(!set.contains("pear"));
+
+    var it = set.iterator();
+    assert(mem.eql(u8, ??it.next(), "apple"));
+    assert(if (const key ?= it.next()) false else true);
 }
@@ -0,0 +1,397 @@
+const debug = @import("debug.zig");
+const assert = debug.assert;
+const mem = @import("mem.zig");
+const linux = @import("linux.zig");
+const List = @import("list.zig").List;
+
+const page_size = 4 * 1024;
+
+/// Small allocations are rounded up to a power of two between these sizes and
+/// carved out of slabs. Anything bigger gets its own mapping.
+const min_small_size = 16;
+const max_small_size = 2048;
+const size_class_count = 8;
+
+/// How much memory is mapped at once when a size class runs out of blocks.
+const slab_size = 64 * 1024;
+
+/// A general purpose allocator which gets its memory straight from the kernel
+/// with mmap, so it does not need libc. It is not thread safe.
+///
+/// Freed small blocks go back on a free list for their size class, and are
+/// never returned to the kernel. Large allocations are unmapped when freed, and
+/// resized with mremap so that growing them does not copy.
+pub var heap_allocator = mem.Allocator {
+    .allocFn = heapAlloc,
+    .reallocFn = heapRealloc,
+    .freeFn = heapFree,
+    .context = null,
+};
+
+/// Address of the first free block of each size class, or 0 if there is none.
+/// Every free block holds the address of the next one in its first word.
+var free_lists = []usize{0} ** size_class_count;
+
+fn heapAlloc(self: &mem.Allocator, n: usize) -> %[]u8 {
+    if (n == 0)
+        return []u8{};
+    if (n > max_small_size) {
+        const addr = %return mapPages(alignForward(n, page_size));
+        return (&u8)(addr)[0...n];
+    }
+    const class = sizeClass(n);
+    if (free_lists[class] == 0)
+        %return refillSizeClass(class);
+    const addr = free_lists[class];
+    free_lists[class] = *(&usize)(addr);
+    return (&u8)(addr)[0...n];
+}
+
+fn heapRealloc(self: &mem.Allocator, old_mem: []u8, new_size: usize) -> %[]u8 {
+    if (old_mem.len == 0)
+        return heapAlloc(self, new_size);
+    if (new_size == 0) {
+        heapFree(self, old_mem);
+        return []u8{};
+    }
+
+    if (old_mem.len > max_small_size && new_size > max_small_size) {
+        const old_map_len = alignForward(old_mem.len, page_size);
+        const new_map_len = alignForward(new_size, page_size);
+        if (old_map_len == new_map_len)
+            return old_mem.ptr[0...new_size];
+        const addr = linux.mremap(old_mem.ptr, old_map_len, new_map_len, linux.MREMAP_MAYMOVE, null);
+        if (linux.getErrno(addr) > 0)
+            return error.NoMem;
+        return (&u8)(addr)[0...new_size];
+    }
+
+    // The size class of a block is implied by the length of the slice, so a
+    // small block can only be resized in place within its own class.
+    if (old_mem.len <= max_small_size && new_size <= max_small_size &&
+        sizeClass(old_mem.len) == sizeClass(new_size))
+    {
+        return old_mem.ptr[0...new_size];
+    }
+
+    const result = %return heapAlloc(self, new_size);
+    const copy_len = if (old_mem.len < new_size) old_mem.len else new_size;
+    @memcpy(result.ptr, old_mem.ptr, copy_len);
+    heapFree(self, old_mem);
+    return result;
+}
+
+fn heapFree(self: &mem.Allocator, old_mem: []u8) {
+    if (old_mem.len == 0)
+        return;
+    if (old_mem.len > max_small_size) {
+        _ = linux.munmap(old_mem.ptr, alignForward(old_mem.len, page_size));
+        return;
+    }
+    pushFreeBlock(sizeClass(old_mem.len), usize(old_mem.ptr));
+}
+
+/// Maps a new slab and splits it into blocks of the given size class, so that
+/// the lowest addresses are handed out first.
+fn refillSizeClass(class: usize) -> %void {
+    const block_size = usize(min_small_size) << class;
+    const slab = %return mapPages(slab_size);
+    var offset: usize = slab_size;
+    while (offset >= block_size) {
+        offset -= block_size;
+        pushFreeBlock(class, slab + offset);
+    }
+}
+
+fn pushFreeBlock(class: usize, addr: usize) {
+    *(&usize)(addr) = free_lists[class];
+    free_lists[class] = addr;
+}
+
+fn mapPages(len: usize) -> %usize {
+    const addr = linux.mmap(null, len, linux.MMAP_PROT_READ|linux.MMAP_PROT_WRITE,
+        linux.MMAP_MAP_PRIVATE|linux.MMAP_MAP_ANON, -1, 0);
+    if (linux.getErrno(addr) > 0)
+        return error.NoMem;
+    return addr;
+}
+
+fn sizeClass(n: usize) -> usize {
+    assert(n != 0 && n <= max_small_size);
+    if (n <= min_small_size)
+        return 0;
+    // Number of bits needed for n rounded up to a power of two, minus those
+    // of min_small_size.
+    return @sizeOf(usize) * 8 - usize(@clz(n - 1)) - 4;
+}
+
+fn alignForward(n: usize, alignment: usize) -> usize {
+    return (n + alignment - 1) & ~(alignment - 1);
+}
+
+/// Allocations handed out by the bump allocators are aligned like malloc
+/// results, so that any type can be stored in them.
+const bump_align = 2 * @sizeOf(usize);
+
+/// Bumps an allocation of n bytes out of buffer, or returns null if there is
+/// not enough room left after end_index.
+fn bumpAlloc(buffer: []u8, end_index: &usize, n: usize) -> ?[]u8 {
+    const addr = usize(buffer.ptr);
+    const start = alignForward(addr + *end_index, bump_align) - addr;
+    if (start > buffer.len || n > buffer.len - start)
+        return null;
+    *end_index = start + n;
+    return buffer[start...*end_index];
+}
+
+/// Resizes old_mem in place if it is the most recent allocation out of buffer
+/// and the new size fits, otherwise returns null.
+fn bumpResize(buffer: []u8, end_index: &usize, old_mem: []u8, new_size: usize) -> ?[]u8 {
+    if (old_mem.len == 0 || usize(old_mem.ptr) + old_mem.len != usize(buffer.ptr) + *end_index)
+        return null;
+    const start = *end_index - old_mem.len;
+    if (new_size > buffer.len - start)
+        return null;
+    *end_index = start + new_size;
+    return buffer[start...*end_index];
+}
+
+/// Gives back the most recent allocation out of buffer. Anything else is only
+/// reclaimed when the whole buffer is.
+fn bumpFree(buffer: []u8, end_index: &usize, old_mem: []u8) {
+    if (old_mem.len != 0 && usize(old_mem.ptr) + old_mem.len == usize(buffer.ptr) + *end_index)
+        *end_index -= old_mem.len;
+}
+
+/// Allocates out of a caller provided buffer by bumping an index. Individual
+/// frees do nothing, except for the most recent allocation; use reset to reuse
+/// the whole buffer.
+pub const FixedBufferAllocator = struct {
+    allocator: mem.Allocator,
+    buffer: []u8,
+    end_index: usize,
+
+    /// self must not move while the allocator is in use.
+    pub fn init(self: &FixedBufferAllocator, buffer: []u8) {
+        self.allocator = mem.Allocator {
+            .allocFn = fixedBufferAlloc,
+            .reallocFn = fixedBufferRealloc,
+            .freeFn = fixedBufferFree,
+            .context = (&mem.Context)(self),
+        };
+        self.buffer = buffer;
+        self.end_index = 0;
+    }
+
+    /// Invalidates everything allocated so far.
+    pub fn reset(self: &FixedBufferAllocator) {
+        self.end_index = 0;
+    }
+};
+
+fn getFixedBufferAllocator(allocator: &mem.Allocator) -> &FixedBufferAllocator {
+    return (&FixedBufferAllocator)(allocator.context ?? @unreachable());
+}
+
+fn fixedBufferAlloc(allocator: &mem.Allocator, n: usize) -> %[]u8 {
+    const self = getFixedBufferAllocator(allocator);
+    return bumpAlloc(self.buffer, &self.end_index, n) ?? error.NoMem;
+}
+
+fn fixedBufferRealloc(allocator: &mem.Allocator, old_mem: []u8, new_size: usize) -> %[]u8 {
+    const self = getFixedBufferAllocator(allocator);
+    if (const result ?= bumpResize(self.buffer, &self.end_index, old_mem, new_size))
+        return result;
+    if (new_size <= old_mem.len)
+        return old_mem[0...new_size];
+    const result = bumpAlloc(self.buffer, &self.end_index, new_size) ?? return error.NoMem;
+    @memcpy(result.ptr, old_mem.ptr, old_mem.len);
+    return result;
+}
+
+fn fixedBufferFree(allocator: &mem.Allocator, old_mem: []u8) {
+    const self = getFixedBufferAllocator(allocator);
+    bumpFree(self.buffer, &self.end_index, old_mem);
+}
+
+/// Allocates by bumping through chunks obtained from a child allocator, and
+/// frees all of them at once in deinit.
+pub const ArenaAllocator = struct {
+    allocator: mem.Allocator,
+    child_allocator: &mem.Allocator,
+    /// The chunk allocations currently come from. Every chunk starts with a
+    /// ChunkHeader pointing to the previous one.
+    chunk: []u8,
+    end_index: usize,
+
+    const ChunkHeader = struct {
+        prev_chunk: []u8,
+    };
+
+    /// Smallest chunk requested from the child allocator.
+    const min_chunk_size = 4 * 1024;
+
+    /// self must not move while the allocator is in use.
+    pub fn init(self: &ArenaAllocator, child_allocator: &mem.Allocator) {
+        self.allocator = mem.Allocator {
+            .allocFn = arenaAlloc,
+            .reallocFn = arenaRealloc,
+            .freeFn = arenaFree,
+            .context = (&mem.Context)(self),
+        };
+        self.child_allocator = child_allocator;
+        self.chunk = []u8{};
+        self.end_index = 0;
+    }
+
+    /// Frees everything allocated from the arena.
+    pub fn deinit(self: &ArenaAllocator) {
+        var chunk = self.chunk;
+        while (chunk.len != 0) {
+            const prev_chunk = (&ChunkHeader)(chunk.ptr).prev_chunk;
+            self.child_allocator.free(chunk);
+            chunk = prev_chunk;
+        }
+        self.chunk = []u8{};
+        self.end_index = 0;
+    }
+
+    /// Starts a new chunk with room for at least n bytes. Chunks grow
+    /// geometrically so that the number of them stays logarithmic.
+    fn addChunk(self: &ArenaAllocator, n: usize) -> %void {
+        const needed = @sizeOf(ChunkHeader) + bump_align + n;
+        var len = self.chunk.len + self.chunk.len / 2 + min_chunk_size;
+        if (len < needed)
+            len = needed;
+        const chunk = %return self.child_allocator.alloc(u8, len);
+        (&ChunkHeader)(chunk.ptr).prev_chunk = self.chunk;
+        self.chunk = chunk;
+        self.end_index = @sizeOf(ChunkHeader);
+    }
+};
+
+fn getArenaAllocator(allocator: &mem.Allocator) -> &ArenaAllocator {
+    return (&ArenaAllocator)(allocator.context ?? @unreachable());
+}
+
+fn arenaAlloc(allocator: &mem.Allocator, n: usize) -> %[]u8 {
+    const self = getArenaAllocator(allocator);
+    if (const result ?= bumpAlloc(self.chunk, &self.end_index, n))
+        return result;
+    %return self.addChunk(n);
+    return bumpAlloc(self.chunk, &self.end_index, n) ?? @unreachable();
+}
+
+fn arenaRealloc(allocator: &mem.Allocator, old_mem: []u8, new_size: usize) -> %[]u8 {
+    const self = getArenaAllocator(allocator);
+    if (const result ?= bumpResize(self.chunk, &self.end_index, old_mem, new_size))
+        return result;
+    if (new_size <= old_mem.len)
+        return old_mem[0...new_size];
+    const result = %return arenaAlloc(allocator, new_size);
+    @memcpy(result.ptr, old_mem.ptr, old_mem.len);
+    return result;
+}
+
+fn arenaFree(allocator: &mem.Allocator, old_mem: []u8) {
+    const self = getArenaAllocator(allocator);
+    bumpFree(self.chunk, &self.end_index, old_mem);
+}
+
+fn testSizeClass() {
+    @setFnTest(this);
+
+    assert(sizeClass(1) == 0);
+    assert(sizeClass(16) == 0);
+    assert(sizeClass(17) == 1);
+    assert(sizeClass(32) == 1);
+    assert(sizeClass(1025) == 7);
+    assert(sizeClass(2048) == 7);
+}
+
+fn testHeapAllocator() {
+    @setFnTest(this);
+
+    if (@compileVar("os") != Os.linux) return;
+
+    const allocator = &heap_allocator;
+
+    // Freed small blocks are reused.
+    const a = %%allocator.alloc(u8, 20);
+    allocator.free(a);
+    const b = %%allocator.alloc(u8, 30);
+    assert(a.ptr == b.ptr);
+
+    // Growing within the size class does not move.
+    const c = %%allocator.realloc(u8, b, 32);
+    assert(c.ptr == b.ptr);
+
+    // Growing past the size class moves and keeps the contents.
+    for (c) |*byte, i| {
+        *byte = u8(i);
+    }
+    const d = %%allocator.realloc(u8, c, 5000);
+    for (d[0...32]) |byte, i| {
+        assert(byte == u8(i));
+    }
+
+    // Large allocations are resized with mremap.
+    d[4999] = 0xaa;
+    const e = %%allocator.realloc(u8, d, 1024 * 1024);
+    assert(e[4999] == 0xaa);
+    e[1024 * 1024 - 1] = 0xbb;
+    allocator.free(e);
+}
+
+fn testFixedBufferAllocator() {
+    @setFnTest(this);
+
+    var buffer: [512]u8 = undefined;
+    var fixed: FixedBufferAllocator = undefined;
+    fixed.init(buffer[0...]);
+    const allocator = &fixed.allocator;
+
+    // The most recent allocation grows in place.
+    const a = %%allocator.alloc(u8, 10);
+    a[0] = 0xaa;
+    const b = %%allocator.realloc(u8, a, 100);
+    assert(b.ptr == a.ptr && b[0] == 0xaa);
+
+    // Anything else is copied.
+    const c = %%allocator.alloc(u8, 16);
+    const d = %%allocator.realloc(u8, b, 110);
+    assert(d.ptr != b.ptr && d[0] == 0xaa);
+
+    const out_of_memory = try (allocator.alloc(u8, 512)) {
+        false
+    } else {
+        true
+    };
+    assert(out_of_memory);
+
+    fixed.reset();
+    const e = %%allocator.alloc(u8, 256);
+    assert(e.len == 256);
+}
+
+fn testArenaAllocator() {
+    @setFnTest(this);
+
+    var arena: ArenaAllocator = undefined;
+    arena.init(&debug.global_allocator);
+    defer arena.deinit();
+    const allocator = &arena.allocator;
+
+    var list = List(u64).init(allocator);
+    {var i: usize = 0; while (i < 100; i += 1) {
+        %%list.append(i);
+    }}
+    {var i: usize = 0; while (i < 100; i += 1) {
+        assert(list.items[i] == i);
+    }}
+
+    // Larger than a whole chunk.
+    const big = %%allocator.alloc(u8, 10 * 1024);
+    big[10 * 1024 - 1] = 0xaa;
+    assert(usize(big.ptr) % bump_align == 0);
+}
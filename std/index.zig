@@ -6,13 +6,29 @@ pub const cstr = @import("cstr.zig");
 pub const sort = @import("sort.zig");
 pub const net = @import("net.zig");
 pub const list = @import("list.zig");
+pub const hash = @import("hash.zig");
 pub const hash_map = @import("hash_map.zig");
+pub const atomic = @import("atomic.zig");
+pub const queue = @import("queue.zig");
 pub const mem = @import("mem.zig");
+pub const heap = @import("heap.zig");
 pub const debug = @import("debug.zig");
 pub const linux = switch(@compileVar("os")) {
     Os.linux => @import("linux.zig"),
     else => null_import,
 };
+pub const event = switch(@compileVar("os")) {
+    Os.linux => @import("event.zig"),
+    else => null_import,
+};
+pub const thread = switch(@compileVar("os")) {
+    Os.linux => @import("thread.zig"),
+    else => null_import,
+};
+pub const io_uring = switch(@compileVar("os")) {
+    Os.linux => @import("io_uring.zig"),
+    else => null_import,
+};
 pub const darwin = switch(@compileVar("os")) {
     Os.darwin => @import("darwin.zig"),
     else => null_import,
@@ -11,6 +11,7 @@ const assert = debug.assert;
 const os = @import("os.zig");
 const mem = @import("mem.zig");
 const Buffer0 = @import("cstr.zig").Buffer0;
+const float_print = @import("float_print.zig");
 
 pub const stdin_fileno = 0;
 pub const stdout_fileno = 1;
@@ -59,9 +60,9 @@ error PathNotFound;
 error NoMem;
 error Unseekable;
 error Eof;
+error StreamTooLong;
 
 const buffer_size = 4 * 1024;
-const max_f64_digits = 65;
 const max_int_digits = 65;
 
 pub const OpenRead     = 0b0001;
@@ -80,20 +81,50 @@ pub const OutStream = struct {
         self.index += 1;
     }
 
+    /// Small writes are collected in the buffer. A write which does not fit
+    /// in the buffer is sent together with the buffered bytes in one writev
+    /// call instead of being copied.
     pub fn write(self: &OutStream, bytes: []const u8) -> %void {
-        var src_bytes_left = bytes.len;
-        var src_index: usize = 0;
-        const dest_space_left = self.buffer.len - self.index;
-
-        while (src_bytes_left > 0) {
-            const copy_amt = math.min(dest_space_left, src_bytes_left);
-            @memcpy(&self.buffer[self.index], &bytes[src_index], copy_amt);
-            self.index += copy_amt;
-            if (self.index == self.buffer.len) {
-                %return self.flush();
-            }
-            src_bytes_left -= copy_amt;
+        if (bytes.len <= self.buffer.len - self.index) {
+            mem.copy(u8, self.buffer[self.index...], bytes);
+            self.index += bytes.len;
+            return;
+        }
+        if (bytes.len < self.buffer.len) {
+            // top up the buffer so that it goes out in full
+            const copy_amt = self.buffer.len - self.index;
+            mem.copy(u8, self.buffer[self.index...], bytes[0...copy_amt]);
+            self.index = self.buffer.len;
+            %return self.flush();
+            mem.copy(u8, self.buffer[0...], bytes[copy_amt...]);
+            self.index = bytes.len - copy_amt;
+            return;
         }
+        var iovecs = []system.iovec_const {
+            system.iovec_const {
+                .iov_base = &self.buffer[0],
+                .iov_len = self.index,
+            },
+            system.iovec_const {
+                .iov_base = bytes.ptr,
+                .iov_len = bytes.len,
+            },
+        };
+        var written: usize = 0;
+        writevAll(self.fd, iovecs[0...], &written) %% |err| {
+            self.dropWritten(math.min(written, self.index));
+            return err;
+        };
+        self.index = 0;
+    }
+
+    // The runs of a printf format between its arguments are known at compile
+    // time, so when they fit they are copied with a constant length, which
+    // LLVM turns into a few moves.
+    fn writeLiteral(self: &OutStream, comptime bytes: []const u8) -> %void {
+        if (bytes.len > self.buffer.len - self.index) return self.write(bytes);
+        @memcpy(&self.buffer[self.index], bytes.ptr, bytes.len);
+        self.index += bytes.len;
     }
 
     const State = enum { // TODO put inside printf function and make sure the name and debug info is correct
@@ -119,11 +150,11 @@ pub const OutStream = struct {
             switch (state) {
                 State.Start => switch (c) {
                     '{' => {
-                        if (start_index < i) %return self.write(format[start_index...i]);
+                        if (start_index < i) %return self.writeLiteral(format[start_index...i]);
                         state = State.OpenBrace;
                     },
                     '}' => {
-                        if (start_index < i) %return self.write(format[start_index...i]);
+                        if (start_index < i) %return self.writeLiteral(format[start_index...i]);
                         state = State.CloseBrace;
                     },
                     else => {},
@@ -213,7 +244,7 @@ pub const OutStream = struct {
             }
         }
         if (start_index < format.len) {
-            %return self.write(format[start_index...format.len]);
+            %return self.writeLiteral(format[start_index...format.len]);
         }
         %return self.flush();
     }
@@ -235,13 +266,41 @@ pub const OutStream = struct {
     }
 
     pub fn printInt(self: &OutStream, x: var, base: u8, uppercase: bool, width: usize) -> %void {
-        if (self.index + max_int_digits >= self.buffer.len) {
+        const max_len = if (width < max_int_digits) max_int_digits else width + 1;
+        if (max_len >= self.buffer.len) {
+            return self.printIntPadded(x, base, uppercase, width);
+        }
+        if (self.index + max_len >= self.buffer.len) {
             %return self.flush();
         }
         const amt_printed = bufPrintInt(self.buffer[self.index...], x, base, uppercase, width);
         self.index += amt_printed;
     }
 
+    /// For a width which does not fit in the buffer. The sign and digits are
+    /// printed on the side and the zeros between them are written one by one.
+    fn printIntPadded(self: &OutStream, x: var, base: u8, uppercase: bool, width: usize) -> %void {
+        var buf: [max_int_digits]u8 = undefined;
+        // a width of 1 gives the sign of a signed x but never any padding
+        const len = bufPrintInt(buf[0...], x, base, uppercase, 1);
+        const sign_len: usize = if (buf[0] == '-' || buf[0] == '+') 1 else 0;
+        %return self.write(buf[0...sign_len]);
+        var padding = width - len;
+        while (padding > 0; padding -= 1) {
+            %return self.writeByte('0');
+        }
+        %return self.write(buf[sign_len...len]);
+    }
+
+    /// Prints the shortest decimal which parses back to x. See bufPrintFloat.
+    pub fn printFloat(self: &OutStream, comptime T: type, x: T) -> %void {
+        if (self.index + float_print.max_float_digits >= self.buffer.len) {
+            %return self.flush();
+        }
+        const amt_printed = bufPrintFloat(self.buffer[self.index...], x);
+        self.index += amt_printed;
+    }
+
     pub fn printAsciiChar(self: &OutStream, c: u8) -> %void {
         if (self.index + 1 >= self.buffer.len) {
             %return self.flush();
@@ -251,25 +310,29 @@ pub const OutStream = struct {
     }
 
     pub fn flush(self: &OutStream) -> %void {
-        while (true) {
-            const write_ret = system.write(self.fd, &self.buffer[0], self.index);
-            const write_err = system.getErrno(write_ret);
-            if (write_err > 0) {
-                return switch (write_err) {
-                    errno.EINTR  => continue,
-                    errno.EINVAL => @unreachable(),
-                    errno.EDQUOT => error.DiskQuota,
-                    errno.EFBIG  => error.FileTooBig,
-                    errno.EIO    => error.Io,
-                    errno.ENOSPC => error.NoSpaceLeft,
-                    errno.EPERM  => error.BadPerm,
-                    errno.EPIPE  => error.PipeFail,
-                    else         => error.Unexpected,
-                }
-            }
-            self.index = 0;
-            return;
+        if (self.index == 0) return;
+        var iovecs = []system.iovec_const {
+            system.iovec_const {
+                .iov_base = &self.buffer[0],
+                .iov_len = self.index,
+            },
+        };
+        var written: usize = 0;
+        writevAll(self.fd, iovecs[0...], &written) %% |err| {
+            self.dropWritten(written);
+            return err;
+        };
+        self.index = 0;
+    }
+
+    // Removes the first amt bytes of the buffer after they were written, so
+    // that a flush after an error does not write them again.
+    fn dropWritten(self: &OutStream, amt: usize) {
+        // The ranges may overlap, so this cannot be mem.copy.
+        for (self.buffer[amt...self.index]) |b, i| {
+            self.buffer[i] = b;
         }
+        self.index -= amt;
     }
 
     pub fn close(self: &OutStream) {
@@ -283,8 +346,45 @@ pub const OutStream = struct {
     }
 };
 
-// TODO created a BufferedInStream struct and move some of this code there
-// BufferedInStream API goes on top of minimal InStream API.
+/// Writes every byte described by iovecs, calling writev again after a partial
+/// write. The iovecs are modified to track progress, and written counts the
+/// bytes written, which are not all of them when an error is returned.
+fn writevAll(fd: i32, iovecs: []system.iovec_const, written: &usize) -> %void {
+    *written = 0;
+    var iov = iovecs;
+    while (iov.len > 0) {
+        const write_ret = system.writev(fd, &iov[0], iov.len);
+        const write_err = system.getErrno(write_ret);
+        if (write_err > 0) {
+            return switch (write_err) {
+                errno.EINTR  => continue,
+                errno.EINVAL => @unreachable(),
+                errno.EFAULT => @unreachable(),
+                errno.EBADF  => error.BadFd,
+                errno.EDQUOT => error.DiskQuota,
+                errno.EFBIG  => error.FileTooBig,
+                errno.EIO    => error.Io,
+                errno.ENOSPC => error.NoSpaceLeft,
+                errno.EPERM  => error.BadPerm,
+                errno.EPIPE  => error.PipeFail,
+                else         => error.Unexpected,
+            }
+        }
+        *written += write_ret;
+        var amt_written = write_ret;
+        while (iov.len > 0 && amt_written >= iov[0].iov_len) {
+            amt_written -= iov[0].iov_len;
+            iov = iov[1...];
+        }
+        if (amt_written > 0) {
+            iov[0].iov_base = &iov[0].iov_base[amt_written];
+            iov[0].iov_len -= amt_written;
+        }
+    }
+}
+
+/// Every call goes straight to the operating system. For many small reads,
+/// wrap it in a BufferedInStream.
 pub const InStream = struct {
     fd: i32,
 
@@ -353,11 +453,22 @@ pub const InStream = struct {
     /// Returns the number of bytes read. If the number read is smaller than buf.len, then
     /// the stream reached End Of File.
     pub fn read(is: &InStream, buf: []u8) -> %usize {
+        var index: usize = 0;
+        while (index < buf.len) {
+            const amt_read = %return is.readSome(buf[index...]);
+            if (amt_read == 0) return index;
+            index += amt_read;
+        }
+        return index;
+    }
+
+    /// Makes a single read call, so the number of bytes read may be smaller than
+    /// buf.len even if the stream has not reached End Of File. Returns 0 at End Of File.
+    pub fn readSome(is: &InStream, buf: []u8) -> %usize {
         switch (@compileVar("os")) {
             Os.linux, Os.darwin => {
-                var index: usize = 0;
-                while (index < buf.len) {
-                    const amt_read = system.read(is.fd, &buf[index], buf.len - index);
+                while (true) {
+                    const amt_read = system.read(is.fd, buf.ptr, buf.len);
                     const read_err = system.getErrno(amt_read);
                     if (read_err > 0) {
                         switch (read_err) {
@@ -370,10 +481,8 @@ pub const InStream = struct {
                             else         => return error.Unexpected,
                         }
                     }
-                    if (amt_read == 0) return index;
-                    index += amt_read;
+                    return amt_read;
                 }
-                return index;
             },
             else => @compileError("unsupported OS"),
         }
@@ -506,6 +615,199 @@ pub const InStream = struct {
     }
 };
 
+pub const BufferedInStream = BufferedInStreamCustom(buffer_size);
+
+/// Reads from an InStream through a buffer of the given size, so that small
+/// reads such as readByte cost a memory access rather than a system call.
+/// Slices returned by peek and readUntilDelimiter point into the buffer and are
+/// only valid until the next call which reads or seeks.
+/// Once a BufferedInStream is in use, do not read or seek the underlying
+/// stream directly.
+pub fn BufferedInStreamCustom(comptime size: usize) -> type {
+    struct {
+        const Self = this;
+
+        unbuffered_in_stream: &InStream,
+        buffer: [size]u8,
+        start_index: usize,
+        end_index: usize,
+        /// The position of the underlying stream, which corresponds to
+        /// buffer[end_index]. Only valid when end_pos_known is true.
+        end_pos: usize,
+        end_pos_known: bool,
+
+        pub fn init(unbuffered_in_stream: &InStream) -> Self {
+            Self {
+                .unbuffered_in_stream = unbuffered_in_stream,
+                .buffer = undefined,
+                .start_index = 0,
+                .end_index = 0,
+                .end_pos = 0,
+                .end_pos_known = false,
+            }
+        }
+
+        /// Moves the unread bytes to the front of the buffer and fills the rest
+        /// of it with a single read call. Returns the number of bytes added,
+        /// which is 0 at End Of File or when the buffer is already full.
+        fn fill(self: &Self) -> %usize {
+            if (self.start_index != 0) {
+                const buffered_len = self.end_index - self.start_index;
+                // The ranges may overlap, so this cannot be mem.copy.
+                for (self.buffer[self.start_index...self.end_index]) |b, i| {
+                    self.buffer[i] = b;
+                }
+                self.start_index = 0;
+                self.end_index = buffered_len;
+            }
+            if (self.end_index == self.buffer.len)
+                return 0;
+            const amt_read = %return self.unbuffered_in_stream.readSome(self.buffer[self.end_index...]);
+            self.end_index += amt_read;
+            self.end_pos += amt_read;
+            return amt_read;
+        }
+
+        fn discardBuffer(self: &Self) {
+            self.start_index = 0;
+            self.end_index = 0;
+        }
+
+        /// Returns the number of bytes read. If the number read is smaller than buf.len, then
+        /// the stream reached End Of File.
+        pub fn read(self: &Self, buf: []u8) -> %usize {
+            var index: usize = 0;
+            while (index < buf.len) {
+                if (self.start_index == self.end_index) {
+                    if (buf.len - index >= self.buffer.len) {
+                        // Large reads go straight to the destination, and
+                        // the buffer no longer ends at end_pos.
+                        const amt_read = %return self.unbuffered_in_stream.read(buf[index...]);
+                        self.end_pos += amt_read;
+                        self.discardBuffer();
+                        return index + amt_read;
+                    }
+                    if ((%return self.fill()) == 0)
+                        return index;
+                }
+                const copy_amt = math.min(self.end_index - self.start_index, buf.len - index);
+                mem.copy(u8, buf[index...index + copy_amt], self.buffer[self.start_index...self.start_index + copy_amt]);
+                self.start_index += copy_amt;
+                index += copy_amt;
+            }
+            return index;
+        }
+
+        pub fn readNoEof(self: &Self, buf: []u8) -> %void {
+            const amt_read = %return self.read(buf);
+            if (amt_read < buf.len) return error.Eof;
+        }
+
+        pub fn readByte(self: &Self) -> %u8 {
+            if (self.start_index == self.end_index) {
+                if ((%return self.fill()) == 0)
+                    return error.Eof;
+            }
+            const result = self.buffer[self.start_index];
+            self.start_index += 1;
+            return result;
+        }
+
+        /// Returns the next n bytes without consuming them.
+        pub fn peek(self: &Self, n: usize) -> %[]u8 {
+            assert(n <= self.buffer.len);
+            while (self.end_index - self.start_index < n) {
+                if ((%return self.fill()) == 0)
+                    return error.Eof;
+            }
+            return self.buffer[self.start_index...self.start_index + n];
+        }
+
+        /// Consumes bytes up to and including delimiter, and returns the bytes
+        /// before the delimiter. Returns error.StreamTooLong if the delimiter is
+        /// not found within a buffer's worth of bytes.
+        pub fn readUntilDelimiter(self: &Self, delimiter: u8) -> %[]u8 {
+            var search_index = self.start_index;
+            while (true) {
+                while (search_index < self.end_index) {
+                    if (self.buffer[search_index] == delimiter) {
+                        const result = self.buffer[self.start_index...search_index];
+                        self.start_index = search_index + 1;
+                        return result;
+                    }
+                    search_index += 1;
+                }
+                if (self.end_index - self.start_index == self.buffer.len)
+                    return error.StreamTooLong;
+                const searched_len = search_index - self.start_index;
+                if ((%return self.fill()) == 0)
+                    return error.Eof;
+                search_index = self.start_index + searched_len;
+            }
+        }
+
+        pub fn readIntLe(self: &Self, comptime T: type) -> %T {
+            self.readInt(false, T)
+        }
+
+        pub fn readIntBe(self: &Self, comptime T: type) -> %T {
+            self.readInt(true, T)
+        }
+
+        pub fn readInt(self: &Self, is_be: bool, comptime T: type) -> %T {
+            const bytes = %return self.peek(@sizeOf(T));
+            const result = mem.readInt(bytes, T, is_be);
+            self.start_index += @sizeOf(T);
+            return result;
+        }
+
+        pub fn readVarInt(self: &Self, is_be: bool, comptime T: type, int_size: usize) -> %T {
+            assert(int_size <= @sizeOf(T));
+            assert(int_size <= 8);
+            const bytes = %return self.peek(int_size);
+            const result = mem.readInt(bytes, T, is_be);
+            self.start_index += int_size;
+            return result;
+        }
+
+        pub fn seekForward(self: &Self, amount: usize) -> %void {
+            const buffered_len = self.end_index - self.start_index;
+            if (amount <= buffered_len) {
+                self.start_index += amount;
+                return;
+            }
+            %return self.unbuffered_in_stream.seekForward(amount - buffered_len);
+            self.end_pos += amount - buffered_len;
+            self.discardBuffer();
+        }
+
+        /// Seeking to a position which is still in the buffer does not make a
+        /// system call.
+        pub fn seekTo(self: &Self, pos: usize) -> %void {
+            if (self.end_pos_known && pos <= self.end_pos && self.end_pos - pos <= self.end_index) {
+                self.start_index = self.end_index - (self.end_pos - pos);
+                return;
+            }
+            %return self.unbuffered_in_stream.seekTo(pos);
+            self.end_pos = pos;
+            self.end_pos_known = true;
+            self.discardBuffer();
+        }
+
+        pub fn getPos(self: &Self) -> %usize {
+            if (!self.end_pos_known) {
+                self.end_pos = %return self.unbuffered_in_stream.getPos();
+                self.end_pos_known = true;
+            }
+            return self.end_pos - (self.end_index - self.start_index);
+        }
+
+        pub fn getEndPos(self: &Self) -> %usize {
+            return self.unbuffered_in_stream.getEndPos();
+        }
+    }
+}
+
 pub fn parseUnsigned(comptime T: type, buf: []const u8, radix: u8) -> %T {
     var x: T = 0;
 
@@ -518,6 +820,8 @@ pub fn parseUnsigned(comptime T: type, buf: []const u8, radix: u8) -> %T {
     return x;
 }
 
+pub const parseFloat = @import("float_parse.zig").parseFloat;
+
 error InvalidChar;
 fn charToDigit(c: u8, radix: u8) -> %u8 {
     const value = switch (c) {
@@ -541,6 +845,8 @@ fn digitToChar(digit: u8, uppercase: bool) -> u8 {
     };
 }
 
+pub const bufPrintFloat = float_print.bufPrintFloat;
+
 /// Guaranteed to not use more than max_int_digits
 pub fn bufPrintInt(out_buf: []u8, x: var, base: u8, uppercase: bool, width: usize) -> usize {
     if (@typeOf(x).is_signed)
@@ -567,6 +873,10 @@ fn bufPrintSigned(out_buf: []u8, x: var, base: u8, uppercase: bool, width: usize
 }
 
 fn bufPrintUnsigned(out_buf: []u8, x: var, base: u8, uppercase: bool, width: usize) -> usize {
+    if (@typeOf(x).bit_count <= 64) {
+        if (base == 10) return bufPrintDecimal(out_buf, u64(x), width);
+    }
+
     // max_int_digits accounts for the minus sign. when printing an unsigned
     // number we don't need to do that.
     var buf: [max_int_digits - 1]u8 = undefined;
@@ -590,6 +900,131 @@ fn bufPrintUnsigned(out_buf: []u8, x: var, base: u8, uppercase: bool, width: usi
     return src_buf.len + padding;
 }
 
+// The decimal digits are written straight to their place in out_buf, two at
+// a time from the end, once decimalLength has told where that is.
+fn bufPrintDecimal(out_buf: []u8, x: u64, width: usize) -> usize {
+    const len = decimalLength(x);
+    const padding = if (width > len) (width - len) else 0;
+    mem.set(u8, out_buf[0...padding], '0');
+
+    var a = x;
+    var index = padding + len;
+    while (a >= 100) {
+        const pair = usize(a % 100) * 2;
+        a /= 100;
+        index -= 2;
+        out_buf[index] = digit_pairs[pair];
+        out_buf[index + 1] = digit_pairs[pair + 1];
+    }
+    if (a >= 10) {
+        const pair = usize(a) * 2;
+        out_buf[index - 2] = digit_pairs[pair];
+        out_buf[index - 1] = digit_pairs[pair + 1];
+    } else {
+        out_buf[index - 1] = '0' + u8(a);
+    }
+    return padding + len;
+}
+
+const digit_pairs = "00010203040506070809101112131415161718192021222324252627282930313233343536373839404142434445464748495051525354555657585960616263646566676869707172737475767778798081828384858687888990919293949596979899";
+
+const powers_of_ten = []u64 {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000,
+    1000000000, 10000000000, 100000000000, 1000000000000, 10000000000000,
+    100000000000000, 1000000000000000, 10000000000000000,
+    100000000000000000, 1000000000000000000, 10000000000000000000,
+};
+
+/// The number of decimal digits of x.
+pub fn decimalLength(x: u64) -> usize {
+    if (x == 0) return 1;
+    // floor(log10(2^bits)) is at most one less than the digit count
+    const bits = 64 - @clz(x);
+    const guess = usize((bits * 1233) >> 12);
+    return if (x < powers_of_ten[guess]) guess else guess + 1;
+}
+
+/// Copies the rest of in_stream to out_stream and returns the number of bytes
+/// copied. On Linux the kernel moves the data without copying it to user space
+/// when the kind of files allows it: copy_file_range between regular files,
+/// sendfile from a regular file, and splice to or from a pipe. Otherwise the
+/// buffer of out_stream is used.
+pub fn copyStream(in_stream: &InStream, out_stream: &OutStream) -> %usize {
+    %return out_stream.flush();
+    var total: usize = 0;
+    switch (@compileVar("os")) {
+        Os.linux => {
+            if (%return kernelCopy(in_stream.fd, out_stream.fd, &total)) return total;
+        },
+        else => {},
+    }
+    while (true) {
+        const amt_read = %return in_stream.readSome(out_stream.buffer[0...]);
+        if (amt_read == 0) return total;
+        out_stream.index = amt_read;
+        %return out_stream.flush();
+        total += amt_read;
+    }
+}
+
+const KernelCopy = enum {
+    CopyFileRange,
+    SendFile,
+    Splice,
+};
+
+/// Max bytes moved per system call, which keeps the counts in range on 32 bit targets.
+const kernel_copy_chunk = 0x40000000;
+
+/// Returns false if none of the system calls can copy between these files.
+/// total counts the bytes copied so far, so the caller can finish the copy.
+fn kernelCopy(in_fd: i32, out_fd: i32, total: &usize) -> %bool {
+    var method = KernelCopy.CopyFileRange;
+    var copied_any = false;
+    while (true) {
+        const copy_ret = switch (method) {
+            KernelCopy.CopyFileRange => system.copy_file_range(in_fd, null, out_fd, null, kernel_copy_chunk, 0),
+            KernelCopy.SendFile => system.sendfile(out_fd, in_fd, null, kernel_copy_chunk),
+            KernelCopy.Splice => system.splice(in_fd, null, out_fd, null, kernel_copy_chunk, 0),
+        };
+        const copy_err = system.getErrno(copy_ret);
+        if (copy_err > 0) {
+            switch (copy_err) {
+                errno.EINTR => continue,
+                // this method does not support these files, try the next
+                errno.EINVAL, errno.ENOSYS, errno.EXDEV, errno.EOPNOTSUPP, errno.ESPIPE => {
+                    method = switch (method) {
+                        KernelCopy.CopyFileRange => KernelCopy.SendFile,
+                        KernelCopy.SendFile => KernelCopy.Splice,
+                        KernelCopy.Splice => return false,
+                    };
+                    continue;
+                },
+                errno.EBADF  => return error.BadFd,
+                errno.EFBIG  => return error.FileTooBig,
+                errno.EIO    => return error.Io,
+                errno.EISDIR => return error.IsDir,
+                errno.ENOMEM => return error.NoMem,
+                errno.ENOSPC => return error.NoSpaceLeft,
+                errno.EPIPE  => return error.PipeFail,
+                else         => return error.Unexpected,
+            }
+        }
+        if (copy_ret == 0) {
+            // Between Linux 5.3 and 5.18 copy_file_range returns 0 for files
+            // such as those in /proc which have data but no size, so only
+            // another method can tell that the file is empty.
+            if (method == KernelCopy.CopyFileRange && !copied_any) {
+                method = KernelCopy.SendFile;
+                continue;
+            }
+            return true;
+        }
+        copied_any = true;
+        *total += copy_ret;
+    }
+}
+
 pub fn openSelfExe(stream: &InStream) -> %void {
     switch (@compileVar("os")) {
         Os.linux => {
@@ -644,3 +1079,127 @@ fn testBufPrintInt() {
     assert(mem.eql(u8, bufPrintIntToSlice(buf, i32(42), 10, false, 3), "+42"));
     assert(mem.eql(u8, bufPrintIntToSlice(buf, i32(-42), 10, false, 3), "-42"));
 }
+
+fn testBufPrintDecimal() {
+    @setFnTest(this);
+
+    var buffer: [max_int_digits]u8 = undefined;
+    const buf = buffer[0...];
+    assert(mem.eql(u8, bufPrintIntToSlice(buf, u32(0), 10, false, 0), "0"));
+    assert(mem.eql(u8, bufPrintIntToSlice(buf, u32(7), 10, false, 0), "7"));
+    assert(mem.eql(u8, bufPrintIntToSlice(buf, u32(10), 10, false, 0), "10"));
+    assert(mem.eql(u8, bufPrintIntToSlice(buf, u32(99), 10, false, 0), "99"));
+    assert(mem.eql(u8, bufPrintIntToSlice(buf, u32(100), 10, false, 0), "100"));
+    assert(mem.eql(u8, bufPrintIntToSlice(buf, u8(255), 10, false, 0), "255"));
+    assert(mem.eql(u8, bufPrintIntToSlice(buf, u64(999999999), 10, false, 0), "999999999"));
+    assert(mem.eql(u8, bufPrintIntToSlice(buf, u64(1000000000), 10, false, 0), "1000000000"));
+    assert(mem.eql(u8, bufPrintIntToSlice(buf, @maxValue(u64), 10, false, 0), "18446744073709551615"));
+    assert(mem.eql(u8, bufPrintIntToSlice(buf, @minValue(i64), 10, false, 0), "-9223372036854775808"));
+    assert(mem.eql(u8, bufPrintIntToSlice(buf, u32(42), 10, false, 5), "00042"));
+
+    assert(decimalLength(9) == 1);
+    assert(decimalLength(10) == 2);
+    assert(decimalLength(9999999999999999999) == 19);
+    assert(decimalLength(10000000000000000000) == 20);
+}
+
+fn testPrintIntWide() {
+    @setFnTest(this);
+
+    if (@compileVar("os") != Os.linux) return;
+
+    const dev_null = system.open("/dev/null", system.O_WRONLY, 0);
+    assert(system.getErrno(dev_null) == 0);
+    var out = OutStream {
+        .fd = i32(dev_null),
+        .buffer = undefined,
+        .index = 0,
+    };
+    defer out.close();
+
+    // 4999 zeros and a digit, of which the buffer was flushed once
+    %%out.printInt(u32(7), 10, false, 5000);
+    assert(out.index == 5000 - buffer_size);
+    assert(out.buffer[out.index - 2] == '0' && out.buffer[out.index - 1] == '7');
+
+    %%out.flush();
+    %%out.printInt(i32(-5), 10, false, 5000);
+    assert(out.index == 5000 - buffer_size);
+    assert(out.buffer[out.index - 2] == '0' && out.buffer[out.index - 1] == '5');
+}
+
+fn testBufferedInStream() {
+    @setFnTest(this);
+
+    if (@compileVar("os") != Os.linux) return;
+
+    var self_exe: InStream = undefined;
+    %%openSelfExe(&self_exe);
+    defer self_exe.close() %% {};
+
+    var buffered = BufferedInStreamCustom(16).init(&self_exe);
+    assert(mem.eql(u8, %%buffered.peek(4), "\x7fELF"));
+    assert(%%buffered.getPos() == 0);
+    assert(%%buffered.readByte() == 0x7f);
+    assert(%%buffered.getPos() == 1);
+    assert(mem.eql(u8, %%buffered.peek(3), "ELF"));
+
+    %%buffered.seekTo(2);
+    assert(%%buffered.readByte() == 'L');
+    %%buffered.seekTo(1);
+    assert(%%buffered.readByte() == 'E');
+
+    var bytes: [40]u8 = undefined;
+    %%buffered.seekTo(0);
+    %%buffered.readNoEof(bytes[0...]);
+    assert(mem.eql(u8, bytes[0...4], "\x7fELF"));
+    assert(%%buffered.getPos() == bytes.len);
+
+    // partly from the buffer and then around it
+    %%buffered.seekTo(0);
+    assert(%%buffered.readByte() == 0x7f);
+    %%buffered.readNoEof(bytes[1...]);
+    %%buffered.seekTo(30);
+    assert(%%buffered.readByte() == bytes[30]);
+
+    %%buffered.seekTo(100);
+    assert(%%buffered.getPos() == 100);
+    %%buffered.seekForward(20);
+    assert(%%buffered.getPos() == 120);
+}
+
+fn testCopyStream() {
+    @setFnTest(this);
+
+    if (@compileVar("os") != Os.linux) return;
+
+    var self_exe: InStream = undefined;
+    %%openSelfExe(&self_exe);
+    defer self_exe.close() %% {};
+
+    const dev_null = system.open("/dev/null", system.O_WRONLY, 0);
+    assert(system.getErrno(dev_null) == 0);
+    var out = OutStream {
+        .fd = i32(dev_null),
+        .buffer = undefined,
+        .index = 0,
+    };
+    defer out.close();
+
+    // partly buffered, then a write larger than the buffer goes out with it
+    var big: [buffer_size * 3]u8 = undefined;
+    mem.set(u8, big[0...], 'a');
+    %%out.write("header");
+    %%out.write(big[0...]);
+    assert(out.index == 0);
+    %%out.write(big[0...buffer_size - 1]);
+    assert(out.index == buffer_size - 1);
+
+    assert(%%copyStream(&self_exe, &out) == %%self_exe.getEndPos());
+
+    // a file with data but a size of 0
+    var proc_file: InStream = undefined;
+    %%proc_file.open("/proc/self/stat");
+    defer proc_file.close() %% {};
+    assert(%%copyStream(&proc_file, &out) > 0);
+}
@@ -0,0 +1,352 @@
+const linux = @import("linux.zig");
+const errno = @import("errno.zig");
+const debug = @import("debug.zig");
+const assert = debug.assert;
+const mem = @import("mem.zig");
+
+error Unexpected;
+error NoMem;
+error BadFd;
+error ProcessFdQuotaExceeded;
+error SystemFdQuotaExceeded;
+error SystemOutdated;
+error PermissionDenied;
+error SubmissionQueueFull;
+error CompletionQueueOvercommitted;
+
+/// Offset meaning the current file position, for read and write.
+pub const current_position = @maxValue(u64);
+
+/// An io_uring instance: operations are queued in a submission ring shared
+/// with the kernel and submitted together with a single system call, and
+/// their results are read from a completion ring without any system call.
+/// Each queue function returns the entry so that flags such as
+/// linux.IOSQE_IO_LINK can be set on it. Entries are tagged with user_data,
+/// which comes back in the completion.
+/// Use `init` to initialize this state.
+pub const IoUring = struct {
+    fd: i32,
+    features: u32,
+
+    // mapped rings
+    sq_ring: []u8,
+    cq_ring: []u8,
+    sqes: []linux.io_uring_sqe,
+
+    sq_head: &u32,
+    sq_tail: &u32,
+    sq_mask: u32,
+    // entries handed out by getSqe, some of which the kernel has not seen yet
+    sqe_tail: u32,
+
+    cq_head: &u32,
+    cq_tail: &u32,
+    cq_mask: u32,
+    cqes: []linux.io_uring_cqe,
+
+    /// entries is rounded up to a power of two by the kernel. Call deinit to clean up.
+    pub fn init(ring: &IoUring, entries: u32, flags: u32) -> %void {
+        var params: linux.io_uring_params = undefined;
+        @memset((&u8)(&params), 0, @sizeOf(linux.io_uring_params));
+        params.flags = flags;
+
+        const setup_ret = linux.io_uring_setup(entries, &params);
+        const setup_err = linux.getErrno(setup_ret);
+        if (setup_err > 0) {
+            return switch (setup_err) {
+                errno.ENOSYS => error.SystemOutdated,
+                errno.EMFILE => error.ProcessFdQuotaExceeded,
+                errno.ENFILE => error.SystemFdQuotaExceeded,
+                errno.ENOMEM => error.NoMem,
+                errno.EPERM => error.PermissionDenied,
+                errno.EFAULT, errno.EINVAL => @unreachable(),
+                else => error.Unexpected,
+            }
+        }
+        ring.fd = i32(setup_ret);
+        %defer {
+            _ = linux.close(ring.fd);
+        }
+        ring.features = params.features;
+
+        const sq_size = params.sq_off.array + params.sq_entries * @sizeOf(u32);
+        const cq_size = params.cq_off.cqes + params.cq_entries * @sizeOf(linux.io_uring_cqe);
+        if (params.features & linux.IORING_FEAT_SINGLE_MMAP != 0) {
+            // both rings live in one mapping
+            const size = if (sq_size > cq_size) sq_size else cq_size;
+            ring.sq_ring = %return mapRing(ring.fd, size, linux.IORING_OFF_SQ_RING);
+            ring.cq_ring = ring.sq_ring;
+        } else {
+            ring.sq_ring = %return mapRing(ring.fd, sq_size, linux.IORING_OFF_SQ_RING);
+            %defer unmap(ring.sq_ring);
+            ring.cq_ring = %return mapRing(ring.fd, cq_size, linux.IORING_OFF_CQ_RING);
+        }
+        %defer ring.unmapRings();
+        const sqes = %return mapRing(ring.fd, params.sq_entries * @sizeOf(linux.io_uring_sqe),
+            linux.IORING_OFF_SQES);
+        ring.sqes = ([]linux.io_uring_sqe)(sqes);
+
+        ring.sq_head = (&u32)(&ring.sq_ring[params.sq_off.head]);
+        ring.sq_tail = (&u32)(&ring.sq_ring[params.sq_off.tail]);
+        ring.sq_mask = *(&const u32)(&ring.sq_ring[params.sq_off.ring_mask]);
+        ring.sqe_tail = *ring.sq_tail;
+
+        // Slot i of the index array always names sqe i, so entries are used in order.
+        const array = (&u32)(&ring.sq_ring[params.sq_off.array])[0...params.sq_entries];
+        for (array) |*index, i| {
+            *index = u32(i);
+        }
+
+        ring.cq_head = (&u32)(&ring.cq_ring[params.cq_off.head]);
+        ring.cq_tail = (&u32)(&ring.cq_ring[params.cq_off.tail]);
+        ring.cq_mask = *(&const u32)(&ring.cq_ring[params.cq_off.ring_mask]);
+        ring.cqes = (&linux.io_uring_cqe)(&ring.cq_ring[params.cq_off.cqes])[0...params.cq_entries];
+    }
+
+    pub fn deinit(ring: &IoUring) {
+        unmap(([]u8)(ring.sqes));
+        ring.unmapRings();
+        _ = linux.close(ring.fd);
+    }
+
+    /// Returns a cleared submission queue entry, which is sent to the kernel
+    /// by the next submit.
+    pub fn getSqe(ring: &IoUring) -> %&linux.io_uring_sqe {
+        const head = *ring.sq_head;
+        @fence(AtomicOrder.Acquire);
+        if (ring.sqe_tail -% head >= ring.sqes.len) return error.SubmissionQueueFull;
+        const sqe = &ring.sqes[ring.sqe_tail & ring.sq_mask];
+        ring.sqe_tail +%= 1;
+        @memset((&u8)(sqe), 0, @sizeOf(linux.io_uring_sqe));
+        return sqe;
+    }
+
+    /// Submits the queued entries and returns how many the kernel took.
+    pub fn submit(ring: &IoUring) -> %u32 {
+        return ring.submitAndWait(0);
+    }
+
+    /// Submits the queued entries and waits until at least wait_nr
+    /// completions are ready, all in one system call.
+    pub fn submitAndWait(ring: &IoUring, wait_nr: u32) -> %u32 {
+        const to_submit = ring.flushSq();
+        if (to_submit == 0 && wait_nr == 0) return 0;
+        const flags = if (wait_nr > 0) u32(linux.IORING_ENTER_GETEVENTS) else 0;
+        return ring.enter(to_submit, wait_nr, flags);
+    }
+
+    /// Copies up to cqes.len completions into cqes and returns how many.
+    /// If none are ready, first waits for at least wait_nr of them.
+    pub fn copyCqes(ring: &IoUring, cqes: []linux.io_uring_cqe, wait_nr: u32) -> %u32 {
+        const count = ring.copyReadyCqes(cqes);
+        if (count > 0 || wait_nr == 0) return count;
+        _ = %return ring.enter(0, wait_nr, linux.IORING_ENTER_GETEVENTS);
+        return ring.copyReadyCqes(cqes);
+    }
+
+    /// Waits for one completion and returns it.
+    pub fn copyCqe(ring: &IoUring) -> %linux.io_uring_cqe {
+        var cqes: [1]linux.io_uring_cqe = undefined;
+        while (true) {
+            const count = %return ring.copyCqes(cqes[0...], 1);
+            if (count == 1) return cqes[0];
+        }
+    }
+
+    /// How many completions are ready to be copied.
+    pub fn cqReady(ring: &IoUring) -> u32 {
+        const tail = *ring.cq_tail;
+        @fence(AtomicOrder.Acquire);
+        return tail -% *ring.cq_head;
+    }
+
+    pub fn nop(ring: &IoUring, user_data: u64) -> %&linux.io_uring_sqe {
+        const sqe = %return ring.getSqe();
+        sqe.opcode = linux.IORING_OP_NOP;
+        sqe.user_data = user_data;
+        return sqe;
+    }
+
+    /// Reads into buf from offset, or from the file position if offset is current_position.
+    /// Needs Linux 5.6; earlier kernels complete it with -EINVAL, and readv works there.
+    pub fn read(ring: &IoUring, user_data: u64, fd: i32, buf: []u8, offset: u64) -> %&linux.io_uring_sqe {
+        return ring.queueRw(linux.IORING_OP_READ, user_data, fd, usize(buf.ptr), buf.len, offset);
+    }
+
+    pub fn write(ring: &IoUring, user_data: u64, fd: i32, buf: []const u8, offset: u64) -> %&linux.io_uring_sqe {
+        return ring.queueRw(linux.IORING_OP_WRITE, user_data, fd, usize(buf.ptr), buf.len, offset);
+    }
+
+    /// The iovecs must stay valid until the entry is submitted.
+    pub fn readv(ring: &IoUring, user_data: u64, fd: i32, iovecs: []const linux.iovec,
+        offset: u64) -> %&linux.io_uring_sqe
+    {
+        return ring.queueRw(linux.IORING_OP_READV, user_data, fd, usize(iovecs.ptr), iovecs.len, offset);
+    }
+
+    /// The iovecs must stay valid until the entry is submitted.
+    pub fn writev(ring: &IoUring, user_data: u64, fd: i32, iovecs: []const linux.iovec_const,
+        offset: u64) -> %&linux.io_uring_sqe
+    {
+        return ring.queueRw(linux.IORING_OP_WRITEV, user_data, fd, usize(iovecs.ptr), iovecs.len, offset);
+    }
+
+    /// The result of the completion is the accepted file descriptor.
+    pub fn accept(ring: &IoUring, user_data: u64, fd: i32, addr: ?&linux.sockaddr,
+        addrlen: ?&linux.socklen_t, flags: u32) -> %&linux.io_uring_sqe
+    {
+        const sqe = %return ring.queueRw(linux.IORING_OP_ACCEPT, user_data, fd, usize(addr), 0, u64(usize(addrlen)));
+        sqe.op_flags = flags;
+        return sqe;
+    }
+
+    pub fn recv(ring: &IoUring, user_data: u64, fd: i32, buf: []u8, flags: u32) -> %&linux.io_uring_sqe {
+        const sqe = %return ring.queueRw(linux.IORING_OP_RECV, user_data, fd, usize(buf.ptr), buf.len, 0);
+        sqe.op_flags = flags;
+        return sqe;
+    }
+
+    pub fn send(ring: &IoUring, user_data: u64, fd: i32, buf: []const u8, flags: u32) -> %&linux.io_uring_sqe {
+        const sqe = %return ring.queueRw(linux.IORING_OP_SEND, user_data, fd, usize(buf.ptr), buf.len, 0);
+        sqe.op_flags = flags;
+        return sqe;
+    }
+
+    fn queueRw(ring: &IoUring, opcode: u8, user_data: u64, fd: i32, addr: usize, len: usize,
+        offset: u64) -> %&linux.io_uring_sqe
+    {
+        const sqe = %return ring.getSqe();
+        sqe.opcode = opcode;
+        sqe.fd = fd;
+        sqe.off = offset;
+        sqe.addr = u64(addr);
+        sqe.len = u32(len);
+        sqe.user_data = user_data;
+        return sqe;
+    }
+
+    /// Publishes the entries from getSqe to the kernel and returns how many
+    /// it has not consumed yet.
+    fn flushSq(ring: &IoUring) -> u32 {
+        if (*ring.sq_tail != ring.sqe_tail) {
+            // the entries must be visible before the tail which exposes them
+            @fence(AtomicOrder.Release);
+            *ring.sq_tail = ring.sqe_tail;
+        }
+        const head = *ring.sq_head;
+        @fence(AtomicOrder.Acquire);
+        return ring.sqe_tail -% head;
+    }
+
+    fn copyReadyCqes(ring: &IoUring, cqes: []linux.io_uring_cqe) -> u32 {
+        const head = *ring.cq_head;
+        const ready = ring.cqReady();
+        const count = if (ready < cqes.len) ready else u32(cqes.len);
+        {var i: u32 = 0; while (i < count; i += 1) {
+            cqes[i] = ring.cqes[(head +% i) & ring.cq_mask];
+        }}
+        // the entries must be read before the kernel may reuse them
+        @fence(AtomicOrder.Release);
+        *ring.cq_head = head +% count;
+        return count;
+    }
+
+    fn enter(ring: &IoUring, to_submit: u32, min_complete: u32, flags: u32) -> %u32 {
+        while (true) {
+            const enter_ret = linux.io_uring_enter(ring.fd, to_submit, min_complete, flags);
+            const enter_err = linux.getErrno(enter_ret);
+            if (enter_err > 0) {
+                return switch (enter_err) {
+                    errno.EINTR => continue,
+                    errno.EAGAIN => error.NoMem,
+                    errno.EBUSY => error.CompletionQueueOvercommitted,
+                    errno.EBADF => error.BadFd,
+                    errno.EFAULT, errno.EINVAL => @unreachable(),
+                    else => error.Unexpected,
+                }
+            }
+            return u32(enter_ret);
+        }
+    }
+
+    fn unmapRings(ring: &IoUring) {
+        unmap(ring.sq_ring);
+        if (ring.cq_ring.ptr != ring.sq_ring.ptr) {
+            unmap(ring.cq_ring);
+        }
+    }
+};
+
+fn mapRing(fd: i32, size: usize, offset: usize) -> %[]u8 {
+    const addr = linux.mmap(null, size, linux.MMAP_PROT_READ | linux.MMAP_PROT_WRITE,
+        linux.MMAP_MAP_SHARED | linux.MMAP_MAP_POPULATE, fd, offset);
+    if (linux.getErrno(addr) > 0) return error.NoMem;
+    return (&u8)(addr)[0...size];
+}
+
+fn unmap(bytes: []u8) {
+    _ = linux.munmap(bytes.ptr, bytes.len);
+}
+
+fn testNop() {
+    @setFnTest(this);
+
+    var ring: IoUring = undefined;
+    ring.init(4, 0) %% |err| {
+        // kernels before 5.1 have no io_uring
+        if (err == error.SystemOutdated || err == error.PermissionDenied) return;
+        @unreachable();
+    };
+    defer ring.deinit();
+
+    _ = %%ring.nop(0xaa);
+    const sqe = %%ring.nop(0xbb);
+    sqe.flags |= linux.IOSQE_IO_LINK;
+    _ = %%ring.nop(0xcc);
+    assert(%%ring.submitAndWait(3) == 3);
+
+    var cqes: [4]linux.io_uring_cqe = undefined;
+    assert(%%ring.copyCqes(cqes[0...], 0) == 3);
+    assert(cqes[0].user_data == 0xaa && cqes[0].res == 0);
+    assert(cqes[1].user_data == 0xbb);
+    assert(cqes[2].user_data == 0xcc);
+    assert(ring.cqReady() == 0);
+}
+
+fn testRead() {
+    @setFnTest(this);
+
+    var ring: IoUring = undefined;
+    ring.init(4, 0) %% |err| {
+        if (err == error.SystemOutdated || err == error.PermissionDenied) return;
+        @unreachable();
+    };
+    defer ring.deinit();
+
+    const fd_ret = linux.open("/proc/self/exe", linux.O_RDONLY | linux.O_CLOEXEC, 0);
+    assert(linux.getErrno(fd_ret) == 0);
+    const fd = i32(fd_ret);
+    defer {
+        _ = linux.close(fd);
+    }
+
+    var magic: [4]u8 = undefined;
+    var class: [1]u8 = undefined;
+    _ = %%ring.read(1, fd, magic[0...], 0);
+    _ = %%ring.read(2, fd, class[0...], 4);
+    _ = %%ring.submit();
+
+    var seen: u32 = 0;
+    while (seen < 2; seen += 1) {
+        const cqe = %%ring.copyCqe();
+        // the kernel is older than IORING_OP_READ
+        if (cqe.res == -errno.EINVAL) return;
+        if (cqe.user_data == 1) {
+            assert(cqe.res == 4);
+        } else {
+            assert(cqe.user_data == 2 && cqe.res == 1);
+        }
+    }
+    assert(mem.eql(u8, magic[0...], "\x7fELF"));
+    assert(class[0] == 1 || class[0] == 2);
+}
@@ -15,6 +15,15 @@ pub const MMAP_MAP_SHARED =  1;
 pub const MMAP_MAP_PRIVATE = 2;
 pub const MMAP_MAP_FIXED =   16;
 pub const MMAP_MAP_ANON =    32;
+pub const MMAP_MAP_POPULATE = 0x8000;
+
+pub const MREMAP_MAYMOVE = 1;
+pub const MREMAP_FIXED =   2;
+
+pub const SPLICE_F_MOVE =     1;
+pub const SPLICE_F_NONBLOCK = 2;
+pub const SPLICE_F_MORE =     4;
+pub const SPLICE_F_GIFT =     8;
 
 pub const SIGHUP    = 1;
 pub const SIGINT    = 2;
@@ -94,6 +103,63 @@ pub const SOCK_PACKET = 10;
 pub const SOCK_CLOEXEC = 0o2000000;
 pub const SOCK_NONBLOCK = 0o4000;
 
+pub const SOL_SOCKET = 1;
+
+pub const SO_REUSEADDR = 2;
+pub const SO_KEEPALIVE = 9;
+pub const SO_REUSEPORT = 15;
+
+pub const MSG_DONTWAIT = 0x0040;
+pub const MSG_NOSIGNAL = 0x4000;
+
+pub const SHUT_RD = 0;
+pub const SHUT_WR = 1;
+pub const SHUT_RDWR = 2;
+
+pub const EPOLL_CLOEXEC = O_CLOEXEC;
+
+pub const EPOLL_CTL_ADD = 1;
+pub const EPOLL_CTL_DEL = 2;
+pub const EPOLL_CTL_MOD = 3;
+
+pub const EPOLLIN =        0x001;
+pub const EPOLLPRI =       0x002;
+pub const EPOLLOUT =       0x004;
+pub const EPOLLERR =       0x008;
+pub const EPOLLHUP =       0x010;
+pub const EPOLLRDHUP =     0x2000;
+pub const EPOLLEXCLUSIVE = 1 << 28;
+pub const EPOLLONESHOT =   1 << 30;
+pub const EPOLLET =        1 << 31;
+
+pub const CLOCK_REALTIME = 0;
+pub const CLOCK_MONOTONIC = 1;
+
+pub const TFD_NONBLOCK = O_NONBLOCK;
+pub const TFD_CLOEXEC = O_CLOEXEC;
+pub const TFD_TIMER_ABSTIME = 1;
+
+pub const CLONE_VM =             0x00000100;
+pub const CLONE_FS =             0x00000200;
+pub const CLONE_FILES =          0x00000400;
+pub const CLONE_SIGHAND =        0x00000800;
+pub const CLONE_PTRACE =         0x00002000;
+pub const CLONE_VFORK =          0x00004000;
+pub const CLONE_PARENT =         0x00008000;
+pub const CLONE_THREAD =         0x00010000;
+pub const CLONE_NEWNS =          0x00020000;
+pub const CLONE_SYSVSEM =        0x00040000;
+pub const CLONE_SETTLS =         0x00080000;
+pub const CLONE_PARENT_SETTID =  0x00100000;
+pub const CLONE_CHILD_CLEARTID = 0x00200000;
+pub const CLONE_DETACHED =       0x00400000;
+pub const CLONE_UNTRACED =       0x00800000;
+pub const CLONE_CHILD_SETTID =   0x01000000;
+
+pub const FUTEX_WAIT = 0;
+pub const FUTEX_WAKE = 1;
+pub const FUTEX_PRIVATE_FLAG = 128;
+
 
 pub const PROTO_ip = 0o000;
 pub const PROTO_icmp = 0o001;
@@ -240,6 +306,12 @@ pub fn munmap(address: &u8, length: usize) -> usize {
     arch.syscall2(arch.SYS_munmap, usize(address), length)
 }
 
+pub fn mremap(old_address: &u8, old_length: usize, new_length: usize, flags: usize, new_address: ?&u8)
+    -> usize
+{
+    arch.syscall5(arch.SYS_mremap, usize(old_address), old_length, new_length, flags, usize(new_address))
+}
+
 pub fn read(fd: i32, buf: &u8, count: usize) -> usize {
     arch.syscall3(arch.SYS_read, usize(fd), usize(buf), count)
 }
@@ -256,6 +328,27 @@ pub fn pwrite(fd: i32, buf: &const u8, count: usize, offset: usize) -> usize {
     arch.syscall4(arch.SYS_pwrite, usize(fd), usize(buf), count, offset)
 }
 
+pub fn writev(fd: i32, iov: &const iovec_const, count: usize) -> usize {
+    arch.syscall3(arch.SYS_writev, usize(fd), usize(iov), count)
+}
+
+/// Copies count bytes from in_fd, which must support mmap, to out_fd. Reads
+/// at and advances the file position of in_fd unless offset is given.
+pub fn sendfile(out_fd: i32, in_fd: i32, offset: ?&isize, count: usize) -> usize {
+    arch.syscall4(arch.SYS_sendfile, usize(out_fd), usize(in_fd), usize(offset), count)
+}
+
+/// Moves up to len bytes between two file descriptors, one of which must be a pipe.
+pub fn splice(fd_in: i32, off_in: ?&i64, fd_out: i32, off_out: ?&i64, len: usize, flags: u32) -> usize {
+    arch.syscall6(arch.SYS_splice, usize(fd_in), usize(off_in), usize(fd_out), usize(off_out), len, flags)
+}
+
+/// Copies up to len bytes between two regular files, possibly without reading
+/// the data at all on file systems which can share extents.
+pub fn copy_file_range(fd_in: i32, off_in: ?&i64, fd_out: i32, off_out: ?&i64, len: usize, flags: u32) -> usize {
+    arch.syscall6(arch.SYS_copy_file_range, usize(fd_in), usize(off_in), usize(fd_out), usize(off_out), len, flags)
+}
+
 pub fn open_c(path: &const u8, flags: usize, perm: usize) -> usize {
     arch.syscall3(arch.SYS_open, usize(path), flags, perm)
 }
@@ -302,6 +395,60 @@ pub fn exit(status: i32) -> unreachable {
     @unreachable()
 }
 
+/// Ends the whole process, unlike exit, which only ends the calling thread.
+pub fn exit_group(status: i32) -> unreachable {
+    _ = arch.syscall1(arch.SYS_exit_group, usize(status));
+    @unreachable()
+}
+
+/// Starts a thread or process running func(arg) on stack, which is the
+/// highest address of the stack memory. See the arch files for details.
+pub const clone = arch.clone;
+
+// thread local storage, x86_64 only
+pub const ARCH_SET_FS = arch.ARCH_SET_FS;
+pub const arch_prctl = arch.arch_prctl;
+
+// thread local storage, i386 only
+pub const user_desc = arch.user_desc;
+pub const USER_DESC_SEG_32BIT = arch.USER_DESC_SEG_32BIT;
+pub const USER_DESC_LIMIT_IN_PAGES = arch.USER_DESC_LIMIT_IN_PAGES;
+pub const USER_DESC_USEABLE = arch.USER_DESC_USEABLE;
+pub const set_thread_area = arch.set_thread_area;
+
+pub fn mprotect(address: &u8, length: usize, prot: usize) -> usize {
+    arch.syscall3(arch.SYS_mprotect, usize(address), length, prot)
+}
+
+pub fn futex(uaddr: &const i32, futex_op: u32, val: i32, timeout: ?&const timespec) -> usize {
+    const val_bits = *(&const u32)(&val);
+    arch.syscall4(arch.SYS_futex, usize(uaddr), usize(futex_op), usize(val_bits), usize(timeout))
+}
+
+/// Sleeps while *uaddr is val, until futex_wake is called on uaddr. Only
+/// for addresses which are not shared with other processes.
+pub fn futex_wait(uaddr: &const i32, val: i32, timeout: ?&const timespec) -> usize {
+    futex(uaddr, FUTEX_WAIT | FUTEX_PRIVATE_FLAG, val, timeout)
+}
+
+/// Wakes up to count threads sleeping in futex_wait on uaddr.
+pub fn futex_wake(uaddr: &const i32, count: i32) -> usize {
+    futex(uaddr, FUTEX_WAKE | FUTEX_PRIVATE_FLAG, count, null)
+}
+
+pub fn sched_yield() -> usize {
+    arch.syscall0(arch.SYS_sched_yield)
+}
+
+/// Returns the number of bytes of mask which the kernel filled in.
+pub fn sched_getaffinity(pid: i32, mask: []u8) -> usize {
+    arch.syscall3(arch.SYS_sched_getaffinity, usize(pid), mask.len, usize(mask.ptr))
+}
+
+pub fn gettid() -> i32 {
+    i32(arch.syscall0(arch.SYS_gettid))
+}
+
 pub fn getrandom(buf: &u8, count: usize, flags: u32) -> usize {
     arch.syscall3(arch.SYS_getrandom, usize(buf), count, usize(flags))
 }
@@ -368,6 +515,11 @@ pub const iovec = extern struct {
     iov_len: usize,
 };
 
+pub const iovec_const = extern struct {
+    iov_base: &const u8,
+    iov_len: usize,
+};
+
 //
 //const IF_NAMESIZE = 16;
 //
@@ -452,7 +604,7 @@ pub fn accept(fd: i32, noalias addr: &sockaddr, noalias len: &socklen_t) -> usiz
     accept4(fd, addr, len, 0)
 }
 
-pub fn accept4(fd: i32, noalias addr: &sockaddr, noalias len: &socklen_t, flags: u32) -> usize {
+pub fn accept4(fd: i32, noalias addr: ?&sockaddr, noalias len: ?&socklen_t, flags: u32) -> usize {
     arch.syscall4(arch.SYS_accept4, usize(fd), usize(addr), usize(len), flags)
 }
 
@@ -490,3 +642,166 @@ pub const timespec = arch.timespec;
 pub fn fstat(fd: i32, stat_buf: &stat) -> usize {
     arch.syscall2(arch.SYS_fstat, usize(fd), usize(stat_buf))
 }
+
+pub fn clock_gettime(clk_id: i32, tp: &timespec) -> usize {
+    arch.syscall2(arch.SYS_clock_gettime, usize(clk_id), usize(tp))
+}
+
+pub const epoll_event = arch.epoll_event;
+
+pub fn epoll_create1(flags: usize) -> usize {
+    arch.syscall1(arch.SYS_epoll_create1, flags)
+}
+
+pub fn epoll_ctl(epoll_fd: i32, op: i32, fd: i32, ev: &epoll_event) -> usize {
+    arch.syscall4(arch.SYS_epoll_ctl, usize(epoll_fd), usize(op), usize(fd), usize(ev))
+}
+
+/// Waits for events on the file descriptors of epoll_fd. timeout is in
+/// milliseconds, and -1 waits forever.
+pub fn epoll_wait(epoll_fd: i32, events: &epoll_event, maxevents: u32, timeout: i32) -> usize {
+    // the kernel only looks at the low 32 bits, so -1 needs no sign extension
+    const timeout_bits = *(&const u32)(&timeout);
+    arch.syscall4(arch.SYS_epoll_wait, usize(epoll_fd), usize(events), usize(maxevents), usize(timeout_bits))
+}
+
+pub const itimerspec = extern struct {
+    it_interval: timespec,
+    it_value: timespec,
+};
+
+pub fn timerfd_create(clockid: i32, flags: u32) -> usize {
+    arch.syscall2(arch.SYS_timerfd_create, usize(clockid), usize(flags))
+}
+
+pub fn timerfd_settime(fd: i32, flags: u32, new_value: &const itimerspec, old_value: ?&itimerspec) -> usize {
+    arch.syscall4(arch.SYS_timerfd_settime, usize(fd), usize(flags), usize(new_value), usize(old_value))
+}
+
+pub const IORING_SETUP_IOPOLL = 1 << 0;
+pub const IORING_SETUP_SQPOLL = 1 << 1;
+pub const IORING_SETUP_SQ_AFF = 1 << 2;
+pub const IORING_SETUP_CQSIZE = 1 << 3;
+
+pub const IORING_FEAT_SINGLE_MMAP = 1 << 0;
+pub const IORING_FEAT_NODROP = 1 << 1;
+
+pub const IORING_OFF_SQ_RING = 0;
+pub const IORING_OFF_CQ_RING = 0x8000000;
+pub const IORING_OFF_SQES = 0x10000000;
+
+pub const IORING_ENTER_GETEVENTS = 1 << 0;
+pub const IORING_ENTER_SQ_WAKEUP = 1 << 1;
+
+pub const IORING_SQ_NEED_WAKEUP = 1 << 0;
+
+pub const IOSQE_FIXED_FILE = 1 << 0;
+pub const IOSQE_IO_DRAIN = 1 << 1;
+/// The next submission starts only after this one completes successfully.
+pub const IOSQE_IO_LINK = 1 << 2;
+pub const IOSQE_IO_HARDLINK = 1 << 3;
+pub const IOSQE_ASYNC = 1 << 4;
+
+pub const IORING_OP_NOP = 0;
+pub const IORING_OP_READV = 1;
+pub const IORING_OP_WRITEV = 2;
+pub const IORING_OP_FSYNC = 3;
+pub const IORING_OP_READ_FIXED = 4;
+pub const IORING_OP_WRITE_FIXED = 5;
+pub const IORING_OP_POLL_ADD = 6;
+pub const IORING_OP_POLL_REMOVE = 7;
+pub const IORING_OP_SYNC_FILE_RANGE = 8;
+pub const IORING_OP_SENDMSG = 9;
+pub const IORING_OP_RECVMSG = 10;
+pub const IORING_OP_TIMEOUT = 11;
+pub const IORING_OP_TIMEOUT_REMOVE = 12;
+pub const IORING_OP_ACCEPT = 13;
+pub const IORING_OP_ASYNC_CANCEL = 14;
+pub const IORING_OP_LINK_TIMEOUT = 15;
+pub const IORING_OP_CONNECT = 16;
+pub const IORING_OP_FALLOCATE = 17;
+pub const IORING_OP_OPENAT = 18;
+pub const IORING_OP_CLOSE = 19;
+pub const IORING_OP_FILES_UPDATE = 20;
+pub const IORING_OP_STATX = 21;
+pub const IORING_OP_READ = 22;
+pub const IORING_OP_WRITE = 23;
+pub const IORING_OP_FADVISE = 24;
+pub const IORING_OP_MADVISE = 25;
+pub const IORING_OP_SEND = 26;
+pub const IORING_OP_RECV = 27;
+
+pub const io_sqring_offsets = extern struct {
+    head: u32,
+    tail: u32,
+    ring_mask: u32,
+    ring_entries: u32,
+    flags: u32,
+    dropped: u32,
+    array: u32,
+    resv1: u32,
+    resv2: u64,
+};
+
+pub const io_cqring_offsets = extern struct {
+    head: u32,
+    tail: u32,
+    ring_mask: u32,
+    ring_entries: u32,
+    overflow: u32,
+    cqes: u32,
+    flags: u32,
+    resv1: u32,
+    resv2: u64,
+};
+
+pub const io_uring_params = extern struct {
+    sq_entries: u32,
+    cq_entries: u32,
+    flags: u32,
+    sq_thread_cpu: u32,
+    sq_thread_idle: u32,
+    features: u32,
+    wq_fd: u32,
+    resv: [3]u32,
+    sq_off: io_sqring_offsets,
+    cq_off: io_cqring_offsets,
+};
+
+/// A submission queue entry. op_flags holds the flags of the operation, such
+/// as rw_flags, msg_flags or accept_flags.
+pub const io_uring_sqe = extern struct {
+    opcode: u8,
+    flags: u8,
+    ioprio: u16,
+    fd: i32,
+    off: u64,
+    addr: u64,
+    len: u32,
+    op_flags: u32,
+    user_data: u64,
+    buf_index: u16,
+    personality: u16,
+    splice_fd_in: i32,
+    pad: [2]u64,
+};
+
+/// A completion queue entry. res is what the system call would have
+/// returned, with errors as negative errno values.
+pub const io_uring_cqe = extern struct {
+    user_data: u64,
+    res: i32,
+    flags: u32,
+};
+
+pub fn io_uring_setup(entries: u32, params: &io_uring_params) -> usize {
+    arch.syscall2(arch.SYS_io_uring_setup, usize(entries), usize(params))
+}
+
+pub fn io_uring_enter(fd: i32, to_submit: u32, min_complete: u32, flags: u32) -> usize {
+    arch.syscall6(arch.SYS_io_uring_enter, usize(fd), usize(to_submit), usize(min_complete), usize(flags), 0, NSIG/8)
+}
+
+pub fn io_uring_register(fd: i32, opcode: u32, arg: ?&const u8, nr_args: u32) -> usize {
+    arch.syscall4(arch.SYS_io_uring_register, usize(fd), usize(opcode), usize(arg), usize(nr_args))
+}
@@ -376,6 +376,10 @@ pub const SYS_shutdown = 373;
 pub const SYS_userfaultfd = 374;
 pub const SYS_membarrier = 375;
 pub const SYS_mlock2 = 376;
+pub const SYS_copy_file_range = 377;
+pub const SYS_io_uring_setup = 425;
+pub const SYS_io_uring_enter = 426;
+pub const SYS_io_uring_register = 427;
 
 
 pub const O_CREAT        = 0o100;
@@ -486,6 +490,62 @@ pub inline fn syscall6(number: usize, arg1: usize, arg2: usize, arg3: usize,
             [arg6] "{ebp}" (arg6))
 }
 
+/// Runs func(arg) in a new thread or process whose stack starts at stack,
+/// the highest address of its stack memory. The child exits with the return
+/// value of func. Returns the id of the child, or an error as getErrno
+/// expects. With CLONE_SETTLS, tls is a &user_desc which sets up a thread
+/// local storage segment for the child.
+pub fn clone(func: extern fn(arg: usize) -> u8, stack: usize, flags: usize, arg: usize,
+    ptid: ?&i32, tls: usize, ctid: ?&i32) -> usize
+{
+    // the child pops func off its stack, which leaves arg on top of the
+    // stack, aligned to 16 bytes, as the argument of the call
+    const child_stack = (stack & ~usize(15)) - 20;
+    *(&extern fn(arg: usize) -> u8)(child_stack) = func;
+    *(&usize)(child_stack + 4) = arg;
+    // 1 is SYS_exit, which ends only the calling thread
+    asm volatile (
+        \int $0x80
+        \test %%eax, %%eax
+        \jnz 1f
+        \xor %%ebp, %%ebp
+        \pop %%eax
+        \call *%%eax
+        \mov %%eax, %%ebx
+        \mov $1, %%eax
+        \int $0x80
+        \hlt
+        \1:
+        : [ret] "={eax}" (-> usize)
+        : [number] "{eax}" (usize(SYS_clone)),
+            [flags] "{ebx}" (flags),
+            [stack] "{ecx}" (child_stack),
+            [ptid] "{edx}" (usize(ptid)),
+            [tls] "{esi}" (tls),
+            [ctid] "{edi}" (usize(ctid))
+        : "memory")
+}
+
+/// A segment descriptor for set_thread_area. flags holds the bit fields
+/// seg_32bit, contents (2 bits), read_exec_only, limit_in_pages,
+/// seg_not_present and useable, from the lowest bit up.
+pub const user_desc = extern struct {
+    entry_number: u32,
+    base_addr: u32,
+    limit: u32,
+    flags: u32,
+};
+
+pub const USER_DESC_SEG_32BIT = 1 << 0;
+pub const USER_DESC_LIMIT_IN_PAGES = 1 << 4;
+pub const USER_DESC_USEABLE = 1 << 6;
+
+/// With u_info.entry_number set to @maxValue(u32), picks a free thread local
+/// storage entry and writes its number back to u_info.
+pub fn set_thread_area(u_info: &user_desc) -> usize {
+    syscall1(SYS_set_thread_area, usize(u_info))
+}
+
 export struct msghdr {
     msg_name: &u8,
     msg_namelen: socklen_t,
@@ -495,3 +555,13 @@ export struct msghdr {
     msg_controllen: socklen_t,
     msg_flags: i32,
 }
+
+pub const timespec = extern struct {
+    tv_sec: isize,
+    tv_nsec: isize,
+};
+
+pub const epoll_event = extern struct {
+    events: u32,
+    data: u64,
+};
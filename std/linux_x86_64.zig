@@ -328,6 +328,10 @@ pub const SYS_execveat = 322;
 pub const SYS_userfaultfd = 323;
 pub const SYS_membarrier = 324;
 pub const SYS_mlock2 = 325;
+pub const SYS_copy_file_range = 326;
+pub const SYS_io_uring_setup = 425;
+pub const SYS_io_uring_enter = 426;
+pub const SYS_io_uring_register = 427;
 
 pub const O_CREAT =        0o100;
 pub const O_EXCL =         0o200;
@@ -442,6 +446,51 @@ pub inline fn syscall6(number: usize, arg1: usize, arg2: usize, arg3: usize, arg
         : "rcx", "r11")
 }
 
+/// Runs func(arg) in a new thread or process whose stack starts at stack,
+/// the highest address of its stack memory. The child exits with the return
+/// value of func. Returns the id of the child, or an error as getErrno
+/// expects. With CLONE_SETTLS, tls becomes the fs base of the child.
+pub fn clone(func: extern fn(arg: usize) -> u8, stack: usize, flags: usize, arg: usize,
+    ptid: ?&i32, tls: usize, ctid: ?&i32) -> usize
+{
+    // the child pops arg and func off its stack, which leaves the stack
+    // aligned to 16 bytes for the call
+    const child_stack = (stack & ~usize(15)) - 16;
+    *(&usize)(child_stack) = arg;
+    *(&extern fn(arg: usize) -> u8)(child_stack + 8) = func;
+    // 60 is SYS_exit, which ends only the calling thread
+    asm volatile (
+        \syscall
+        \test %%rax, %%rax
+        \jnz 1f
+        \xor %%ebp, %%ebp
+        \pop %%rdi
+        \pop %%rax
+        \call *%%rax
+        \mov %%eax, %%edi
+        \mov $60, %%eax
+        \syscall
+        \hlt
+        \1:
+        : [ret] "={rax}" (-> usize)
+        : [number] "{rax}" (usize(SYS_clone)),
+            [flags] "{rdi}" (flags),
+            [stack] "{rsi}" (child_stack),
+            [ptid] "{rdx}" (usize(ptid)),
+            [ctid] "{r10}" (usize(ctid)),
+            [tls] "{r8}" (tls)
+        : "rcx", "r11", "memory")
+}
+
+pub const ARCH_SET_GS = 0x1001;
+pub const ARCH_SET_FS = 0x1002;
+pub const ARCH_GET_FS = 0x1003;
+pub const ARCH_GET_GS = 0x1004;
+
+pub fn arch_prctl(code: i32, addr: usize) -> usize {
+    syscall2(SYS_arch_prctl, usize(code), addr)
+}
+
 pub const msghdr = extern struct {
     msg_name: &u8,
     msg_namelen: socklen_t,
@@ -478,3 +527,9 @@ pub const timespec = extern struct {
     tv_sec: isize,
     tv_nsec: isize,
 };
+
+// The kernel packs this struct on x86_64 only.
+pub const epoll_event = packed struct {
+    events: u32,
+    data: u64,
+};
@@ -32,6 +32,23 @@ pub fn shlOverflow(comptime T: type, a: T, b: T) -> %T {
     if (@shlWithOverflow(T, a, b, &answer)) error.Overflow else answer
 }
 
+/// Returns the high 64 bits of a * b and stores the low 64 bits in lo.
+pub fn mulWide(a: u64, b: u64, lo: &u64) -> u64 {
+    const a_lo = a & 0xffffffff;
+    const a_hi = a >> 32;
+    const b_lo = b & 0xffffffff;
+    const b_hi = b >> 32;
+
+    const ll = a_lo * b_lo;
+    const lh = a_lo * b_hi;
+    const hl = a_hi * b_lo;
+    const hh = a_hi * b_hi;
+
+    const mid = (ll >> 32) + (lh & 0xffffffff) + (hl & 0xffffffff);
+    *lo = (mid <<% 32) | (ll & 0xffffffff);
+    return hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+}
+
 pub fn log(comptime base: usize, value: var) -> @typeOf(value) {
     const T = @typeOf(value);
     if (@isInteger(T)) {
@@ -104,6 +121,16 @@ fn testMathImpl() {
     assert(%%shlOverflow(i32, 0b11, 4) == 0b110000);
 }
 
+fn testMulWide() {
+    @setFnTest(this);
+
+    var lo: u64 = undefined;
+    assert(mulWide(@maxValue(u64), @maxValue(u64), &lo) == @maxValue(u64) - 1);
+    assert(lo == 1);
+    assert(mulWide(1 << 32, 1 << 32, &lo) == 1);
+    assert(lo == 0);
+}
+
 fn foo() {
    @setFnTest(this);
    assert(false);
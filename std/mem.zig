@@ -41,18 +41,18 @@ pub const Allocator = struct {
 };
 
 /// Copy all of source into dest at position 0.
-/// dest.len must be >= source.len.
+/// dest.len must be >= source.len, and the two must not overlap.
 pub fn copy(comptime T: type, dest: []T, source: []const T) {
-    // TODO instead of manually doing this check for the whole array
-    // and turning off debug safety, the compiler should detect loops like
-    // this and automatically omit safety checks for loops
-    @setDebugSafety(this, false);
     assert(dest.len >= source.len);
-    for (source) |s, i| dest[i] = s;
+    @memcpy((&u8)(dest.ptr), (&const u8)(source.ptr), source.len * @sizeOf(T));
 }
 
 pub fn set(comptime T: type, dest: []T, value: T) {
-    for (dest) |*d| *d = value;
+    if (T == u8) {
+        @memset(dest.ptr, value, dest.len);
+    } else {
+        for (dest) |*d| *d = value;
+    }
 }
 
 /// Return < 0, == 0, or > 0 if memory a is less than, equal to, or greater than,
@@ -60,6 +60,9 @@ pub fn set(comptime T: type, dest: []T, value: T) {
 pub fn cmp(comptime T: type, a: []const T, b: []const T) -> Cmp {
     const n = math.min(a.len, b.len);
     var i: usize = 0;
+    if (T == u8) {
+        i = commonPrefixWords(a, b, n);
+    }
     while (i < n; i += 1) {
         if (a[i] == b[i]) continue;
         return if (a[i] > b[i]) Cmp.Greater else if (a[i] < b[i]) Cmp.Less else Cmp.Equal;
@@ -71,16 +74,327 @@ pub fn cmp(comptime T: type, a: []const T, b: []const T) -> Cmp {
 /// Compares two slices and returns whether they are equal.
 pub fn eql(comptime T: type, a: []const T, b: []const T) -> bool {
     if (a.len != b.len) return false;
-    for (a) |item, index| {
-        if (b[index] != item) return false;
+    var i: usize = 0;
+    if (T == u8) {
+        i = commonPrefixWords(a, b, a.len);
+    }
+    while (i < a.len; i += 1) {
+        if (b[i] != a[i]) return false;
     }
     return true;
 }
 
+/// Returns how many of the first n bytes of a and b can be skipped because
+/// they are equal, comparing two words per step. The rest, at most two words
+/// and including the first difference if there is one, is left to the caller.
+/// The loads are not necessarily aligned.
+fn commonPrefixWords(a: []const u8, b: []const u8, n: usize) -> usize {
+    const step = 2 * @sizeOf(usize);
+    var i: usize = 0;
+    while (i + step <= n; i += step) {
+        const a0 = readUnaligned(usize, &a[i]);
+        const b0 = readUnaligned(usize, &b[i]);
+        const a1 = readUnaligned(usize, &a[i + @sizeOf(usize)]);
+        const b1 = readUnaligned(usize, &b[i + @sizeOf(usize)]);
+        if (((a0 ^ b0) | (a1 ^ b1)) != 0)
+            break;
+    }
+    return i;
+}
+
+/// Returns the index of the first occurrence of value in slice, or null.
+pub fn indexOfScalar(comptime T: type, slice: []const T, value: T) -> ?usize {
+    var i: usize = 0;
+    if (T == u8) {
+        i = skipWordsWithoutByte(slice, value);
+    }
+    while (i < slice.len; i += 1) {
+        if (slice[i] == value) return i;
+    }
+    return null;
+}
+
+/// Returns the index of the last occurrence of value in slice, or null.
+pub fn lastIndexOfScalar(comptime T: type, slice: []const T, value: T) -> ?usize {
+    var i: usize = slice.len;
+    while (i != 0) {
+        i -= 1;
+        if (slice[i] == value) return i;
+    }
+    return null;
+}
+
+/// Returns how many bytes at the start of slice can be skipped because they
+/// do not contain value, checking a word per step. The rest is left to the
+/// caller. The loads are not necessarily aligned.
+fn skipWordsWithoutByte(slice: []const u8, value: u8) -> usize {
+    const ones = @maxValue(usize) / 0xff;
+    const highs = ones * 0x80;
+    const pattern = ones * usize(value);
+    var i: usize = 0;
+    while (i + @sizeOf(usize) <= slice.len; i += @sizeOf(usize)) {
+        // A byte of x is zero where the word matches value, and this
+        // expression is nonzero exactly when x has a zero byte.
+        const x = readUnaligned(usize, &slice[i]) ^ pattern;
+        if (((x -% ones) & ~x & highs) != 0)
+            break;
+    }
+    return i;
+}
+
+/// Returns the index of the first occurrence of needle in haystack, or null.
+/// An empty needle is found at index 0.
+pub fn indexOf(comptime T: type, haystack: []const T, needle: []const T) -> ?usize {
+    return indexOfPos(T, haystack, 0, needle);
+}
+
+/// Like indexOf, but the search starts at start_index.
+pub fn indexOfPos(comptime T: type, haystack: []const T, start_index: usize, needle: []const T) -> ?usize {
+    if (start_index > haystack.len || needle.len > haystack.len - start_index)
+        return null;
+    if (needle.len == 0)
+        return start_index;
+    const result = if (needle.len < two_way_threshold) {
+        indexOfShort(T, haystack[start_index...], needle)
+    } else {
+        indexOfTwoWay(T, haystack[start_index...], needle)
+    };
+    const index = result ?? return null;
+    return start_index + index;
+}
+
+/// Returns the index of the last occurrence of needle in haystack, or null.
+/// This is a plain scan, which takes O(haystack.len * needle.len) in the worst
+/// case.
+pub fn lastIndexOf(comptime T: type, haystack: []const T, needle: []const T) -> ?usize {
+    if (needle.len > haystack.len)
+        return null;
+    var i = haystack.len - needle.len + 1;
+    while (i != 0) {
+        i -= 1;
+        if (eql(T, haystack[i...i + needle.len], needle))
+            return i;
+    }
+    return null;
+}
+
+/// Needles at least this long are searched for with the Two-Way algorithm.
+/// Shorter ones use a scan for the first element followed by a comparison,
+/// which is faster in practice but quadratic in the worst case.
+const two_way_threshold = 16;
+
+fn indexOfShort(comptime T: type, haystack: []const T, needle: []const T) -> ?usize {
+    const last_start = haystack.len - needle.len;
+    var i: usize = 0;
+    while (i <= last_start) {
+        i += indexOfScalar(T, haystack[i...last_start + 1], needle[0]) ?? return null;
+        if (eql(T, haystack[i + 1...i + needle.len], needle[1...]))
+            return i;
+        i += 1;
+    }
+    return null;
+}
+
+const MaximalSuffix = struct {
+    /// Index at which the suffix starts.
+    start: usize,
+    /// Period of the suffix.
+    period: usize,
+};
+
+/// Computes the maximal suffix of needle for the Two-Way algorithm, using the
+/// order of the elements, or the reverse order if reverse is true.
+fn maximalSuffix(comptime T: type, needle: []const T, reverse: bool) -> MaximalSuffix {
+    var start: usize = 0;
+    var j: usize = 0;
+    var k: usize = 1;
+    var period: usize = 1;
+    while (j + k < needle.len) {
+        const a = needle[j + k];
+        const b = needle[start + k - 1];
+        const a_sorts_first = if (reverse) a > b else a < b;
+        if (a_sorts_first) {
+            j += k;
+            k = 1;
+            period = j + 1 - start;
+        } else if (a == b) {
+            if (k != period) {
+                k += 1;
+            } else {
+                j += period;
+                k = 1;
+            }
+        } else {
+            start = j + 1;
+            j = start;
+            k = 1;
+            period = 1;
+        }
+    }
+    return MaximalSuffix {
+        .start = start,
+        .period = period,
+    };
+}
+
+/// Crochemore-Perrin Two-Way string matching, which runs in linear time and
+/// constant space. needle must not be empty or longer than haystack.
+fn indexOfTwoWay(comptime T: type, haystack: []const T, needle: []const T) -> ?usize {
+    const n = haystack.len;
+    const m = needle.len;
+
+    // Critical factorization: needle is split into needle[0...ell] and
+    // needle[ell...].
+    const forward = maximalSuffix(T, needle, false);
+    const backward = maximalSuffix(T, needle, true);
+    const ell = if (forward.start > backward.start) forward.start else backward.start;
+    var period = if (forward.start > backward.start) forward.period else backward.period;
+
+    var j: usize = 0;
+    if (period + ell <= m && eql(T, needle[0...ell], needle[period...period + ell])) {
+        // needle is periodic. memory is the length of the prefix of needle
+        // known to match after a shift by the period.
+        var memory: usize = 0;
+        while (j + m <= n) {
+            var i = if (ell > memory) ell else memory;
+            while (i < m && needle[i] == haystack[i + j]) {
+                i += 1;
+            }
+            if (i < m) {
+                j += i + 1 - ell;
+                memory = 0;
+                continue;
+            }
+            i = ell;
+            while (i > memory && needle[i - 1] == haystack[i - 1 + j]) {
+                i -= 1;
+            }
+            if (i <= memory)
+                return j;
+            j += period;
+            memory = m - period;
+        }
+    } else {
+        period = (if (ell > m - ell) ell else m - ell) + 1;
+        while (j + m <= n) {
+            var i = ell;
+            while (i < m && needle[i] == haystack[i + j]) {
+                i += 1;
+            }
+            if (i < m) {
+                j += i + 1 - ell;
+                continue;
+            }
+            i = ell;
+            while (i > 0 && needle[i - 1] == haystack[i - 1 + j]) {
+                i -= 1;
+            }
+            if (i == 0)
+                return j;
+            j += period;
+        }
+    }
+    return null;
+}
+
+/// Returns an iterator over the parts of buffer separated by any of the
+/// bytes in delimiter_bytes. Runs of delimiters count as one, and there are no
+/// empty tokens. The tokens are slices of buffer, so nothing is allocated.
+pub fn tokenize(buffer: []const u8, delimiter_bytes: []const u8) -> TokenIterator {
+    TokenIterator {
+        .buffer = buffer,
+        .delimiter_bytes = delimiter_bytes,
+        .index = 0,
+    }
+}
+
+pub const TokenIterator = struct {
+    buffer: []const u8,
+    delimiter_bytes: []const u8,
+    index: usize,
+
+    /// Returns the next token, or null once the buffer is exhausted.
+    pub fn next(self: &TokenIterator) -> ?[]const u8 {
+        while (self.index < self.buffer.len && self.isDelimiter(self.buffer[self.index])) {
+            self.index += 1;
+        }
+        const start = self.index;
+        if (start == self.buffer.len)
+            return null;
+        while (self.index < self.buffer.len && !self.isDelimiter(self.buffer[self.index])) {
+            self.index += 1;
+        }
+        return self.buffer[start...self.index];
+    }
+
+    /// Returns the rest of the buffer without consuming it.
+    pub fn rest(self: &const TokenIterator) -> []const u8 {
+        return self.buffer[self.index...];
+    }
+
+    fn isDelimiter(self: &const TokenIterator, byte: u8) -> bool {
+        return indexOfScalar(u8, self.delimiter_bytes, byte) != null;
+    }
+};
+
+/// Returns an iterator over the parts of buffer separated by delimiter. This
+/// yields n + 1 parts for n delimiters, so there can be empty ones. The parts
+/// are slices of buffer, so nothing is allocated.
+pub fn split(buffer: []const u8, delimiter: []const u8) -> SplitIterator {
+    assert(delimiter.len != 0);
+    SplitIterator {
+        .buffer = buffer,
+        .delimiter = delimiter,
+        .index = 0,
+        .done = false,
+    }
+}
+
+pub const SplitIterator = struct {
+    buffer: []const u8,
+    delimiter: []const u8,
+    index: usize,
+    done: bool,
+
+    /// Returns the next part, or null after the last one.
+    pub fn next(self: &SplitIterator) -> ?[]const u8 {
+        if (self.done)
+            return null;
+        const start = self.index;
+        if (const end ?= indexOfPos(u8, self.buffer, start, self.delimiter)) {
+            self.index = end + self.delimiter.len;
+            return self.buffer[start...end];
+        }
+        self.done = true;
+        self.index = self.buffer.len;
+        return self.buffer[start...];
+    }
+};
+
+/// Returns the T in the @sizeOf(T) bytes at ptr, which need not be aligned
+/// for T. Dereferencing a cast pointer would tell LLVM that the address is
+/// aligned, while a constant sized memcpy with an alignment of 1 is a single
+/// unaligned load on targets which have one.
+pub fn readUnaligned(comptime T: type, ptr: &const u8) -> T {
+    var x: T = undefined;
+    @memcpy((&u8)(&x), ptr, @sizeOf(T));
+    return x;
+}
+
+/// Stores value in the bytes at ptr, which need not be aligned for its type.
+pub fn writeUnaligned(ptr: &u8, value: var) {
+    @memcpy(ptr, (&const u8)(&value), @sizeOf(@typeOf(value)));
+}
+
 /// Reads an integer from memory with size equal to bytes.len.
 /// T specifies the return type, which must be large enough to store
 /// the result.
 pub fn readInt(bytes: []const u8, comptime T: type, big_endian: bool) -> T {
+    if (isWholeWord(T) && bytes.len == @sizeOf(T)) {
+        // one load and a byte swap if the byte order is not the native one
+        const x = readUnaligned(T, &bytes[0]);
+        return if (big_endian == @compileVar("is_big_endian")) x else @bswap(x);
+    }
     var result: T = 0;
     if (big_endian) {
         for (bytes) |b| {
@@ -98,7 +412,12 @@ pub fn readInt(bytes: []const u8, comptime T: type, big_endian: bool) -> T {
 /// to fill the entire buffer provided.
 /// value must be an integer.
 pub fn writeInt(buf: []u8, value: var, big_endian: bool) {
-    const uint = @intType(false, @typeOf(value).bit_count);
+    const T = @typeOf(value);
+    if (isWholeWord(T) && buf.len == @sizeOf(T)) {
+        writeUnaligned(&buf[0], if (big_endian == @compileVar("is_big_endian")) value else @bswap(value));
+        return;
+    }
+    const uint = @intType(false, T.bit_count);
     var bits = @truncate(uint, value);
     if (big_endian) {
         var index: usize = buf.len;
@@ -117,12 +436,125 @@ pub fn writeInt(buf: []u8, value: var, big_endian: bool) {
     assert(bits == 0);
 }
 
+// Whether integers of type T can be loaded and stored in a single
+// instruction: at least two bytes, at most a u64, and no padding bits.
+fn isWholeWord(comptime T: type) -> bool {
+    return @sizeOf(T) > 1 && @sizeOf(T) <= 8 && T.bit_count == @sizeOf(T) * 8;
+}
+
 fn testStringEquality() {
     @setFnTest(this);
 
+    testStringEqualityImpl();
+    comptime testStringEqualityImpl();
+}
+fn testStringEqualityImpl() {
     assert(eql(u8, "abcd", "abcd"));
     assert(!eql(u8, "abcdef", "abZdef"));
     assert(!eql(u8, "abcdefg", "abcdef"));
+
+    // Long enough to be compared a word at a time.
+    const long = "the quick brown fox jumps over the lazy dog";
+    assert(eql(u8, long, "the quick brown fox jumps over the lazy dog"));
+    assert(!eql(u8, long, "the quick brown fox jumps over the lazy cog"));
+    assert(!eql(u8, long, "The quick brown fox jumps over the lazy dog"));
+    assert(!eql(u8, long, "the quick brown fox jumps ovr the lazy dog!"));
+}
+
+fn testCmp() {
+    @setFnTest(this);
+
+    testCmpImpl();
+    comptime testCmpImpl();
+}
+fn testCmpImpl() {
+    assert(cmp(u8, "abcd", "abcd") == Cmp.Equal);
+    assert(cmp(u8, "abcd", "abce") == Cmp.Less);
+    assert(cmp(u8, "abcd", "abc") == Cmp.Greater);
+
+    const long = "the quick brown fox jumps over the lazy dog";
+    assert(cmp(u8, long, "the quick brown fox jumps over the lazy dog") == Cmp.Equal);
+    assert(cmp(u8, long, "the quick brown fox jumps over the lazy cog") == Cmp.Greater);
+    assert(cmp(u8, long, "the quick brown fox jumps over the lazy dogs") == Cmp.Less);
+    assert(cmp(u8, long, "the quick brown fox jumps over zhe lazy dog") == Cmp.Less);
+    assert(cmp(i32, []i32{1, 2, 3}, []i32{1, 2, 4}) == Cmp.Less);
+}
+
+fn testCopyAndSet() {
+    @setFnTest(this);
+
+    testCopyAndSetImpl();
+    comptime testCopyAndSetImpl();
+}
+fn testCopyAndSetImpl() {
+    var bytes = []u8{0} ** 8;
+    set(u8, bytes[0...], 0xaa);
+    copy(u8, bytes[2...], "abc");
+    assert(eql(u8, bytes, []u8{ 0xaa, 0xaa, 'a', 'b', 'c', 0xaa, 0xaa, 0xaa }));
+
+    var ints = []u32{0} ** 4;
+    set(u32, ints[0...], 7);
+    copy(u32, ints[1...], []u32{ 1, 2 });
+    assert(eql(u32, ints, []u32{ 7, 1, 2, 7 }));
+}
+
+fn testIndexOf() {
+    @setFnTest(this);
+
+    testIndexOfImpl();
+    comptime testIndexOfImpl();
+}
+fn testIndexOfImpl() {
+    assert(??indexOfScalar(u8, "one two three four", 'f') == 14);
+    assert(??indexOfScalar(u8, "one two three four five six", 'x') == 26);
+    assert(indexOfScalar(u8, "one two three four", 'z') == null);
+    assert(??lastIndexOfScalar(u8, "one two three four", 'o') == 15);
+    assert(??indexOfScalar(i32, []i32{ 1, 2, 3 }, 3) == 2);
+
+    assert(??indexOf(u8, "one two three four", "four") == 14);
+    assert(??indexOf(u8, "one two three four", "") == 0);
+    assert(indexOf(u8, "one two three four", "fours") == null);
+    assert(??indexOfPos(u8, "one two one", 1, "one") == 8);
+    assert(??lastIndexOf(u8, "one two three two four", "two") == 14);
+    assert(lastIndexOf(u8, "one two three four", "five") == null);
+
+    // Long needles go through the Two-Way search.
+    const haystack = "abaabaabbabaabaababaabaabbabaabaabaabaabab";
+    assert(??indexOf(u8, haystack, "abaabaabbabaabaabaa") == 17);
+    assert(??indexOf(u8, haystack, "bbabaabaabaabaabab") == 24);
+    assert(indexOf(u8, haystack, "abaabaabbabaabaabb") == null);
+    assert(??indexOf(u8, "aaaaaaaaaaaaaaaaaaaaaaaaaaaab", "aaaaaaaaaaaaaaaaab") == 11);
+}
+
+fn testTokenize() {
+    @setFnTest(this);
+
+    var it = tokenize("   abc def   ghi  ", " ");
+    assert(eql(u8, ??it.next(), "abc"));
+    assert(eql(u8, ??it.next(), "def"));
+    assert(eql(u8, ??it.next(), "ghi"));
+    assert(it.next() == null);
+
+    it = tokenize("a,b;;c", ",;");
+    assert(eql(u8, ??it.next(), "a"));
+    assert(eql(u8, ??it.next(), "b"));
+    assert(eql(u8, ??it.next(), "c"));
+    assert(it.next() == null);
+}
+
+fn testSplit() {
+    @setFnTest(this);
+
+    var it = split("a, b, , c", ", ");
+    assert(eql(u8, ??it.next(), "a"));
+    assert(eql(u8, ??it.next(), "b"));
+    assert(eql(u8, ??it.next(), ""));
+    assert(eql(u8, ??it.next(), "c"));
+    assert(it.next() == null);
+
+    it = split("", ",");
+    assert(eql(u8, ??it.next(), ""));
+    assert(it.next() == null);
 }
 
 fn testReadInt() {
@@ -147,6 +579,11 @@ fn testReadIntImpl() {
         const answer = readInt(buf, u64, false);
         assert(answer == 0x00003412);
     }
+    {
+        const bytes = []u8{ 0xff, 0xfe };
+        assert(readInt(bytes, i16, true) == -2);
+        assert(readInt(bytes, i16, false) == -257);
+    }
 }
 
 fn testWriteInt() {
@@ -169,4 +606,22 @@ fn testWriteIntImpl() {
 
     writeInt(bytes[0...], u16(0x1234), false);
     assert(eql(u8, bytes, []u8{ 0x34, 0x12, 0x00, 0x00 }));
+
+    writeInt(bytes[0...], i32(-2), true);
+    assert(eql(u8, bytes, []u8{ 0xff, 0xff, 0xff, 0xfe }));
+}
+
+fn testUnaligned() {
+    @setFnTest(this);
+
+    testUnalignedImpl();
+    comptime testUnalignedImpl();
+}
+fn testUnalignedImpl() {
+    var bytes: [9]u8 = undefined;
+    writeUnaligned(&bytes[1], u64(0x0102030405060708));
+    assert(readUnaligned(u64, &bytes[1]) == 0x0102030405060708);
+    assert(readInt(bytes[1...9], u64, true) == 0x0102030405060708 ||
+        readInt(bytes[1...9], u64, false) == 0x0102030405060708);
+    assert(readUnaligned(u32, &bytes[3]) == readInt(bytes[3...7], u32, @compileVar("is_big_endian")));
 }
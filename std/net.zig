@@ -12,12 +12,20 @@ error ConnectionRefused;
 error NoMem;
 error NotSocket;
 error BadFd;
-
-const Connection = struct {
+error WouldBlock;
+error PipeFail;
+error AddressInUse;
+error ProcessFdQuotaExceeded;
+error SystemFdQuotaExceeded;
+
+/// A connected socket. The send and recv functions return error.WouldBlock
+/// when the socket is non-blocking and the operation would have to wait.
+pub const Connection = struct {
     socket_fd: i32,
 
     pub fn send(c: Connection, buf: []const u8) -> %usize {
-        const send_ret = linux.sendto(c.socket_fd, buf.ptr, buf.len, 0, null, 0);
+        // a peer which went away is reported as error.PipeFail instead of SIGPIPE
+        const send_ret = linux.sendto(c.socket_fd, buf.ptr, buf.len, linux.MSG_NOSIGNAL, null, 0);
         const send_err = linux.getErrno(send_ret);
         switch (send_err) {
             0 => return send_ret,
@@ -25,6 +33,8 @@ const Connection = struct {
             errno.EFAULT => @unreachable(),
             errno.ECONNRESET => return error.ConnectionReset,
             errno.EINTR => return error.SigInterrupt,
+            errno.EAGAIN => return error.WouldBlock,
+            errno.EPIPE => return error.PipeFail,
             // TODO there are more possible errors
             else => return error.Unexpected,
         }
@@ -41,7 +51,9 @@ const Connection = struct {
             errno.EINTR => return error.SigInterrupt,
             errno.ENOMEM => return error.NoMem,
             errno.ECONNREFUSED => return error.ConnectionRefused,
+            errno.ECONNRESET => return error.ConnectionReset,
             errno.EBADF => return error.BadFd,
+            errno.EAGAIN => return error.WouldBlock,
             // TODO more error values
             else => return error.Unexpected,
         }
@@ -58,13 +70,125 @@ const Connection = struct {
     }
 };
 
-const Address = struct {
+pub const Address = struct {
     family: u16,
     scope_id: u32,
     addr: [16]u8,
     sort_key: i32,
 };
 
+pub fn ip4Address(octets: [4]u8) -> Address {
+    var result = Address {
+        .family = linux.AF_INET,
+        .scope_id = 0,
+        .addr = []u8{0} ** 16,
+        .sort_key = 0,
+    };
+    @memcpy(&result.addr[0], &octets[0], 4);
+    return result;
+}
+
+/// A listening socket, which is non-blocking so that it can be driven by an
+/// event loop. Accepted connections are non-blocking too.
+pub const Listener = struct {
+    socket_fd: i32,
+
+    /// Returns error.WouldBlock when no connection is waiting.
+    pub fn accept(l: Listener) -> %Connection {
+        while (true) {
+            const accept_ret = linux.accept4(l.socket_fd, null, null, linux.SOCK_NONBLOCK | linux.SOCK_CLOEXEC);
+            const accept_err = linux.getErrno(accept_ret);
+            switch (accept_err) {
+                0 => return Connection { .socket_fd = i32(accept_ret) },
+                errno.EINTR => continue,
+                // the connection was aborted while it waited, take the next one
+                errno.ECONNABORTED => continue,
+                errno.EAGAIN => return error.WouldBlock,
+                errno.EBADF => return error.BadFd,
+                errno.ENOTSOCK => return error.NotSocket,
+                errno.EMFILE => return error.ProcessFdQuotaExceeded,
+                errno.ENFILE => return error.SystemFdQuotaExceeded,
+                errno.ENOBUFS, errno.ENOMEM => return error.NoMem,
+                errno.EINVAL, errno.EFAULT => @unreachable(),
+                else => return error.Unexpected,
+            }
+        }
+    }
+
+    /// Accepts waiting connections into out until it is full or no more are
+    /// waiting, and returns the accepted part of out. With an edge triggered
+    /// event loop, call it again while it fills out.
+    pub fn acceptBatch(l: Listener, out: []Connection) -> %[]Connection {
+        var count: usize = 0;
+        while (count < out.len) {
+            out[count] = l.accept() %% |err| {
+                if (err == error.WouldBlock) break;
+                // hand out what was accepted, the error comes up again next call
+                if (count > 0) break;
+                return err;
+            };
+            count += 1;
+        }
+        return out[0...count];
+    }
+
+    /// The port the listener is bound to, which is useful after listening on port 0.
+    pub fn getPort(l: Listener) -> %u16 {
+        var os_addr: linux.sockaddr_in6 = undefined;
+        var len: linux.socklen_t = @sizeOf(linux.sockaddr_in6);
+        const name_err = linux.getErrno(linux.getsockname(l.socket_fd, (&linux.sockaddr)(&os_addr), &len));
+        if (name_err > 0) {
+            return switch (name_err) {
+                errno.EBADF => error.BadFd,
+                errno.ENOTSOCK => error.NotSocket,
+                errno.ENOBUFS => error.NoMem,
+                else => error.Unexpected,
+            }
+        }
+        return endian.swapIfLe(u16, os_addr.port);
+    }
+
+    pub fn close(l: Listener) -> %void {
+        const c = Connection { .socket_fd = l.socket_fd };
+        return c.close();
+    }
+};
+
+/// Binds a non-blocking listening socket to addr and port. Port 0 picks a free port.
+pub fn listenAddr(addr: &const Address, port: u16, backlog: i32) -> %Listener {
+    const socket_fd = %return openSocket(addr.family, linux.SOCK_NONBLOCK | linux.SOCK_CLOEXEC);
+    %defer {
+        _ = linux.close(socket_fd);
+    }
+
+    const reuse: i32 = 1;
+    _ = linux.setsockopt(socket_fd, linux.SOL_SOCKET, linux.SO_REUSEADDR, (&const u8)(&reuse), @sizeOf(i32));
+
+    var os_addr: linux.sockaddr_in6 = undefined;
+    const os_addr_len = toOsAddr(addr, port, &os_addr);
+    const bind_err = linux.getErrno(linux.bind(socket_fd, (&linux.sockaddr)(&os_addr), os_addr_len));
+    if (bind_err > 0) {
+        return switch (bind_err) {
+            errno.EADDRINUSE => error.AddressInUse,
+            errno.ENOMEM => error.NoMem,
+            // TODO figure out the remaining errors from bind()
+            else => error.Unexpected,
+        }
+    }
+
+    const listen_err = linux.getErrno(linux.listen(socket_fd, backlog));
+    if (listen_err > 0) {
+        return switch (listen_err) {
+            errno.EADDRINUSE => error.AddressInUse,
+            else => error.Unexpected,
+        }
+    }
+
+    return Listener {
+        .socket_fd = socket_fd,
+    };
+}
+
 pub fn lookup(hostname: []const u8, out_addrs: []Address) -> %[]Address {
     if (hostname.len == 0) {
 
@@ -90,46 +214,69 @@ pub fn lookup(hostname: []const u8, out_addrs: []Address) -> %[]Address {
 }
 
 pub fn connectAddr(addr: &Address, port: u16) -> %Connection {
-    const socket_ret = linux.socket(addr.family, linux.SOCK_STREAM, linux.PROTO_tcp);
+    return connectAddrFlags(addr, port, 0);
+}
+
+/// Starts connecting a non-blocking socket. The connection is established
+/// once the socket is writable; errors show up in the first send or recv.
+pub fn connectAddrNonBlock(addr: &Address, port: u16) -> %Connection {
+    return connectAddrFlags(addr, port, linux.SOCK_NONBLOCK | linux.SOCK_CLOEXEC);
+}
+
+fn connectAddrFlags(addr: &Address, port: u16, flags: i32) -> %Connection {
+    const socket_fd = %return openSocket(addr.family, flags);
+
+    var os_addr: linux.sockaddr_in6 = undefined;
+    const os_addr_len = toOsAddr(addr, port, &os_addr);
+    const connect_ret = linux.connect(socket_fd, (&linux.sockaddr)(&os_addr), os_addr_len);
+    const connect_err = linux.getErrno(connect_ret);
+    if (connect_err > 0 && connect_err != errno.EINPROGRESS) {
+        _ = linux.close(socket_fd);
+        switch (connect_err) {
+            errno.ETIMEDOUT => return error.TimedOut,
+            errno.ECONNREFUSED => return error.ConnectionRefused,
+            else => {
+                // TODO figure out possible errors from connect()
+                return error.Unexpected;
+            },
+        }
+    }
+
+    return Connection {
+        .socket_fd = socket_fd,
+    };
+}
+
+fn openSocket(family: u16, flags: i32) -> %i32 {
+    const socket_ret = linux.socket(family, linux.SOCK_STREAM | flags, linux.PROTO_tcp);
     const socket_err = linux.getErrno(socket_ret);
     if (socket_err > 0) {
         // TODO figure out possible errors from socket()
         return error.Unexpected;
     }
-    const socket_fd = i32(socket_ret);
+    return i32(socket_ret);
+}
 
-    const connect_ret = if (addr.family == linux.AF_INET) {
-        var os_addr: linux.sockaddr_in = undefined;
-        os_addr.family = addr.family;
-        os_addr.port = endian.swapIfLe(u16, port);
-        @memcpy((&u8)(&os_addr.addr), &addr.addr[0], 4);
-        @memset(&os_addr.zero[0], 0, @sizeOf(@typeOf(os_addr.zero)));
-        linux.connect(socket_fd, (&linux.sockaddr)(&os_addr), @sizeOf(linux.sockaddr_in))
+/// Fills os_addr, which is big enough for any family, and returns the length
+/// of the part that is used.
+fn toOsAddr(addr: &const Address, port: u16, os_addr: &linux.sockaddr_in6) -> linux.socklen_t {
+    if (addr.family == linux.AF_INET) {
+        const os_addr4 = (&linux.sockaddr_in)(os_addr);
+        os_addr4.family = addr.family;
+        os_addr4.port = endian.swapIfLe(u16, port);
+        @memcpy((&u8)(&os_addr4.addr), &addr.addr[0], 4);
+        @memset(&os_addr4.zero[0], 0, @sizeOf(@typeOf(os_addr4.zero)));
+        return @sizeOf(linux.sockaddr_in);
     } else if (addr.family == linux.AF_INET6) {
-        var os_addr: linux.sockaddr_in6 = undefined;
         os_addr.family = addr.family;
         os_addr.port = endian.swapIfLe(u16, port);
         os_addr.flowinfo = 0;
         os_addr.scope_id = addr.scope_id;
         @memcpy(&os_addr.addr[0], &addr.addr[0], 16);
-        linux.connect(socket_fd, (&linux.sockaddr)(&os_addr), @sizeOf(linux.sockaddr_in6))
+        return @sizeOf(linux.sockaddr_in6);
     } else {
         @unreachable()
-    };
-    const connect_err = linux.getErrno(connect_ret);
-    if (connect_err > 0) {
-        switch (connect_err) {
-            errno.ETIMEDOUT => return error.TimedOut,
-            else => {
-                // TODO figure out possible errors from connect()
-                return error.Unexpected;
-            },
-        }
     }
-
-    return Connection {
-        .socket_fd = socket_fd,
-    };
 }
 
 pub fn connect(hostname: []const u8, port: u16) -> %Connection {
@@ -319,6 +466,35 @@ fn parseIp4(buf: []const u8) -> %u32 {
 }
 
 
+fn testLoopback() {
+    @setFnTest(this);
+
+    var localhost = ip4Address([]u8 { 127, 0, 0, 1 });
+    const listener = %%listenAddr(&localhost, 0, 16);
+    defer %%listener.close();
+
+    var batch: [4]Connection = undefined;
+    assert((%%listener.acceptBatch(batch[0...])).len == 0);
+
+    const client = %%connectAddr(&localhost, %%listener.getPort());
+    defer %%client.close();
+    const accepted = %%listener.acceptBatch(batch[0...]);
+    assert(accepted.len == 1);
+    const server = accepted[0];
+    defer %%server.close();
+
+    assert(%%client.send("hello") == 5);
+    var buf: [16]u8 = undefined;
+    while (true) {
+        const data = server.recv(buf[0...]) %% |err| {
+            assert(err == error.WouldBlock);
+            continue;
+        };
+        assert(data.len == 5 && data[0] == 'h');
+        break;
+    }
+}
+
 // TODO
 //fn testParseIp4() {
 //    @setFnTest(this);
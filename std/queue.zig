@@ -0,0 +1,307 @@
+const debug = @import("debug.zig");
+const assert = debug.assert;
+const mem = @import("mem.zig");
+const atomic = @import("atomic.zig");
+const Allocator = mem.Allocator;
+
+// Indexes written by different threads are kept at least this far apart,
+// so that they are on different cache lines.
+const cache_line = 64;
+
+/// A bounded queue for exactly one producer thread and one consumer thread,
+/// which never waits: push fails when the queue is full and pop when it is
+/// empty. Use `init` to initialize this state.
+pub fn SpscQueue(comptime T: type) -> type {
+    struct {
+        items: []T,
+        allocator: &Allocator,
+
+        _pad0: [cache_line]u8,
+        // written by the producer. head_cache is what it last read of head.
+        tail: usize,
+        head_cache: usize,
+
+        _pad1: [cache_line]u8,
+        // written by the consumer. tail_cache is what it last read of tail.
+        head: usize,
+        tail_cache: usize,
+
+        _pad2: [cache_line]u8,
+
+        const Self = this;
+
+        /// capacity is rounded up to a power of two. Call deinit to clean up.
+        pub fn init(q: &Self, allocator: &Allocator, capacity: usize) -> %void {
+            q.items = %return allocator.alloc(T, roundUpPowerOfTwo(capacity));
+            q.allocator = allocator;
+            q.tail = 0;
+            q.head_cache = 0;
+            q.head = 0;
+            q.tail_cache = 0;
+        }
+
+        pub fn deinit(q: &Self) {
+            q.allocator.free(q.items);
+        }
+
+        /// Only for the producer. Returns false if the queue is full.
+        pub fn push(q: &Self, item: T) -> bool {
+            const tail = q.tail;
+            if (tail -% q.head_cache == q.items.len) {
+                q.head_cache = atomic.load(usize, &q.head);
+                if (tail -% q.head_cache == q.items.len) return false;
+            }
+            q.items[tail & (q.items.len - 1)] = item;
+            atomic.store(usize, &q.tail, tail +% 1);
+            return true;
+        }
+
+        /// Only for the producer. Pushes as many of items as fit, and returns
+        /// how many that is.
+        pub fn pushBatch(q: &Self, items: []const T) -> usize {
+            const tail = q.tail;
+            var free = q.items.len - (tail -% q.head_cache);
+            if (free < items.len) {
+                q.head_cache = atomic.load(usize, &q.head);
+                free = q.items.len - (tail -% q.head_cache);
+            }
+            const count = if (free < items.len) free else items.len;
+            copyIn(T, q.items, tail, items[0...count]);
+            atomic.store(usize, &q.tail, tail +% count);
+            return count;
+        }
+
+        /// Only for the consumer. Returns null if the queue is empty.
+        pub fn pop(q: &Self) -> ?T {
+            const head = q.head;
+            if (head == q.tail_cache) {
+                q.tail_cache = atomic.load(usize, &q.tail);
+                if (head == q.tail_cache) return null;
+            }
+            const item = q.items[head & (q.items.len - 1)];
+            atomic.store(usize, &q.head, head +% 1);
+            return item;
+        }
+
+        /// Only for the consumer. Pops up to out.len items into out, and
+        /// returns how many that is.
+        pub fn popBatch(q: &Self, out: []T) -> usize {
+            const head = q.head;
+            var available = q.tail_cache -% head;
+            if (available < out.len) {
+                q.tail_cache = atomic.load(usize, &q.tail);
+                available = q.tail_cache -% head;
+            }
+            const count = if (available < out.len) available else out.len;
+            copyOut(T, out[0...count], q.items, head);
+            atomic.store(usize, &q.head, head +% count);
+            return count;
+        }
+    }
+}
+
+/// A bounded queue for any number of producer and consumer threads, which
+/// never waits: push fails when the queue is full and pop when it is empty.
+/// Every slot has a sequence number which tells whose turn it is, so threads
+/// only contend when they claim a position.
+/// Use `init` to initialize this state.
+pub fn MpmcQueue(comptime T: type) -> type {
+    struct {
+        slots: []Slot,
+        allocator: &Allocator,
+
+        _pad0: [cache_line]u8,
+        push_pos: usize,
+        _pad1: [cache_line]u8,
+        pop_pos: usize,
+        _pad2: [cache_line]u8,
+
+        const Self = this;
+
+        // At position pos, a slot is ready to be pushed to when seq is pos,
+        // and ready to be popped from when seq is pos + 1.
+        const Slot = struct {
+            seq: usize,
+            item: T,
+        };
+
+        /// capacity is rounded up to a power of two. Call deinit to clean up.
+        pub fn init(q: &Self, allocator: &Allocator, capacity: usize) -> %void {
+            q.slots = %return allocator.alloc(Slot, roundUpPowerOfTwo(capacity));
+            q.allocator = allocator;
+            for (q.slots) |*slot, i| {
+                slot.seq = i;
+            }
+            q.push_pos = 0;
+            q.pop_pos = 0;
+        }
+
+        pub fn deinit(q: &Self) {
+            q.allocator.free(q.slots);
+        }
+
+        /// Returns false if the queue is full.
+        pub fn push(q: &Self, item: T) -> bool {
+            return q.pushBatch((&item)[0...1]) == 1;
+        }
+
+        /// Pushes as many of items as fit, and returns how many that is. They
+        /// stay together, in order.
+        pub fn pushBatch(q: &Self, items: []const T) -> usize {
+            if (items.len == 0) return 0;
+            const mask = q.slots.len - 1;
+            var pos = atomic.load(usize, &q.push_pos);
+            var count: usize = undefined;
+            while (true) {
+                // Only the thread which claims a position changes the
+                // sequence number of its slot, so the slots found ready
+                // stay ready until they are claimed.
+                count = 0;
+                while (count < items.len) {
+                    const seq = atomic.load(usize, &q.slots[(pos +% count) & mask].seq);
+                    if (seq != pos +% count) break;
+                    count += 1;
+                }
+                if (count == 0) {
+                    const seq = atomic.load(usize, &q.slots[pos & mask].seq);
+                    // a full queue: the slot still holds the item from one lap ago
+                    if (isBefore(seq, pos)) return 0;
+                    // another producer got there first
+                    pos = atomic.load(usize, &q.push_pos);
+                    continue;
+                }
+                if (@cmpxchg(&q.push_pos, pos, pos +% count, AtomicOrder.SeqCst, AtomicOrder.SeqCst)) break;
+                pos = atomic.load(usize, &q.push_pos);
+            }
+            for (items[0...count]) |item, i| {
+                const slot = &q.slots[(pos +% i) & mask];
+                slot.item = item;
+                atomic.store(usize, &slot.seq, pos +% i +% 1);
+            }
+            return count;
+        }
+
+        /// Returns null if the queue is empty.
+        pub fn pop(q: &Self) -> ?T {
+            var item: T = undefined;
+            if (q.popBatch((&item)[0...1]) == 0) return null;
+            return item;
+        }
+
+        /// Pops up to out.len items into out, and returns how many that is.
+        /// They are consecutive items of the queue.
+        pub fn popBatch(q: &Self, out: []T) -> usize {
+            if (out.len == 0) return 0;
+            const mask = q.slots.len - 1;
+            var pos = atomic.load(usize, &q.pop_pos);
+            var count: usize = undefined;
+            while (true) {
+                count = 0;
+                while (count < out.len) {
+                    const seq = atomic.load(usize, &q.slots[(pos +% count) & mask].seq);
+                    if (seq != pos +% count +% 1) break;
+                    count += 1;
+                }
+                if (count == 0) {
+                    const seq = atomic.load(usize, &q.slots[pos & mask].seq);
+                    // an empty queue: nothing was pushed at pos yet
+                    if (isBefore(seq, pos +% 1)) return 0;
+                    // another consumer got there first
+                    pos = atomic.load(usize, &q.pop_pos);
+                    continue;
+                }
+                if (@cmpxchg(&q.pop_pos, pos, pos +% count, AtomicOrder.SeqCst, AtomicOrder.SeqCst)) break;
+                pos = atomic.load(usize, &q.pop_pos);
+            }
+            for (out[0...count]) |*item, i| {
+                const slot = &q.slots[(pos +% i) & mask];
+                *item = slot.item;
+                // ready to be pushed to again, one lap later
+                atomic.store(usize, &slot.seq, pos +% i +% q.slots.len);
+            }
+            return count;
+        }
+    }
+}
+
+// Whether position a comes before b, for positions which wrap around.
+fn isBefore(a: usize, b: usize) -> bool {
+    return a -% b > @maxValue(usize) / 2;
+}
+
+fn roundUpPowerOfTwo(n: usize) -> usize {
+    var result: usize = 2;
+    while (result < n) {
+        result *= 2;
+    }
+    return result;
+}
+
+// Copies items into ring, starting at position pos, wrapping around.
+fn copyIn(comptime T: type, ring: []T, pos: usize, items: []const T) {
+    const start = pos & (ring.len - 1);
+    const first = if (items.len < ring.len - start) items.len else ring.len - start;
+    mem.copy(T, ring[start...], items[0...first]);
+    mem.copy(T, ring, items[first...]);
+}
+
+// Copies out.len items out of ring, starting at position pos, wrapping around.
+fn copyOut(comptime T: type, out: []T, ring: []const T, pos: usize) {
+    const start = pos & (ring.len - 1);
+    const first = if (out.len < ring.len - start) out.len else ring.len - start;
+    mem.copy(T, out, ring[start...start + first]);
+    mem.copy(T, out[first...], ring[0...out.len - first]);
+}
+
+fn testSpscQueue() {
+    @setFnTest(this);
+
+    var q: SpscQueue(u32) = undefined;
+    %%q.init(&debug.global_allocator, 3);
+    defer q.deinit();
+
+    assert(q.items.len == 4);
+    assert(q.pop() == null);
+    {var i: u32 = 0; while (i < 4; i += 1) {
+        assert(q.push(i));
+    }}
+    assert(!q.push(4));
+    assert((q.pop() ?? @unreachable()) == 0);
+    assert((q.pop() ?? @unreachable()) == 1);
+
+    // batches which wrap around the end of the ring
+    const batch = []u32 { 10, 11, 12 };
+    assert(q.pushBatch(batch) == 2);
+    var out: [8]u32 = undefined;
+    assert(q.popBatch(out[0...]) == 4);
+    assert(out[0] == 2 && out[1] == 3 && out[2] == 10 && out[3] == 11);
+    assert(q.popBatch(out[0...]) == 0);
+    assert(q.pushBatch(batch) == 3);
+    assert((q.pop() ?? @unreachable()) == 10);
+}
+
+fn testMpmcQueue() {
+    @setFnTest(this);
+
+    var q: MpmcQueue(u32) = undefined;
+    %%q.init(&debug.global_allocator, 4);
+    defer q.deinit();
+
+    assert(q.pop() == null);
+    const batch = []u32 { 1, 2, 3 };
+    assert(q.pushBatch(batch[0...0]) == 0);
+    assert(q.pushBatch(batch) == 3);
+    assert(q.pushBatch(batch) == 1);
+    assert(!q.push(5));
+    var out: [2]u32 = undefined;
+    assert(q.popBatch(out[0...0]) == 0);
+    assert(q.popBatch(out[0...]) == 2);
+    assert(out[0] == 1 && out[1] == 2);
+    assert(q.push(6));
+    assert(q.push(7));
+    assert((q.pop() ?? @unreachable()) == 3);
+    assert((q.pop() ?? @unreachable()) == 1);
+    assert((q.pop() ?? @unreachable()) == 6);
+    assert((q.pop() ?? @unreachable()) == 7);
+    assert(q.pop() == null);
+}
@@ -1,6 +1,7 @@
 const assert = @import("debug.zig").assert;
 const rand_test = @import("rand_test.zig");
 const mem = @import("mem.zig");
+const math = @import("math.zig");
 
 pub const MT19937_32 = MersenneTwister(
     u32, 624, 397, 31,
@@ -18,81 +19,169 @@ pub const MT19937_64 = MersenneTwister(
     37, 0xFFF7EEE000000000,
     43, 6364136223846793005);
 
-/// Use `init` to initialize this state.
-pub const Rand = struct {
-    const Rng = if (@sizeOf(usize) >= 8) MT19937_64 else MT19937_32;
+/// The generator used by Rand. Use `init` to initialize this state.
+pub const Rand = RandomGenerator(Xoshiro256);
 
-    rng: Rng,
+/// Random values built on an engine, which must provide:
+///  * `Result`, the unsigned integer type returned by `get`.
+///  * `init(self, seed: u64)`.
+///  * `get(self) -> Result`, returning uniformly distributed bits.
+pub fn RandomGenerator(comptime Engine: type) -> type {
+    struct {
+        const Self = this;
+        const Word = Engine.Result;
 
-    /// Initialize random state with the given seed.
-    pub fn init(r: &Rand, seed: usize) {
-        r.rng.init(seed);
-    }
+        rng: Engine,
 
-    /// Get an integer or boolean with random bits.
-    pub fn scalar(r: &Rand, comptime T: type) -> T {
-        if (T == usize) {
-            return r.rng.get();
-        } else if (T == bool) {
-            return (r.rng.get() & 0b1) == 0;
-        } else {
-            var result: [@sizeOf(T)]u8 = undefined;
-            r.fillBytes(result[0...]);
-            return mem.readInt(result, T, false);
+        /// Initialize random state with the given seed.
+        pub fn init(r: &Self, seed: usize) {
+            r.rng.init(seed);
         }
-    }
 
-    /// Fill `buf` with randomness.
-    pub fn fillBytes(r: &Rand, buf: []u8) {
-        var bytes_left = buf.len;
-        while (bytes_left >= @sizeOf(usize)) {
-            mem.writeInt(buf[buf.len - bytes_left...], r.rng.get(), false);
-            bytes_left -= @sizeOf(usize);
+        /// Get an integer or boolean with random bits.
+        pub fn scalar(r: &Self, comptime T: type) -> T {
+            if (T == bool) {
+                return (r.rng.get() & 0b1) == 0;
+            } else if (T.bit_count <= Word.bit_count) {
+                const bits = @truncate(@intType(false, T.bit_count), r.rng.get());
+                return *(&const T)(&bits);
+            } else {
+                var result: T = undefined;
+                r.fillBytes((&u8)(&result)[0...@sizeOf(T)]);
+                return result;
+            }
         }
-        if (bytes_left > 0) {
-            var rand_val_array: [@sizeOf(usize)]u8 = undefined;
-            mem.writeInt(rand_val_array[0...], r.rng.get(), false);
-            while (bytes_left > 0) {
-                buf[buf.len - bytes_left] = rand_val_array[@sizeOf(usize) - bytes_left];
-                bytes_left -= 1;
+
+        /// Fill `buf` with randomness. Each word from the engine is stored
+        /// in little endian order, so the bytes are the same on every target.
+        pub fn fillBytes(r: &Self, buf: []u8) {
+            var i: usize = 0;
+            while (i + @sizeOf(Word) <= buf.len; i += @sizeOf(Word)) {
+                mem.writeInt(buf[i...i + @sizeOf(Word)], r.rng.get(), false);
+            }
+            if (i < buf.len) {
+                var word = r.rng.get();
+                while (i < buf.len; i += 1) {
+                    buf[i] = @truncate(u8, word);
+                    word >>= 8;
+                }
             }
         }
-    }
 
-    /// Get a random unsigned integer with even distribution between `start`
-    /// inclusive and `end` exclusive.
-    // TODO support signed integers and then rename to "range"
-    pub fn rangeUnsigned(r: &Rand, comptime T: type, start: T, end: T) -> T {
-        const range = end - start;
-        const leftover = @maxValue(T) % range;
-        const upper_bound = @maxValue(T) - leftover;
-        var rand_val_array: [@sizeOf(T)]u8 = undefined;
-
-        while (true) {
-            r.fillBytes(rand_val_array[0...]);
-            const rand_val = mem.readInt(rand_val_array, T, false);
-            if (rand_val < upper_bound) {
-                return start + (rand_val % range);
+        /// Get a random unsigned integer with even distribution between `start`
+        /// inclusive and `end` exclusive.
+        /// This is Lemire's method: the high half of random bits times the
+        /// range is the result, and the low half tells when it would be biased.
+        /// Usually no division is needed.
+        // TODO support signed integers and then rename to "range"
+        pub fn rangeUnsigned(r: &Self, comptime T: type, start: T, end: T) -> T {
+            if (T.bit_count <= 32) {
+                const range = u32(end - start);
+                var m = u64(r.scalar(u32)) * u64(range);
+                if (@truncate(u32, m) < range) {
+                    const threshold = (0 -% range) % range;
+                    while (@truncate(u32, m) < threshold) {
+                        m = u64(r.scalar(u32)) * u64(range);
+                    }
+                }
+                return start + T(m >> 32);
+            } else {
+                const range = u64(end - start);
+                var lo: u64 = undefined;
+                var hi = math.mulWide(r.scalar(u64), range, &lo);
+                if (lo < range) {
+                    const threshold = (0 -% range) % range;
+                    while (lo < threshold) {
+                        hi = math.mulWide(r.scalar(u64), range, &lo);
+                    }
+                }
+                return start + T(hi);
             }
         }
+
+        /// Get a floating point value in the range 0.0..1.0.
+        pub fn float(r: &Self, comptime T: type) -> T {
+            // TODO Implement this way instead:
+            // const int = @int_type(false, @sizeOf(T) * 8);
+            // const mask = ((1 << @float_mantissa_bit_count(T)) - 1);
+            // const rand_bits = r.rng.scalar(int) & mask;
+            // return @float_compose(T, false, 0, rand_bits) - 1.0
+            if (T == f32) {
+                return f32(r.scalar(u32) >> 8) / 16777216.0;
+            } else if (T == f64) {
+                return f64(r.scalar(u64) >> 11) / 9007199254740992.0;
+            } else {
+                @compileError("unknown floating point type")
+            }
+        }
+    }
+}
+
+/// xoshiro256** by Blackman and Vigna. 32 bytes of state and a few
+/// operations per 64 bit result, with a period of 2^256 - 1.
+pub const Xoshiro256 = struct {
+    pub const Result = u64;
+
+    s: [4]u64,
+
+    /// The state is expanded from seed with splitmix64, which never makes it all zero.
+    pub fn init(x: &Xoshiro256, seed: u64) {
+        var sm = seed;
+        for (x.s) |*word| {
+            *word = splitMix64(&sm);
+        }
+    }
+
+    pub fn get(x: &Xoshiro256) -> u64 {
+        const result = @rotl(x.s[1] *% 5, 7) *% 9;
+        const t = x.s[1] <<% 17;
+        x.s[2] ^= x.s[0];
+        x.s[3] ^= x.s[1];
+        x.s[1] ^= x.s[2];
+        x.s[0] ^= x.s[3];
+        x.s[2] ^= t;
+        x.s[3] = @rotl(x.s[3], 45);
+        return result;
+    }
+};
+
+fn splitMix64(state: &u64) -> u64 {
+    *state +%= 0x9e3779b97f4a7c15;
+    var z = *state;
+    z = (z ^ (z >> 30)) *% 0xbf58476d1ce4e5b9;
+    z = (z ^ (z >> 27)) *% 0x94d049bb133111eb;
+    return z ^ (z >> 31);
+}
+
+/// PCG32 (XSH RR) by O'Neill. 16 bytes of state and 32 bit results. Each
+/// stream selects an independent sequence for the same seed.
+pub const Pcg32 = struct {
+    pub const Result = u32;
+
+    const multiplier: u64 = 6364136223846793005;
+    const default_stream: u64 = 0xda3e39cb94b95bdb;
+
+    state: u64,
+    inc: u64,
+
+    pub fn init(p: &Pcg32, seed: u64) {
+        p.initStream(seed, default_stream);
+    }
+
+    pub fn initStream(p: &Pcg32, seed: u64, stream: u64) {
+        p.state = 0;
+        p.inc = (stream <<% 1) | 1;
+        _ = p.get();
+        p.state +%= seed;
+        _ = p.get();
     }
 
-    /// Get a floating point value in the range 0.0..1.0.
-    pub fn float(r: &Rand, comptime T: type) -> T {
-        // TODO Implement this way instead:
-        // const int = @int_type(false, @sizeOf(T) * 8);
-        // const mask = ((1 << @float_mantissa_bit_count(T)) - 1);
-        // const rand_bits = r.rng.scalar(int) & mask;
-        // return @float_compose(T, false, 0, rand_bits) - 1.0
-        const int_type = @intType(false, @sizeOf(T) * 8);
-        const precision = if (T == f32) {
-            16777216
-        } else if (T == f64) {
-            9007199254740992
-        } else {
-            @compileError("unknown floating point type")
-        };
-        return T(r.rangeUnsigned(int_type, 0, precision)) / T(precision);
+    pub fn get(p: &Pcg32) -> u32 {
+        const old = p.state;
+        p.state = old *% multiplier +% p.inc;
+        const xorshifted = @truncate(u32, ((old >> 18) ^ old) >> 27);
+        const rot = @truncate(u32, old >> 59);
+        return @rotr(xorshifted, rot);
     }
 };
 
@@ -107,13 +196,15 @@ fn MersenneTwister(
     struct {
         const Self = this;
 
+        pub const Result = int;
+
         array: [n]int,
         index: usize,
 
-        pub fn init(mt: &Self, seed: int) {
+        pub fn init(mt: &Self, seed: u64) {
             mt.index = n;
 
-            var prev_value = seed;
+            var prev_value = int(seed & @maxValue(int));
             mt.array[0] = prev_value;
             {var i: usize = 1; while (i < n; i += 1) {
                 prev_value = int(i) +% f *% (prev_value ^ (prev_value >> (int.bit_count - 2)));
@@ -190,3 +281,75 @@ fn testMT19937_32() {
         assert(value == rng.get());
     }
 }
+
+fn testXoshiro256() {
+    @setFnTest(this);
+
+    var x = Xoshiro256 { .s = []u64 { 1, 2, 3, 4 } };
+    assert(x.get() == 11520);
+    assert(x.get() == 0);
+    assert(x.get() == 1509978240);
+    assert(x.get() == 1215971899390074240);
+
+    x.init(42);
+    assert(x.get() == 0x15780b2e0c2ec716);
+    assert(x.get() == 0x6104d9866d113a7e);
+}
+
+fn testPcg32() {
+    @setFnTest(this);
+
+    // Reference values from the PCG demo program.
+    var p: Pcg32 = undefined;
+    p.initStream(42, 54);
+    assert(p.get() == 0xa15c02b7);
+    assert(p.get() == 0x7b47f409);
+    assert(p.get() == 0xba1d3330);
+    assert(p.get() == 0x83d2f293);
+}
+
+fn testRangeUnsigned() {
+    @setFnTest(this);
+
+    var r: RandomGenerator(Pcg32) = undefined;
+    r.init(1);
+
+    var counts = []usize{0} ** 6;
+    {var i: usize = 0; while (i < 6000; i += 1) {
+        const val = r.rangeUnsigned(u8, 10, 16);
+        assert(val >= 10 && val < 16);
+        counts[val - 10] += 1;
+    }}
+    for (counts) |count| {
+        assert(count > 800 && count < 1200);
+    }
+
+    {var i: usize = 0; while (i < 1000; i += 1) {
+        const val = r.rangeUnsigned(u64, 1 << 40, (1 << 40) + 3);
+        assert(val >= 1 << 40 && val < (1 << 40) + 3);
+    }}
+}
+
+fn testFillBytes() {
+    @setFnTest(this);
+
+    var a: Rand = undefined;
+    var b: Rand = undefined;
+    a.init(7);
+    b.init(7);
+
+    // byte i of the output is the same no matter how the buffer is split
+    var whole: [21]u8 = undefined;
+    a.fillBytes(whole[0...]);
+    var parts: [24]u8 = undefined;
+    b.fillBytes(parts[0...16]);
+    b.fillBytes(parts[16...21]);
+    assert(mem.eql(u8, whole[0...21], parts[0...21]));
+
+    // and no matter how the buffer is aligned
+    var c: Rand = undefined;
+    c.init(7);
+    var odd: [24]u8 = undefined;
+    c.fillBytes(odd[3...24]);
+    assert(mem.eql(u8, whole[0...21], odd[3...24]));
+}
@@ -1,38 +1,327 @@
-const assert = @import("debug.zig").assert;
+const debug = @import("debug.zig");
+const assert = debug.assert;
 const mem = @import("mem.zig");
 const math = @import("math.zig");
 
 pub const Cmp = math.Cmp;
 
+/// Unstable in-place sort. This is a pattern-defeating quicksort: it picks
+/// median-of-three or ninther pivots, finishes small slices with insertion sort,
+/// and falls back to heapsort if too many partitions come out unbalanced, so
+/// it is O(n log n) in the worst case and linear for already sorted input.
 pub fn sort(comptime T: type, array: []T, comptime cmp: fn(a: &const T, b: &const T)->Cmp) {
-    if (array.len > 0) {
-        quicksort(T, array, 0, array.len - 1, cmp);
+    if (array.len < 2)
+        return;
+    // Number of unbalanced partitions allowed before switching to heapsort.
+    var bad_allowed: usize = 0;
+    {var n = array.len; while (n > 1; n >>= 1) {
+        bad_allowed += 1;
+    }}
+    pdqsort(T, array, 0, array.len, cmp, bad_allowed, true);
+}
+
+/// Stable sort, which keeps equal elements in their original order. This is a
+/// merge sort which needs a temporary buffer of half the array length from
+/// allocator.
+pub fn sortStable(comptime T: type, array: []T, allocator: &mem.Allocator,
+    comptime cmp: fn(a: &const T, b: &const T)->Cmp) -> %void
+{
+    if (array.len <= insertion_sort_threshold) {
+        insertionSort(T, array, 0, array.len, cmp);
+        return;
     }
+    const buffer = %return allocator.alloc(T, array.len / 2);
+    defer allocator.free(buffer);
+    mergeSort(T, array, buffer, cmp);
 }
 
-fn quicksort(comptime T: type, array: []T, left: usize, right: usize, comptime cmp: fn(a: &const T, b: &const T)->Cmp) {
-    var i = left;
-    var j = right;
-    const p = (i + j) / 2;
+/// Slices shorter than this are sorted with insertion sort.
+const insertion_sort_threshold = 24;
 
-    while (i <= j) {
-        while (cmp(array[i], array[p]) == Cmp.Less) {
-            i += 1;
+/// Slices longer than this get a ninther pivot instead of median-of-three.
+const ninther_threshold = 128;
+
+/// How many elements partialInsertionSort may move before giving up.
+const partial_insertion_sort_limit = 8;
+
+const PartitionResult = struct {
+    pivot_pos: usize,
+    already_partitioned: bool,
+};
+
+fn pdqsort(comptime T: type, items: []T, begin_in: usize, end: usize,
+    comptime cmp: fn(a: &const T, b: &const T)->Cmp, bad_allowed_in: usize, leftmost_in: bool)
+{
+    var begin = begin_in;
+    var bad_allowed = bad_allowed_in;
+    var leftmost = leftmost_in;
+
+    // Recurse into the left partition and loop on the right one.
+    while (true) {
+        const size = end - begin;
+        if (size < insertion_sort_threshold) {
+            insertionSort(T, items, begin, end, cmp);
+            return;
+        }
+
+        // Move the pivot to items[begin].
+        const half = begin + size / 2;
+        if (size > ninther_threshold) {
+            sort3(T, items, begin, half, end - 1, cmp);
+            sort3(T, items, begin + 1, half - 1, end - 2, cmp);
+            sort3(T, items, begin + 2, half + 1, end - 3, cmp);
+            sort3(T, items, half - 1, half, half + 1, cmp);
+            swap(T, items, begin, half);
+        } else {
+            sort3(T, items, half, begin, end - 1, cmp);
+        }
+
+        // items[begin - 1] is not greater than anything in this slice, so if it
+        // equals the pivot, then so do all elements which are not greater than
+        // the pivot. Put them on the left, where they need no more sorting.
+        if (!leftmost && !less(T, items[begin - 1], items[begin], cmp)) {
+            begin = partitionLeft(T, items, begin, end, cmp) + 1;
+            continue;
+        }
+
+        const result = partitionRight(T, items, begin, end, cmp);
+        const pivot_pos = result.pivot_pos;
+        const left_size = pivot_pos - begin;
+        const right_size = end - (pivot_pos + 1);
+
+        if (left_size < size / 8 || right_size < size / 8) {
+            bad_allowed -= 1;
+            if (bad_allowed == 0) {
+                heapSort(T, items[begin...end], cmp);
+                return;
+            }
+            // Shuffle some elements around to break up the pattern which
+            // caused the bad pivot.
+            if (left_size >= insertion_sort_threshold) {
+                swap(T, items, begin, begin + left_size / 4);
+                swap(T, items, pivot_pos - 1, pivot_pos - left_size / 4);
+            }
+            if (right_size >= insertion_sort_threshold) {
+                swap(T, items, pivot_pos + 1, pivot_pos + 1 + right_size / 4);
+                swap(T, items, end - 1, end - right_size / 4);
+            }
+        } else if (result.already_partitioned &&
+            partialInsertionSort(T, items, begin, pivot_pos, cmp) &&
+            partialInsertionSort(T, items, pivot_pos + 1, end, cmp))
+        {
+            // The input was (close to) sorted already.
+            return;
+        }
+
+        pdqsort(T, items, begin, pivot_pos, cmp, bad_allowed, leftmost);
+        begin = pivot_pos + 1;
+        leftmost = false;
+    }
+}
+
+/// Partitions items[begin...end] around the pivot items[begin]. Elements equal
+/// to the pivot end up on the right. Requires an element not less than the
+/// pivot at the end, which pivot selection guarantees.
+fn partitionRight(comptime T: type, items: []T, begin: usize, end: usize,
+    comptime cmp: fn(a: &const T, b: &const T)->Cmp) -> PartitionResult
+{
+    const pivot = items[begin];
+    var first = begin + 1;
+    var last = end - 1;
+
+    while (less(T, items[first], pivot, cmp)) {
+        first += 1;
+    }
+    // If no element was less than the pivot, guard the scan from the right.
+    if (first - 1 == begin) {
+        while (first < last && !less(T, items[last], pivot, cmp)) {
+            last -= 1;
+        }
+    } else {
+        while (!less(T, items[last], pivot, cmp)) {
+            last -= 1;
+        }
+    }
+
+    const already_partitioned = first >= last;
+    while (first < last) {
+        swap(T, items, first, last);
+        first += 1;
+        while (less(T, items[first], pivot, cmp)) {
+            first += 1;
+        }
+        last -= 1;
+        while (!less(T, items[last], pivot, cmp)) {
+            last -= 1;
+        }
+    }
+
+    const pivot_pos = first - 1;
+    items[begin] = items[pivot_pos];
+    items[pivot_pos] = pivot;
+    return PartitionResult {
+        .pivot_pos = pivot_pos,
+        .already_partitioned = already_partitioned,
+    };
+}
+
+/// Like partitionRight, but elements equal to the pivot end up on the left.
+/// Returns the final position of the pivot.
+fn partitionLeft(comptime T: type, items: []T, begin: usize, end: usize,
+    comptime cmp: fn(a: &const T, b: &const T)->Cmp) -> usize
+{
+    const pivot = items[begin];
+    var first = begin + 1;
+    var last = end - 1;
+
+    while (less(T, pivot, items[last], cmp)) {
+        last -= 1;
+    }
+    if (last + 1 == end) {
+        while (first < last && !less(T, pivot, items[first], cmp)) {
+            first += 1;
+        }
+    } else {
+        while (!less(T, pivot, items[first], cmp)) {
+            first += 1;
+        }
+    }
+
+    while (first < last) {
+        swap(T, items, first, last);
+        last -= 1;
+        while (less(T, pivot, items[last], cmp)) {
+            last -= 1;
+        }
+        first += 1;
+        while (!less(T, pivot, items[first], cmp)) {
+            first += 1;
+        }
+    }
+
+    items[begin] = items[last];
+    items[last] = pivot;
+    return last;
+}
+
+fn insertionSort(comptime T: type, items: []T, begin: usize, end: usize,
+    comptime cmp: fn(a: &const T, b: &const T)->Cmp)
+{
+    var i = begin + 1;
+    while (i < end; i += 1) {
+        const tmp = items[i];
+        var j = i;
+        while (j > begin && less(T, tmp, items[j - 1], cmp); j -= 1) {
+            items[j] = items[j - 1];
         }
-        while (cmp(array[j], array[p]) == Cmp.Greater) {
-            j -= 1;
+        items[j] = tmp;
+    }
+}
+
+/// Insertion sort which gives up once it has moved more than
+/// partial_insertion_sort_limit elements. Returns whether the slice is sorted.
+fn partialInsertionSort(comptime T: type, items: []T, begin: usize, end: usize,
+    comptime cmp: fn(a: &const T, b: &const T)->Cmp) -> bool
+{
+    var moved: usize = 0;
+    var i = begin + 1;
+    while (i < end; i += 1) {
+        if (!less(T, items[i], items[i - 1], cmp))
+            continue;
+        const tmp = items[i];
+        var j = i;
+        while (j > begin && less(T, tmp, items[j - 1], cmp); j -= 1) {
+            items[j] = items[j - 1];
         }
-        if (i <= j) {
-            const tmp = array[i];
-            array[i] = array[j];
-            array[j] = tmp;
+        items[j] = tmp;
+        moved += i - j;
+        if (moved > partial_insertion_sort_limit)
+            return false;
+    }
+    return true;
+}
+
+fn heapSort(comptime T: type, items: []T, comptime cmp: fn(a: &const T, b: &const T)->Cmp) {
+    var i = items.len / 2;
+    while (i > 0) {
+        i -= 1;
+        siftDown(T, items, i, items.len, cmp);
+    }
+    var end = items.len;
+    while (end > 1) {
+        end -= 1;
+        swap(T, items, 0, end);
+        siftDown(T, items, 0, end, cmp);
+    }
+}
+
+fn siftDown(comptime T: type, items: []T, root_in: usize, end: usize,
+    comptime cmp: fn(a: &const T, b: &const T)->Cmp)
+{
+    var root = root_in;
+    while (true) {
+        var child = 2 * root + 1;
+        if (child >= end)
+            return;
+        if (child + 1 < end && less(T, items[child], items[child + 1], cmp))
+            child += 1;
+        if (!less(T, items[root], items[child], cmp))
+            return;
+        swap(T, items, root, child);
+        root = child;
+    }
+}
+
+/// Sorts the three elements at indexes a, b and c.
+fn sort3(comptime T: type, items: []T, a: usize, b: usize, c: usize,
+    comptime cmp: fn(a: &const T, b: &const T)->Cmp)
+{
+    if (less(T, items[b], items[a], cmp)) swap(T, items, a, b);
+    if (less(T, items[c], items[b], cmp)) swap(T, items, b, c);
+    if (less(T, items[b], items[a], cmp)) swap(T, items, a, b);
+}
+
+/// Sorts items stably, using buffer to hold the left half while merging.
+fn mergeSort(comptime T: type, items: []T, buffer: []T, comptime cmp: fn(a: &const T, b: &const T)->Cmp) {
+    if (items.len <= insertion_sort_threshold) {
+        insertionSort(T, items, 0, items.len, cmp);
+        return;
+    }
+    const mid = items.len / 2;
+    mergeSort(T, items[0...mid], buffer, cmp);
+    mergeSort(T, items[mid...], buffer, cmp);
+    if (!less(T, items[mid], items[mid - 1], cmp))
+        return;
+
+    const left = buffer[0...mid];
+    mem.copy(T, left, items[0...mid]);
+    var i: usize = 0;
+    var j = mid;
+    var k: usize = 0;
+    // Taking from the left run on ties keeps the sort stable.
+    while (i < left.len && j < items.len; k += 1) {
+        if (less(T, items[j], left[i], cmp)) {
+            items[k] = items[j];
+            j += 1;
+        } else {
+            items[k] = left[i];
             i += 1;
-            if (j > 0) j -= 1;
         }
     }
+    while (i < left.len; i += 1) {
+        items[k] = left[i];
+        k += 1;
+    }
+}
 
-    if (left < j) quicksort(T, array, left, j, cmp);
-    if (i < right) quicksort(T, array, i, right, cmp);
+fn less(comptime T: type, a: &const T, b: &const T, comptime cmp: fn(a: &const T, b: &const T)->Cmp) -> bool {
+    cmp(a, b) == Cmp.Less
+}
+
+fn swap(comptime T: type, items: []T, a: usize, b: usize) {
+    const tmp = items[a];
+    items[a] = items[b];
+    items[b] = tmp;
 }
 
 pub fn i32asc(a: &const i32, b: &const i32) -> Cmp {
@@ -116,3 +405,60 @@ fn testSortDesc() {
         assert(mem.eql(i32, slice, case[1]));
     }
 }
+
+fn testSortPatterns() {
+    @setFnTest(this);
+
+    var array: [1000]i32 = undefined;
+    var pattern: usize = 0;
+    while (pattern < 5; pattern += 1) {
+        fillPattern(array[0...], pattern);
+        sort(i32, array[0...], i32asc);
+        for (array[1...]) |item, i| {
+            assert(array[i] <= item);
+        }
+    }
+}
+
+fn testSortStable() {
+    @setFnTest(this);
+
+    var keys: [300]i32 = undefined;
+    var pairs: [300]Pair = undefined;
+    var pattern: usize = 0;
+    while (pattern < 5; pattern += 1) {
+        fillPattern(keys[0...], pattern);
+        for (pairs) |*pair, i| {
+            *pair = Pair { .key = keys[i] & 7, .index = i };
+        }
+        %%sortStable(Pair, pairs[0...], &debug.global_allocator, pairKeyAsc);
+        for (pairs[1...]) |pair, i| {
+            const prev = pairs[i];
+            assert(prev.key < pair.key || (prev.key == pair.key && prev.index < pair.index));
+        }
+    }
+}
+
+const Pair = struct {
+    key: i32,
+    index: usize,
+};
+
+fn pairKeyAsc(a: &const Pair, b: &const Pair) -> Cmp {
+    i32asc(a.key, b.key)
+}
+
+/// Fills array with random, sorted, reversed, few unique or sawtooth values.
+fn fillPattern(array: []i32, pattern: usize) {
+    var seed: u32 = 0x12345678;
+    for (array) |*item, i| {
+        seed = seed *% 1103515245 +% 12345;
+        *item = switch (pattern) {
+            0 => i32(seed >> 1),
+            1 => i32(i),
+            2 => -i32(i),
+            3 => i32((seed >> 16) % 4),
+            else => i32(i % 50),
+        };
+    }
+}
@@ -0,0 +1,720 @@
+const linux = @import("linux.zig");
+const errno = @import("errno.zig");
+const debug = @import("debug.zig");
+const assert = debug.assert;
+const mem = @import("mem.zig");
+const atomic = @import("atomic.zig");
+const Allocator = mem.Allocator;
+
+error Unexpected;
+error NoMem;
+error ThreadQuotaExceeded;
+
+/// The stack size of threads started with Thread.spawn. Only the pages the
+/// stack grows into take up memory.
+pub const default_stack_size = 8 * 1024 * 1024;
+
+const page_size = 4096;
+
+// How long lock spins before it puts the thread to sleep.
+const spin_count = 100;
+
+/// A thread started with spawn, or the main thread. The thread pointer of
+/// every thread (fs on x86_64, gs on i386) points at its Thread, which is
+/// how current finds it. This takes the place of the thread control block
+/// of libc, so threads do not work in programs which link libc.
+pub const Thread = struct {
+    // where the thread pointer points, like the start of a thread control block
+    self: &Thread,
+    // set by the kernel when the thread starts, and cleared when it exits
+    tid: i32,
+    func: fn(context: ?&mem.Context),
+    /// What was passed to spawn.
+    context: ?&mem.Context,
+    // the stack and this struct, empty for the main thread
+    mapping: []u8,
+    // the thread local storage segment on i386
+    tls_desc: TlsDesc,
+
+    /// Runs func(context) on a new thread. Call join to wait for it to return
+    /// and free it.
+    pub fn spawn(func: fn(context: ?&mem.Context), context: ?&mem.Context) -> %&Thread {
+        // a guard page below the stack, and this struct above it
+        const mapping_len = page_size + default_stack_size + page_size;
+        const mmap_ret = linux.mmap(null, mapping_len, linux.MMAP_PROT_READ | linux.MMAP_PROT_WRITE,
+            linux.MMAP_MAP_PRIVATE | linux.MMAP_MAP_ANON, -1, 0);
+        const mmap_err = linux.getErrno(mmap_ret);
+        if (mmap_err > 0) {
+            return switch (mmap_err) {
+                errno.ENOMEM => error.NoMem,
+                else => error.Unexpected,
+            }
+        }
+        const mapping = (&u8)(mmap_ret)[0...mapping_len];
+        %defer {
+            _ = linux.munmap(mapping.ptr, mapping.len);
+        }
+        const protect_err = linux.getErrno(linux.mprotect(mapping.ptr, page_size, linux.MMAP_PROT_NONE));
+        if (protect_err > 0) {
+            return switch (protect_err) {
+                errno.ENOMEM => error.NoMem,
+                else => error.Unexpected,
+            }
+        }
+
+        const thread = (&Thread)(&mapping[mapping_len - page_size]);
+        thread.self = thread;
+        thread.tid = 0;
+        thread.func = func;
+        thread.context = context;
+        thread.mapping = mapping;
+        const tls = switch (@compileVar("arch")) {
+            Arch.x86_64 => usize(thread),
+            Arch.i386 => {
+                thread.tls_desc = tlsDesc(tls_entry, thread);
+                usize(&thread.tls_desc)
+            },
+            else => @compileError("unsupported arch"),
+        };
+
+        const flags = linux.CLONE_VM | linux.CLONE_FS | linux.CLONE_FILES | linux.CLONE_SIGHAND |
+            linux.CLONE_THREAD | linux.CLONE_SYSVSEM | linux.CLONE_SETTLS |
+            linux.CLONE_PARENT_SETTID | linux.CLONE_CHILD_CLEARTID;
+        const clone_ret = linux.clone(threadStart, usize(thread), flags, usize(thread),
+            &thread.tid, tls, &thread.tid);
+        const clone_err = linux.getErrno(clone_ret);
+        if (clone_err > 0) {
+            return switch (clone_err) {
+                errno.EAGAIN => error.ThreadQuotaExceeded,
+                errno.ENOMEM => error.NoMem,
+                else => error.Unexpected,
+            }
+        }
+        return thread;
+    }
+
+    /// Waits for the thread to return, then frees it.
+    pub fn join(thread: &Thread) {
+        while (true) {
+            const tid = atomic.load(i32, &thread.tid);
+            if (tid == 0) break;
+            // the kernel wakes the cleared tid as a shared futex
+            _ = linux.futex(&thread.tid, linux.FUTEX_WAIT, tid, null);
+        }
+        _ = linux.munmap(thread.mapping.ptr, thread.mapping.len);
+    }
+
+    /// Returns the Thread of the calling thread.
+    pub fn current() -> &Thread {
+        return switch (@compileVar("arch")) {
+            Arch.x86_64 => asm ("mov %%fs:0, %[thread]" : [thread] "=r" (-> &Thread)),
+            Arch.i386 => asm ("mov %%gs:0, %[thread]" : [thread] "=r" (-> &Thread)),
+            else => @compileError("unsupported arch"),
+        };
+    }
+};
+
+const TlsDesc = switch (@compileVar("arch")) {
+    Arch.i386 => linux.user_desc,
+    else => void,
+};
+
+var main_thread: Thread = undefined;
+// the global descriptor table entry which holds the gs segment on i386
+var tls_entry: u32 = undefined;
+
+/// Points the thread pointer of the main thread at a Thread. Called by the
+/// startup code before main.
+pub fn initMainThread() {
+    main_thread.self = &main_thread;
+    main_thread.tid = linux.gettid();
+    main_thread.context = null;
+    main_thread.mapping = []u8{};
+    switch (@compileVar("arch")) {
+        Arch.x86_64 => {
+            _ = linux.arch_prctl(linux.ARCH_SET_FS, usize(&main_thread));
+        },
+        Arch.i386 => {
+            main_thread.tls_desc = tlsDesc(@maxValue(u32), &main_thread);
+            _ = linux.set_thread_area(&main_thread.tls_desc);
+            tls_entry = main_thread.tls_desc.entry_number;
+            loadTlsSegment();
+        },
+        else => @compileError("unsupported arch"),
+    }
+}
+
+fn tlsDesc(entry_number: u32, thread: &Thread) -> linux.user_desc {
+    linux.user_desc {
+        .entry_number = entry_number,
+        .base_addr = u32(usize(thread)),
+        .limit = 0xfffff,
+        .flags = linux.USER_DESC_SEG_32BIT | linux.USER_DESC_LIMIT_IN_PAGES | linux.USER_DESC_USEABLE,
+    }
+}
+
+// Every thread shares the entry, and the kernel switches what it holds.
+fn loadTlsSegment() {
+    const selector = u16(tls_entry * 8 + 3);
+    asm volatile ("movw %[selector], %%gs" : : [selector] "r" (selector));
+}
+
+export fn threadStart(arg: usize) -> u8 {
+    @setFnVisible(this, false);
+
+    switch (@compileVar("arch")) {
+        Arch.i386 => loadTlsSegment(),
+        else => {},
+    }
+    const thread = (&Thread)(arg);
+    thread.func(thread.context);
+    return 0;
+}
+
+/// Returns how many CPUs the calling thread may run on.
+pub fn cpuCount() -> %usize {
+    var mask: [128]u8 = undefined;
+    const affinity_ret = linux.sched_getaffinity(0, mask[0...]);
+    if (linux.getErrno(affinity_ret) > 0) return error.Unexpected;
+    var count: usize = 0;
+    for (mask[0...affinity_ret]) |byte| {
+        var bits = byte;
+        while (bits != 0) {
+            bits &= bits - 1;
+            count += 1;
+        }
+    }
+    return count;
+}
+
+fn spinPause() {
+    asm volatile ("pause" ::: "memory");
+}
+
+/// A lock which puts threads to sleep while they wait for it.
+/// Use `init` to initialize this state.
+pub const Mutex = struct {
+    // 0 when unlocked, 1 when locked, and 2 when locked with threads
+    // perhaps waiting
+    state: i32,
+
+    pub fn init(m: &Mutex) {
+        m.state = 0;
+    }
+
+    pub fn lock(m: &Mutex) {
+        if (@cmpxchg(&m.state, 0, 1, AtomicOrder.Acquire, AtomicOrder.Monotonic)) return;
+        // locks are usually held briefly
+        {var i: usize = 0; while (i < spin_count; i += 1) {
+            spinPause();
+            if (atomic.load(i32, &m.state) == 0 &&
+                @cmpxchg(&m.state, 0, 1, AtomicOrder.Acquire, AtomicOrder.Monotonic))
+            {
+                return;
+            }
+        }}
+        m.lockContended();
+    }
+
+    /// Returns whether the lock was taken, without waiting.
+    pub fn tryLock(m: &Mutex) -> bool {
+        return @cmpxchg(&m.state, 0, 1, AtomicOrder.Acquire, AtomicOrder.Monotonic);
+    }
+
+    pub fn unlock(m: &Mutex) {
+        if (atomic.swap(i32, &m.state, 0) == 2) {
+            _ = linux.futex_wake(&m.state, 1);
+        }
+    }
+
+    // Other threads may be waiting too, so this leaves the lock marked as
+    // such, which makes unlock wake one of them.
+    fn lockContended(m: &Mutex) {
+        while (atomic.swap(i32, &m.state, 2) != 0) {
+            _ = linux.futex_wait(&m.state, 2, null);
+        }
+    }
+};
+
+/// Lets threads sleep until another thread tells them that something
+/// changed. Use `init` to initialize this state.
+pub const Condition = struct {
+    seq: i32,
+
+    pub fn init(cond: &Condition) {
+        cond.seq = 0;
+    }
+
+    /// Unlocks mutex, sleeps until signal or broadcast is called, and locks
+    /// mutex again. It can also return without either being called, so wait
+    /// in a loop which checks what is waited for.
+    pub fn wait(cond: &Condition, mutex: &Mutex) {
+        const seq = atomic.load(i32, &cond.seq);
+        mutex.unlock();
+        _ = linux.futex_wait(&cond.seq, seq, null);
+        mutex.lockContended();
+    }
+
+    /// Wakes one waiting thread.
+    pub fn signal(cond: &Condition) {
+        _ = atomic.fetchAdd(i32, &cond.seq, 1);
+        _ = linux.futex_wake(&cond.seq, 1);
+    }
+
+    /// Wakes all waiting threads.
+    pub fn broadcast(cond: &Condition) {
+        _ = atomic.fetchAdd(i32, &cond.seq, 1);
+        _ = linux.futex_wake(&cond.seq, @maxValue(i32));
+    }
+};
+
+/// A counter which threads wait on to become positive.
+/// Use `init` to initialize this state.
+pub const Semaphore = struct {
+    count: i32,
+    waiters: i32,
+
+    pub fn init(sem: &Semaphore, count: i32) {
+        sem.count = count;
+        sem.waiters = 0;
+    }
+
+    /// Waits until the count is positive, and decrements it.
+    pub fn wait(sem: &Semaphore) {
+        while (!sem.tryWait()) {
+            _ = atomic.fetchAdd(i32, &sem.waiters, 1);
+            _ = linux.futex_wait(&sem.count, 0, null);
+            _ = atomic.fetchSub(i32, &sem.waiters, 1);
+        }
+    }
+
+    /// Decrements the count if it is positive, without waiting. Returns
+    /// whether it did.
+    pub fn tryWait(sem: &Semaphore) -> bool {
+        while (true) {
+            const count = atomic.load(i32, &sem.count);
+            if (count <= 0) return false;
+            if (@cmpxchg(&sem.count, count, count - 1, AtomicOrder.Acquire, AtomicOrder.Monotonic)) return true;
+        }
+    }
+
+    /// Increments the count, and wakes a waiting thread.
+    pub fn post(sem: &Semaphore) {
+        _ = atomic.fetchAdd(i32, &sem.count, 1);
+        if (atomic.load(i32, &sem.waiters) > 0) {
+            _ = linux.futex_wake(&sem.count, 1);
+        }
+    }
+};
+
+/// Work for a ThreadPool. It must stay alive until callback returns.
+pub const Task = struct {
+    callback: fn(task: &Task),
+    context: ?&mem.Context,
+    // the next task in the shared queue of the pool
+    next: ?&Task,
+};
+
+// How many tasks each worker keeps to itself. Tasks beyond that go to the
+// shared queue.
+const deque_size = 256;
+
+// A Chase-Lev work stealing deque of fixed size. The worker which owns it
+// pushes and pops tasks at the bottom, and other threads steal from the top.
+const Deque = struct {
+    top: isize,
+    bottom: isize,
+    tasks: [deque_size]&Task,
+
+    fn init(d: &Deque) {
+        d.top = 0;
+        d.bottom = 0;
+    }
+
+    // Only for the owner. Returns false if the deque is full.
+    fn push(d: &Deque, task: &Task) -> bool {
+        const b = d.bottom;
+        const t = atomic.load(isize, &d.top);
+        if (b - t >= deque_size) return false;
+        d.tasks[usize(b) % deque_size] = task;
+        atomic.store(isize, &d.bottom, b + 1);
+        return true;
+    }
+
+    // Only for the owner. Takes the most recently pushed task.
+    fn pop(d: &Deque) -> ?&Task {
+        const b = d.bottom - 1;
+        d.bottom = b;
+        @fence(AtomicOrder.SeqCst);
+        const t = d.top;
+        if (t > b) {
+            d.bottom = b + 1;
+            return null;
+        }
+        const task = d.tasks[usize(b) % deque_size];
+        if (t == b) {
+            // the last task, which a thief may be taking at the same time
+            const won = @cmpxchg(&d.top, t, t + 1, AtomicOrder.SeqCst, AtomicOrder.SeqCst);
+            d.bottom = b + 1;
+            if (!won) return null;
+        }
+        return task;
+    }
+
+    // Takes the least recently pushed task. Returns null only if the deque
+    // was empty.
+    fn steal(d: &Deque) -> ?&Task {
+        while (true) {
+            const t = atomic.load(isize, &d.top);
+            @fence(AtomicOrder.SeqCst);
+            const b = atomic.load(isize, &d.bottom);
+            if (t >= b) return null;
+            const task = d.tasks[usize(t) % deque_size];
+            if (@cmpxchg(&d.top, t, t + 1, AtomicOrder.SeqCst, AtomicOrder.SeqCst)) return task;
+        }
+    }
+};
+
+const Worker = struct {
+    pool: &ThreadPool,
+    thread: &Thread,
+    deque: Deque,
+    // xorshift state for picking whom to steal from
+    rand_state: u32,
+
+    fn findTask(worker: &Worker) -> ?&Task {
+        if (const task ?= worker.deque.pop()) return task;
+        return worker.pool.findTask(worker);
+    }
+
+    fn nextRandom(worker: &Worker) -> u32 {
+        var x = worker.rand_state;
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        worker.rand_state = x;
+        return x;
+    }
+};
+
+/// Runs tasks on a fixed number of threads. Each thread has a deque of its
+/// own tasks: tasks scheduled from a thread of the pool go to its deque, and
+/// threads which run out of tasks steal from the others. Tasks scheduled from
+/// other threads go to a shared queue.
+/// Use `init` to initialize this state.
+pub const ThreadPool = struct {
+    allocator: &Allocator,
+    workers: []Worker,
+
+    // the shared queue
+    lock: Mutex,
+    queue_head: ?&Task,
+    queue_tail: ?&Task,
+    queue_len: usize,
+
+    // incremented whenever there are new tasks, idle threads sleep on it
+    epoch: i32,
+    sleeping: i32,
+    stopping: bool,
+
+    /// Starts thread_count threads. Call deinit to clean up.
+    pub fn init(pool: &ThreadPool, allocator: &Allocator, thread_count: usize) -> %void {
+        assert(thread_count > 0);
+        pool.allocator = allocator;
+        pool.workers = %return allocator.alloc(Worker, thread_count);
+        %defer allocator.free(pool.workers);
+        pool.lock.init();
+        pool.queue_head = null;
+        pool.queue_tail = null;
+        pool.queue_len = 0;
+        pool.epoch = 0;
+        pool.sleeping = 0;
+        pool.stopping = false;
+
+        for (pool.workers) |*worker, i| {
+            worker.pool = pool;
+            worker.deque.init();
+            worker.rand_state = u32(i) + 1;
+        }
+        for (pool.workers) |*worker, i| {
+            worker.thread = Thread.spawn(workerMain, (&mem.Context)(worker)) %% |err| {
+                pool.stop(i);
+                return err;
+            };
+        }
+    }
+
+    /// Waits for all scheduled tasks to finish, and stops the threads.
+    pub fn deinit(pool: &ThreadPool) {
+        pool.stop(pool.workers.len);
+        pool.allocator.free(pool.workers);
+    }
+
+    /// Queues task to be run by one of the threads.
+    pub fn schedule(pool: &ThreadPool, task: &Task) {
+        if (const worker ?= pool.currentWorker()) {
+            if (worker.deque.push(task)) {
+                pool.notify(1);
+                return;
+            }
+        }
+        pool.enqueue(task, task, 1);
+    }
+
+    /// Calls func on consecutive parts of items, in parallel on the threads
+    /// of the pool, and returns once all calls have returned. The calling
+    /// thread takes part in the work, so this may be called from tasks too.
+    pub fn parallelFor(pool: &ThreadPool, comptime T: type, items: []T, func: fn(items: []T)) {
+        const Part = ParallelForPart(T);
+        // a few parts for each thread, so threads which finish early can
+        // steal from those which fall behind
+        var part_count = (pool.workers.len + 1) * 4;
+        if (part_count > max_parts) part_count = max_parts;
+        if (part_count > items.len) part_count = items.len;
+        if (part_count == 0) return;
+
+        var parts: [max_parts]Part = undefined;
+        var remaining = i32(part_count);
+        for (parts[0...part_count]) |*part, i| {
+            const start = items.len * i / part_count;
+            const end = items.len * (i + 1) / part_count;
+            *part = Part {
+                .task = Task {
+                    .callback = Part.run,
+                    .context = (&mem.Context)(part),
+                    .next = null,
+                },
+                .items = items[start...end],
+                .func = func,
+                .remaining = &remaining,
+            };
+        }
+
+        // the first part is run right here
+        const worker = pool.currentWorker();
+        {var i: usize = 1; while (i < part_count; i += 1) {
+            const task = &parts[i].task;
+            if (const w ?= worker) {
+                if (w.deque.push(task)) continue;
+            }
+            // the rest goes to the shared queue in one go
+            {var j: usize = i; while (j + 1 < part_count; j += 1) {
+                parts[j].task.next = &parts[j + 1].task;
+            }}
+            pool.enqueue(task, &parts[part_count - 1].task, part_count - i);
+            break;
+        }}
+        pool.notify(part_count - 1);
+        Part.run(&parts[0].task);
+
+        while (true) {
+            const left = atomic.load(i32, &remaining);
+            if (left == 0) break;
+            const next_task = if (const w ?= worker) w.findTask() else pool.findTask(null);
+            if (const task ?= next_task) {
+                task.callback(task);
+            } else {
+                _ = linux.futex_wait(&remaining, left, null);
+            }
+        }
+    }
+
+    // The Worker of the calling thread, if it is one of the pool.
+    fn currentWorker(pool: &ThreadPool) -> ?&Worker {
+        const context = Thread.current().context ?? return null;
+        const first = usize(&pool.workers[0]);
+        const addr = usize(context);
+        if (addr < first || addr >= first + pool.workers.len * @sizeOf(Worker)) return null;
+        return (&Worker)(context);
+    }
+
+    // Appends the tasks from first to last, which are linked through next.
+    fn enqueue(pool: &ThreadPool, first: &Task, last: &Task, count: usize) {
+        last.next = null;
+        pool.lock.lock();
+        if (const tail ?= pool.queue_tail) {
+            tail.next = first;
+        } else {
+            pool.queue_head = first;
+        }
+        pool.queue_tail = last;
+        atomic.store(usize, &pool.queue_len, pool.queue_len + count);
+        pool.lock.unlock();
+        pool.notify(count);
+    }
+
+    fn dequeue(pool: &ThreadPool) -> ?&Task {
+        if (atomic.load(usize, &pool.queue_len) == 0) return null;
+        pool.lock.lock();
+        defer pool.lock.unlock();
+        const task = pool.queue_head ?? return null;
+        pool.queue_head = task.next;
+        atomic.store(usize, &pool.queue_len, pool.queue_len - 1);
+        if (pool.queue_len == 0) pool.queue_tail = null;
+        return task;
+    }
+
+    // A task from the shared queue or one stolen from a worker other than
+    // thief, which is null for threads outside the pool.
+    fn findTask(pool: &ThreadPool, thief: ?&Worker) -> ?&Task {
+        if (const task ?= pool.dequeue()) return task;
+        var victim: usize = 0;
+        if (const w ?= thief) {
+            victim = w.nextRandom() % pool.workers.len;
+        }
+        {var i: usize = 0; while (i < pool.workers.len; i += 1) {
+            const worker = &pool.workers[victim];
+            victim += 1;
+            if (victim == pool.workers.len) victim = 0;
+            if (const w ?= thief) {
+                if (usize(worker) == usize(w)) continue;
+            }
+            if (const task ?= worker.deque.steal()) return task;
+        }}
+        return null;
+    }
+
+    // Wakes up to count sleeping threads.
+    fn notify(pool: &ThreadPool, count: usize) {
+        _ = atomic.fetchAdd(i32, &pool.epoch, 1);
+        if (atomic.load(i32, &pool.sleeping) > 0) {
+            const wake_count = if (count < pool.workers.len) count else pool.workers.len;
+            _ = linux.futex_wake(&pool.epoch, i32(wake_count));
+        }
+    }
+
+    // Stops and joins the first thread_count threads.
+    fn stop(pool: &ThreadPool, thread_count: usize) {
+        atomic.store(bool, &pool.stopping, true);
+        _ = atomic.fetchAdd(i32, &pool.epoch, 1);
+        _ = linux.futex_wake(&pool.epoch, @maxValue(i32));
+        for (pool.workers[0...thread_count]) |*worker| {
+            worker.thread.join();
+        }
+    }
+};
+
+const max_parts = 256;
+
+fn ParallelForPart(comptime T: type) -> type {
+    struct {
+        task: Task,
+        items: []T,
+        func: fn(items: []T),
+        remaining: &i32,
+
+        const Self = this;
+
+        fn run(task: &Task) {
+            const part = (&Self)(task.context ?? @unreachable());
+            part.func(part.items);
+            // the parts are gone once remaining reaches 0
+            const remaining = part.remaining;
+            if (atomic.fetchSub(i32, remaining, 1) == 1) {
+                _ = linux.futex_wake(remaining, 1);
+            }
+        }
+    }
+}
+
+fn workerMain(context: ?&mem.Context) {
+    const worker = (&Worker)(context ?? @unreachable());
+    const pool = worker.pool;
+    while (true) {
+        if (const task ?= worker.findTask()) {
+            task.callback(task);
+            continue;
+        }
+
+        const epoch = atomic.load(i32, &pool.epoch);
+        _ = atomic.fetchAdd(i32, &pool.sleeping, 1);
+        // a task may have been scheduled before epoch was read
+        if (const task ?= worker.findTask()) {
+            _ = atomic.fetchSub(i32, &pool.sleeping, 1);
+            task.callback(task);
+            continue;
+        }
+        if (atomic.load(bool, &pool.stopping)) {
+            _ = atomic.fetchSub(i32, &pool.sleeping, 1);
+            return;
+        }
+        _ = linux.futex_wait(&pool.epoch, epoch, null);
+        _ = atomic.fetchSub(i32, &pool.sleeping, 1);
+    }
+}
+
+fn testSpawnJoin() {
+    @setFnTest(this);
+
+    var shared = Counter {
+        .mutex = undefined,
+        .value = 0,
+    };
+    shared.mutex.init();
+    var threads: [4]&Thread = undefined;
+    for (threads) |*thread| {
+        *thread = %%Thread.spawn(countUp, (&mem.Context)(&shared));
+    }
+    for (threads) |thread| {
+        thread.join();
+    }
+    assert(shared.value == threads.len * 10000);
+    assert(Thread.current().context == null);
+}
+
+const Counter = struct {
+    mutex: Mutex,
+    value: usize,
+};
+
+fn countUp(context: ?&mem.Context) {
+    const shared = (&Counter)(context ?? @unreachable());
+    const thread_context = Thread.current().context ?? @unreachable();
+    assert(usize(thread_context) == usize(shared));
+    {var i: usize = 0; while (i < 10000; i += 1) {
+        shared.mutex.lock();
+        shared.value += 1;
+        shared.mutex.unlock();
+    }}
+}
+
+fn testSemaphore() {
+    @setFnTest(this);
+
+    var sem: Semaphore = undefined;
+    sem.init(0);
+    const thread = %%Thread.spawn(postTwice, (&mem.Context)(&sem));
+    sem.wait();
+    sem.wait();
+    assert(!sem.tryWait());
+    thread.join();
+}
+
+fn postTwice(context: ?&mem.Context) {
+    const sem = (&Semaphore)(context ?? @unreachable());
+    sem.post();
+    sem.post();
+}
+
+fn testParallelFor() {
+    @setFnTest(this);
+
+    var pool: ThreadPool = undefined;
+    %%pool.init(&debug.global_allocator, 4);
+    defer pool.deinit();
+
+    var items: [10000]u32 = undefined;
+    for (items) |*item, i| {
+        *item = u32(i);
+    }
+    pool.parallelFor(u32, items[0...], double);
+    for (items) |item, i| {
+        assert(item == u32(i) * 2);
+    }
+}
+
+fn double(items: []u32) {
+    for (items) |*item| {
+        *item *= 2;
+    }
+}
@@ -52,6 +52,76 @@ fn countTrailingZeroes() {
     assert(@ctz(u8(0b00000000)) == 8);
 }
 
+fn byteSwap() {
+    @setFnTest(this);
+
+    testByteSwap();
+    comptime testByteSwap();
+}
+fn testByteSwap() {
+    assert(@bswap(u8(0x12)) == 0x12);
+    assert(@bswap(u16(0x1234)) == 0x3412);
+    var x: u32 = 0x12345678;
+    assert(@bswap(x) == 0x78563412);
+    var y: u64 = 0x0123456789abcdef;
+    assert(@bswap(y) == 0xefcdab8967452301);
+    var z: i16 = 0x12ff;
+    assert(@bswap(z) == -0xee);
+    var w: i32 = -2;
+    assert(@bswap(w) == -0x1000001);
+}
+
+const u128 = @intType(false, 128);
+
+fn byteSwapWide() {
+    @setFnTest(this);
+
+    const x = @bswap(u128(0x0102));
+    assert(u16(x >> 112) == 0x0201);
+}
+
+const u24 = @intType(false, 24);
+const i2 = @intType(true, 2);
+
+fn bitManipulation() {
+    @setFnTest(this);
+
+    testBitManipulation();
+    comptime testBitManipulation();
+}
+fn testBitManipulation() {
+    var a: u8 = 0b10110010;
+    assert(@popCount(a) == 4);
+    assert(@bitReverse(a) == 0b01001101);
+    assert(@rotl(a, 1) == 0b01100101);
+    assert(@rotr(a, 1) == 0b01011001);
+    assert(@rotl(a, 0) == a);
+    assert(@rotl(a, 9) == 0b01100101);
+
+    var b: u64 = 0x8000000000000001;
+    assert(@popCount(b) == 2);
+    assert(@popCount(u64(0)) == 0);
+    assert(@popCount(@maxValue(u64)) == 64);
+    assert(@bitReverse(b) == b);
+    assert(@rotl(b, 4) == 0x18);
+    assert(@rotr(b, 4) == 0x1800000000000000);
+    var r: u64 = 60;
+    assert(@rotl(b, r) == @rotr(b, 4));
+
+    var c: u24 = 0x000001;
+    assert(@rotr(c, 1) == 0x800000);
+    assert(@rotl(c, 25) == 0x000002);
+
+    var d: i16 = -0x8000;
+    assert(@popCount(d) == 1);
+    assert(@bitReverse(d) == 1);
+    assert(@rotl(d, 1) == 1);
+    assert(@bitReverse(i16(1)) == -0x8000);
+
+    var e: i2 = -1;
+    assert(@popCount(e) == 2);
+}
+
 fn modifyOperators() {
     @setFnTest(this);
 
@@ -216,3 +286,24 @@ fn testFloatEqualityImpl(x: f64, y: f64) {
     const y2 = x + 1.0;
     assert(y == y2);
 }
+
+fn strictFloatMathByDefault() {
+    @setFnTest(this);
+
+    testFloatAssociativity(1.0e-20, 1.0);
+}
+
+fn testFloatAssociativity(small: f64, big: f64) {
+    assert((small + big) - big == 0.0);
+}
+
+fn setFastMathOnFunction() {
+    @setFnTest(this);
+
+    assert(fastMathMulAdd(1.5, 2.0, 1.0) == 4.0);
+}
+
+fn fastMathMulAdd(a: f64, b: f64, c: f64) -> f64 {
+    @setFastMath(this, true);
+    return a * b + c;
+}
@@ -0,0 +1,89 @@
+const assert = @import("std").debug.assert;
+
+fn vectorArithmetic() {
+    @setFnTest(this);
+
+    var a = @Vector(4, i32)([]i32{1, 2, 3, @maxValue(i32)});
+    var b = @Vector(4, i32)([]i32{10, 20, 30, 1});
+    const sum = [4]i32((a +% b) *% @splat(@Vector(4, i32), 2));
+    assert(sum[0] == 22 && sum[1] == 44 && sum[2] == 66 && sum[3] == 0);
+    const bits = [4]i32((a & b) | (a ^ b));
+    assert(bits[0] == 11 && bits[1] == 22 && bits[2] == 31);
+
+    var x = @Vector(2, f64)([]f64{1.5, -4.0});
+    var y = @Vector(2, f64)([]f64{0.5, 2.0});
+    const quotient = [2]f64((x - y) / y);
+    assert(quotient[0] == 2.0 && quotient[1] == -3.0);
+}
+
+fn vectorComparison() {
+    @setFnTest(this);
+
+    var a = @Vector(4, u8)([]u8{1, 5, 3, 7});
+    var b = @splat(@Vector(4, u8), 4);
+    const less = [4]bool(a < b);
+    assert(less[0] && !less[1] && less[2] && !less[3]);
+    const max = [4]u8(@select(a > b, a, b));
+    assert(max[0] == 4 && max[1] == 5 && max[2] == 4 && max[3] == 7);
+}
+
+fn boolVectorToArray() {
+    @setFnTest(this);
+
+    var flags = []bool{true, false, false, true, true};
+    const not_flags = [5]bool(@Vector(5, bool)(flags) == @splat(@Vector(5, bool), false));
+    assert(!not_flags[0] && not_flags[1] && not_flags[2] && !not_flags[3] && !not_flags[4]);
+
+    const comptime_flags = comptime boolArrayRoundTrip();
+    assert(comptime_flags[0] && !comptime_flags[1] && comptime_flags[2]);
+}
+
+fn boolArrayRoundTrip() -> [3]bool {
+    const v = @Vector(3, bool)([]bool{false, true, false});
+    return [3]bool(v != @splat(@Vector(3, bool), true));
+}
+
+fn vectorShuffle() {
+    @setFnTest(this);
+
+    var a = @Vector(4, u32)([]u32{0, 1, 2, 3});
+    var b = @Vector(4, u32)([]u32{4, 5, 6, 7});
+    const mixed = [3]u32(@shuffle(a, b, []u32{7, 0, 5}));
+    assert(mixed[0] == 7 && mixed[1] == 0 && mixed[2] == 5);
+}
+
+fn vectorReduce() {
+    @setFnTest(this);
+
+    var a = @Vector(6, i16)([]i16{3, -1, 4, -1, 5, -9});
+    assert(@reduce(ReduceOp.Add, a) == 1);
+    assert(@reduce(ReduceOp.Min, a) == -9);
+    assert(@reduce(ReduceOp.Max, a) == 5);
+
+    var m = @Vector(4, u8)([]u8{0x81, 0x42, 0x24, 0x18});
+    assert(@reduce(ReduceOp.Or, m) == 0xff);
+    assert(@reduce(ReduceOp.Xor, m) == 0xff);
+    assert(@reduce(ReduceOp.And, m) == 0);
+
+    var flags = @Vector(4, bool)([]bool{true, false, true, true});
+    assert(!@reduce(ReduceOp.And, flags));
+    assert(@reduce(ReduceOp.Or, flags));
+
+    var f = @Vector(4, f32)([]f32{1.0, 2.0, 3.0, 4.0});
+    assert(@reduce(ReduceOp.Mul, f) == 24.0);
+}
+
+fn comptimeVectors() {
+    @setFnTest(this);
+
+    const picked = comptime shuffleAndSelect();
+    assert(picked[0] == 17 && picked[1] == 3 && picked[2] == 101);
+}
+
+fn shuffleAndSelect() -> [3]u32 {
+    const a = @Vector(4, u32)([]u32{1, 2, 3, 4});
+    const b = @shuffle(a, @splat(@Vector(4, u32), 10), []u8{3, 2, 4});
+    const c = b *% b +% @splat(@Vector(3, u32), 1);
+    assert(@reduce(ReduceOp.Add, c) == 17 + 10 + 101);
+    return [3]u32(@select(c > @splat(@Vector(3, u32), 12), c, b));
+}
@@ -1704,6 +1704,18 @@ fn foo() {
     while (i < 10; i += 1) { }
 }
     )SOURCE", 1, ".tmp_source.zig:3:5: error: unable to infer variable type");
+
+    add_compile_fail_case("non wrapping arithmetic on integer vectors", R"SOURCE(
+fn f(a: @Vector(4, i32), b: @Vector(4, i32)) -> @Vector(4, i32) {
+    a + b
+}
+    )SOURCE", 1, ".tmp_source.zig:3:7: error: arithmetic on '@Vector(4, i32)' must use a wrapping operator: '+%', '-%' or '*%'");
+
+    add_compile_fail_case("shuffle mask index out of range", R"SOURCE(
+fn f(a: @Vector(4, i32)) -> @Vector(2, i32) {
+    @shuffle(a, a, []i32{0, 8})
+}
+    )SOURCE", 1, ".tmp_source.zig:3:25: error: shuffle mask index 1 selects element 8 of two vectors of 4");
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -1724,6 +1736,26 @@ fn bar(a: []const i32) -> i32 {
 fn baz(a: i32) { }
     )SOURCE");
 
+    add_debug_safety_case("out of bounds slice access in loop over other slice", R"SOURCE(
+pub fn panic(message: []const u8) -> unreachable {
+    @breakpoint();
+    while (true) {}
+}
+pub fn main(args: [][]u8) -> %void {
+    const a = []i32{1, 2, 3, 4};
+    const b = []i32{1, 2};
+    baz(bar(a, b));
+}
+fn bar(a: []const i32, b: []const i32) -> i32 {
+    var sum: i32 = 0;
+    for (a) |x, i| {
+        sum += x * b[i];
+    }
+    return sum;
+}
+fn baz(a: i32) { }
+    )SOURCE");
+
     add_debug_safety_case("integer addition overflow", R"SOURCE(
 pub fn panic(message: []const u8) -> unreachable {
     @breakpoint();